@@ -0,0 +1,77 @@
+#include "barramento_metricas.h"
+
+#include <string.h>
+
+_Static_assert(sizeof(dados_medidos_t) % sizeof(uint32_t) == 0, "dados_medidos_t deve ocupar palavras inteiras");
+
+void barramento_metricas_inicializar(barramento_metricas_t *barramento, uint8_t total_canais)
+{
+    barramento->total_canais =
+        total_canais > BARRAMENTO_METRICAS_MAX_CANAIS ? BARRAMENTO_METRICAS_MAX_CANAIS : total_canais;
+    for (uint8_t c = 0; c < BARRAMENTO_METRICAS_MAX_CANAIS; c++) {
+        slot_metricas_t *slot = &barramento->canais[c];
+        atomic_store_explicit(&slot->sequencia, 0U, memory_order_relaxed);
+        for (size_t i = 0; i < BARRAMENTO_METRICAS_PALAVRAS; i++) {
+            atomic_store_explicit(&slot->palavras[i], 0U, memory_order_relaxed);
+        }
+    }
+}
+
+void barramento_metricas_publicar(barramento_metricas_t *barramento, uint8_t canal, const dados_medidos_t *dados)
+{
+    if (canal >= barramento->total_canais) {
+        return;
+    }
+    slot_metricas_t *slot = &barramento->canais[canal];
+    uint32_t palavras[BARRAMENTO_METRICAS_PALAVRAS];
+    memcpy(palavras, dados, sizeof(*dados));
+
+    /* Escritor unico: leitura relaxada da propria sequencia basta */
+    const uint32_t sequencia = atomic_load_explicit(&slot->sequencia, memory_order_relaxed);
+    atomic_store_explicit(&slot->sequencia, sequencia + 1U, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    for (size_t i = 0; i < BARRAMENTO_METRICAS_PALAVRAS; i++) {
+        atomic_store_explicit(&slot->palavras[i], palavras[i], memory_order_relaxed);
+    }
+    atomic_store_explicit(&slot->sequencia, sequencia + 2U, memory_order_release);
+}
+
+uint32_t barramento_metricas_versao(const barramento_metricas_t *barramento, uint8_t canal)
+{
+    if (canal >= barramento->total_canais) {
+        return 0;
+    }
+    /* Durante a escrita (impar) ainda vale a versao anterior */
+    return atomic_load_explicit(&barramento->canais[canal].sequencia, memory_order_acquire) >> 1;
+}
+
+bool barramento_metricas_ler(const barramento_metricas_t *barramento, uint8_t canal, uint32_t *versao,
+                             dados_medidos_t *destino)
+{
+    if (canal >= barramento->total_canais) {
+        return false;
+    }
+    const slot_metricas_t *slot = &barramento->canais[canal];
+    uint32_t palavras[BARRAMENTO_METRICAS_PALAVRAS];
+    for (uint32_t tentativa = 0; tentativa < BARRAMENTO_METRICAS_TENTATIVAS; tentativa++) {
+        const uint32_t inicio = atomic_load_explicit(&slot->sequencia, memory_order_acquire);
+        if (versao && (inicio >> 1) == *versao) {
+            return false;
+        }
+        if (inicio & 1U) {
+            continue;
+        }
+        for (size_t i = 0; i < BARRAMENTO_METRICAS_PALAVRAS; i++) {
+            palavras[i] = atomic_load_explicit(&slot->palavras[i], memory_order_relaxed);
+        }
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&slot->sequencia, memory_order_relaxed) == inicio) {
+            memcpy(destino, palavras, sizeof(*destino));
+            if (versao) {
+                *versao = inicio >> 1;
+            }
+            return true;
+        }
+    }
+    return false;
+}
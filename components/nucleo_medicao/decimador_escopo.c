@@ -0,0 +1,93 @@
+#include "decimador_escopo.h"
+
+#include <string.h>
+
+#define MASCARA (DECIMADOR_ESCOPO_CAPACIDADE - 1U)
+
+static void aplicar_nivel(decimador_escopo_t *decimador, bool alto)
+{
+    const int8_t valor = alto ? DECIMADOR_ESCOPO_AMPLITUDE : -DECIMADOR_ESCOPO_AMPLITUDE;
+    decimador->nivel_alto = alto;
+    if (valor < decimador->atual.minimo) {
+        decimador->atual.minimo = valor;
+    }
+    if (valor > decimador->atual.maximo) {
+        decimador->atual.maximo = valor;
+    }
+}
+
+static void fechar_coluna(decimador_escopo_t *decimador)
+{
+    const uint32_t total = atomic_load_explicit(&decimador->total_colunas, memory_order_relaxed);
+    decimador->colunas[total & MASCARA] = decimador->atual;
+    atomic_store_explicit(&decimador->total_colunas, total + 1U, memory_order_release);
+    decimador->inicio_coluna_us += decimador->largura_coluna_us;
+    const int8_t valor = decimador->nivel_alto ? DECIMADOR_ESCOPO_AMPLITUDE : -DECIMADOR_ESCOPO_AMPLITUDE;
+    decimador->atual.minimo = valor;
+    decimador->atual.maximo = valor;
+}
+
+void decimador_escopo_inicializar(decimador_escopo_t *decimador, uint32_t largura_coluna_us, uint32_t periodo_maximo_us)
+{
+    memset(decimador, 0, sizeof(*decimador));
+    decimador->largura_coluna_us = largura_coluna_us;
+    decimador->periodo_maximo_us = periodo_maximo_us;
+    decimador->nivel_alto = true;
+    decimador->atual.minimo = DECIMADOR_ESCOPO_AMPLITUDE;
+    decimador->atual.maximo = DECIMADOR_ESCOPO_AMPLITUDE;
+}
+
+void decimador_escopo_avancar(decimador_escopo_t *decimador, int64_t agora_us)
+{
+    if (decimador->inicio_coluna_us == 0) {
+        decimador->inicio_coluna_us = agora_us;
+        return;
+    }
+    /* Depois de muito tempo parado so as ultimas colunas interessam */
+    const int64_t janela_us = (int64_t)decimador->largura_coluna_us * DECIMADOR_ESCOPO_CAPACIDADE;
+    if (agora_us - decimador->inicio_coluna_us > janela_us) {
+        decimador->inicio_coluna_us = agora_us - janela_us;
+    }
+    while (true) {
+        const int64_t fim_coluna_us = decimador->inicio_coluna_us + decimador->largura_coluna_us;
+        const int64_t limite_us = agora_us < fim_coluna_us ? agora_us : fim_coluna_us;
+        if (!decimador->nivel_alto && decimador->subida_us <= limite_us) {
+            aplicar_nivel(decimador, true);
+        }
+        if (agora_us < fim_coluna_us) {
+            break;
+        }
+        fechar_coluna(decimador);
+    }
+}
+
+void decimador_escopo_registrar_borda(decimador_escopo_t *decimador, int64_t borda_us)
+{
+    decimador_escopo_avancar(decimador, borda_us);
+    const int64_t periodo_us = borda_us - decimador->ultima_borda_us;
+    if (decimador->ultima_borda_us > 0 && periodo_us > 0 && periodo_us <= (int64_t)decimador->periodo_maximo_us) {
+        decimador->subida_us = borda_us + periodo_us / 2;
+    } else {
+        decimador->subida_us = borda_us + decimador->largura_coluna_us;
+    }
+    decimador->ultima_borda_us = borda_us;
+    aplicar_nivel(decimador, false);
+}
+
+size_t decimador_escopo_ler(decimador_escopo_t *decimador, uint32_t *cursor, coluna_escopo_t *destino, size_t max)
+{
+    const uint32_t total = atomic_load_explicit(&decimador->total_colunas, memory_order_acquire);
+    uint32_t inicio = *cursor;
+    uint32_t disponiveis = total - inicio;
+    /* Leitor atrasado: pula para as mais recentes, deixando folga para o produtor que segue escrevendo */
+    const uint32_t limite = (uint32_t)(max < DECIMADOR_ESCOPO_CAPACIDADE / 2U ? max : DECIMADOR_ESCOPO_CAPACIDADE / 2U);
+    if (disponiveis > limite) {
+        inicio = total - limite;
+        disponiveis = limite;
+    }
+    for (uint32_t i = 0; i < disponiveis; i++) {
+        destino[i] = decimador->colunas[(inicio + i) & MASCARA];
+    }
+    *cursor = total;
+    return disponiveis;
+}
@@ -0,0 +1,146 @@
+#include "estatisticas_curso.h"
+
+#include <string.h>
+
+#define LIMITE_SOMA_DESVIOS (1LL << 30)   /* mantem soma^2 em 64 bits na leitura */
+
+void estatisticas_curso_inicializar(estatisticas_curso_t *estatisticas, uint32_t periodo_maximo_us)
+{
+    memset(estatisticas, 0, sizeof(*estatisticas));
+    estatisticas->periodo_maximo_us = periodo_maximo_us;
+}
+
+void estatisticas_curso_zerar(estatisticas_curso_t *estatisticas)
+{
+    estatisticas_curso_inicializar(estatisticas, estatisticas->periodo_maximo_us);
+}
+
+uint32_t estatisticas_curso_faixa(uint32_t periodo_us)
+{
+    return faixas_log2_indice(periodo_us, ESTATISTICAS_SUBFAIXAS_LOG2);
+}
+
+uint32_t estatisticas_curso_inicio_faixa(uint32_t faixa)
+{
+    return (uint32_t)faixas_log2_inicio(faixa, ESTATISTICAS_SUBFAIXAS_LOG2);
+}
+
+static uint32_t deque_indice(const estatisticas_deque_t *deque, uint32_t posicao)
+{
+    return deque->indices[(deque->inicio + posicao) % ESTATISTICAS_JANELA];
+}
+
+/* Mantem no deque so candidatos a extremo da janela; a frente e sempre o extremo atual */
+static void deque_inserir(estatisticas_deque_t *deque, const uint32_t *janela, uint32_t sequencia, bool maximo)
+{
+    const uint32_t valor = janela[sequencia % ESTATISTICAS_JANELA];
+    if (deque->tamanho > 0 && sequencia - deque_indice(deque, 0) >= ESTATISTICAS_JANELA) {
+        deque->inicio = (deque->inicio + 1U) % ESTATISTICAS_JANELA;
+        deque->tamanho--;
+    }
+    while (deque->tamanho > 0) {
+        const uint32_t ultimo = janela[deque_indice(deque, deque->tamanho - 1U) % ESTATISTICAS_JANELA];
+        if (maximo ? ultimo > valor : ultimo < valor) {
+            break;
+        }
+        deque->tamanho--;
+    }
+    deque->indices[(deque->inicio + deque->tamanho) % ESTATISTICAS_JANELA] = sequencia;
+    deque->tamanho++;
+}
+
+/* Arredonda para o inteiro mais proximo (metades para longe de zero) */
+static int64_t dividir_arredondando(int64_t numerador, uint32_t denominador)
+{
+    const int64_t metade = denominador / 2U;
+    return (numerador >= 0 ? numerador + metade : numerador - metade) / (int64_t)denominador;
+}
+
+/*
+ * Move a referencia para perto da media. Exato: com r = soma/n,
+ * sum(x - K - r) = soma - n*r e sum((x - K - r)^2) = quadrados - r*(2*soma - n*r).
+ * Depois dele |soma| <= n/2, entao so roda de novo se o sinal derivar.
+ */
+static void rebasear(estatisticas_curso_t *estatisticas)
+{
+    const int64_t soma = estatisticas->soma_desvios_us;
+    const int64_t n = estatisticas->amostras;
+    const int64_t passo = dividir_arredondando(soma, estatisticas->amostras);
+    estatisticas->referencia_us += passo;
+    estatisticas->soma_desvios_us = soma - n * passo;
+    estatisticas->soma_quadrados_us2 -= (uint64_t)(passo * (2 * soma - n * passo));
+}
+
+static uint32_t raiz_arredondada(uint64_t valor)
+{
+    uint64_t raiz = 0;
+    for (uint64_t bit = 1ULL << 62; bit != 0; bit >>= 2) {
+        if (valor >= raiz + bit) {
+            valor -= raiz + bit;
+            raiz = (raiz >> 1) + bit;
+        } else {
+            raiz >>= 1;
+        }
+    }
+    /* valor agora e o resto (v - raiz^2): arredonda para cima se passar de raiz + 1/4 */
+    return (uint32_t)(valor > raiz ? raiz + 1U : raiz);
+}
+
+void estatisticas_curso_registrar_periodo(estatisticas_curso_t *estatisticas, uint32_t periodo_us)
+{
+    const uint32_t sequencia = estatisticas->sequencia++;
+    estatisticas->janela[sequencia % ESTATISTICAS_JANELA] = periodo_us;
+    deque_inserir(&estatisticas->deque_minimo, estatisticas->janela, sequencia, false);
+    deque_inserir(&estatisticas->deque_maximo, estatisticas->janela, sequencia, true);
+
+    if (estatisticas->amostras++ == 0) {
+        estatisticas->referencia_us = periodo_us;
+    }
+    const int64_t desvio_us = (int64_t)periodo_us - estatisticas->referencia_us;
+    estatisticas->soma_desvios_us += desvio_us;
+    estatisticas->soma_quadrados_us2 += (uint64_t)(desvio_us * desvio_us);
+    if (estatisticas->soma_desvios_us > LIMITE_SOMA_DESVIOS || estatisticas->soma_desvios_us < -LIMITE_SOMA_DESVIOS) {
+        rebasear(estatisticas);
+    }
+
+    _Atomic uint32_t *faixa = &estatisticas->histograma[estatisticas_curso_faixa(periodo_us)];
+    atomic_store_explicit(faixa, atomic_load_explicit(faixa, memory_order_relaxed) + 1U, memory_order_relaxed);
+}
+
+void estatisticas_curso_registrar_borda(estatisticas_curso_t *estatisticas, int64_t borda_us)
+{
+    const int64_t delta_us = borda_us - estatisticas->ultima_borda_us;
+    if (estatisticas->ultima_borda_us != 0 && delta_us > 0 && delta_us <= (int64_t)estatisticas->periodo_maximo_us) {
+        estatisticas_curso_registrar_periodo(estatisticas, (uint32_t)delta_us);
+    }
+    estatisticas->ultima_borda_us = borda_us;
+}
+
+void estatisticas_curso_resumir(const estatisticas_curso_t *estatisticas, resumo_periodos_t *resumo)
+{
+    memset(resumo, 0, sizeof(*resumo));
+    if (estatisticas->amostras == 0) {
+        return;
+    }
+    const uint32_t n = estatisticas->amostras;
+    const int64_t soma = estatisticas->soma_desvios_us;
+    resumo->amostras = n;
+    resumo->periodo_medio_us = (uint32_t)(estatisticas->referencia_us + dividir_arredondando(soma, n));
+    if (n > 1) {
+        /* Variancia = (quadrados - soma^2/n) / (n - 1); |soma| < 2^31 pelo rebase */
+        const uint64_t correcao = (uint64_t)dividir_arredondando(soma * soma, n);
+        const uint64_t m2 = estatisticas->soma_quadrados_us2 > correcao ? estatisticas->soma_quadrados_us2 - correcao : 0U;
+        resumo->desvio_padrao_us = raiz_arredondada((m2 + (n - 1U) / 2U) / (n - 1U));
+    }
+    resumo->minimo_janela_us = estatisticas->janela[deque_indice(&estatisticas->deque_minimo, 0) % ESTATISTICAS_JANELA];
+    resumo->maximo_janela_us = estatisticas->janela[deque_indice(&estatisticas->deque_maximo, 0) % ESTATISTICAS_JANELA];
+}
+
+size_t estatisticas_curso_copiar_histograma(estatisticas_curso_t *estatisticas, uint32_t *destino, size_t max)
+{
+    const size_t quantidade = max < ESTATISTICAS_FAIXAS_HISTOGRAMA ? max : ESTATISTICAS_FAIXAS_HISTOGRAMA;
+    for (size_t i = 0; i < quantidade; i++) {
+        destino[i] = atomic_load_explicit(&estatisticas->histograma[i], memory_order_relaxed);
+    }
+    return quantidade;
+}
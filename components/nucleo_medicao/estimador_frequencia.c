@@ -0,0 +1,65 @@
+#include "estimador_frequencia.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define US_POR_SEGUNDO_Q16 (1000000ULL << 16)
+
+/* Q16.16 de 32 bits so vai ate 65535.99 Hz: acima satura em vez de dar a volta */
+static uint32_t saturar_q16(uint64_t frequencia_q16)
+{
+    return frequencia_q16 > UINT32_MAX ? UINT32_MAX : (uint32_t)frequencia_q16;
+}
+
+void estimador_frequencia_inicializar(estimador_frequencia_t *estimador, const estimador_frequencia_config_t *config)
+{
+    memset(estimador, 0, sizeof(*estimador));
+    estimador->config = *config;
+    if (estimador->config.periodos_minimos == 0) {
+        estimador->config.periodos_minimos = 1;
+    }
+}
+
+void estimador_frequencia_zerar(estimador_frequencia_t *estimador)
+{
+    const estimador_frequencia_config_t config = estimador->config;
+    memset(estimador, 0, sizeof(*estimador));
+    estimador->config = config;
+}
+
+void estimador_frequencia_registrar_borda(estimador_frequencia_t *estimador, int64_t borda_us)
+{
+    if (estimador->ultima_borda_us > 0) {
+        const int64_t periodo_us = borda_us - estimador->ultima_borda_us;
+        if (periodo_us > 0 && periodo_us <= (int64_t)estimador->config.periodo_maximo_us) {
+            estimador->ultimo_periodo_us = (uint32_t)periodo_us;
+            estimador->periodos_janela++;
+            estimador->ultima_borda_us = borda_us;
+            return;
+        }
+        /* Intervalo longo demais (pausa): recomeca a medicao nesta borda */
+        estimador->ultimo_periodo_us = 0;
+        estimador->frequencia_q16 = 0;
+    }
+    estimador->inicio_janela_us = borda_us;
+    estimador->ultima_borda_us = borda_us;
+    estimador->periodos_janela = 0;
+}
+
+uint32_t estimador_frequencia_fechar_janela(estimador_frequencia_t *estimador)
+{
+    const uint32_t periodos = estimador->periodos_janela;
+    if (periodos >= estimador->config.periodos_minimos) {
+        const uint64_t duracao_us = (uint64_t)(estimador->ultima_borda_us - estimador->inicio_janela_us);
+        estimador->frequencia_q16 = saturar_q16((periodos * US_POR_SEGUNDO_Q16 + duracao_us / 2) / duracao_us);
+    } else if (periodos > 0 && estimador->ultimo_periodo_us > 0) {
+        estimador->frequencia_q16 =
+            saturar_q16((US_POR_SEGUNDO_Q16 + estimador->ultimo_periodo_us / 2) / estimador->ultimo_periodo_us);
+    }
+
+    if (periodos > 0) {
+        estimador->inicio_janela_us = estimador->ultima_borda_us;
+        estimador->periodos_janela = 0;
+    }
+    return estimador->frequencia_q16;
+}
@@ -0,0 +1,34 @@
+#include "fila_bordas.h"
+
+void fila_bordas_inicializar(fila_bordas_t *fila)
+{
+    atomic_store_explicit(&fila->cabeca, 0U, memory_order_relaxed);
+    atomic_store_explicit(&fila->cauda, 0U, memory_order_relaxed);
+    atomic_store_explicit(&fila->transbordos, 0U, memory_order_relaxed);
+}
+
+size_t fila_bordas_drenar(fila_bordas_t *fila, int64_t *destino, size_t max)
+{
+    const uint32_t cauda = atomic_load_explicit(&fila->cauda, memory_order_relaxed);
+    const uint32_t cabeca = atomic_load_explicit(&fila->cabeca, memory_order_acquire);
+    size_t disponiveis = (size_t)(uint32_t)(cabeca - cauda);
+    if (disponiveis > max) {
+        disponiveis = max;
+    }
+    for (size_t i = 0; i < disponiveis; i++) {
+        destino[i] = fila->bordas_us[(cauda + (uint32_t)i) & (FILA_BORDAS_CAPACIDADE - 1U)];
+    }
+    atomic_store_explicit(&fila->cauda, cauda + (uint32_t)disponiveis, memory_order_release);
+    return disponiveis;
+}
+
+bool fila_bordas_vazia(fila_bordas_t *fila)
+{
+    return atomic_load_explicit(&fila->cabeca, memory_order_acquire) ==
+           atomic_load_explicit(&fila->cauda, memory_order_relaxed);
+}
+
+uint32_t fila_bordas_transbordos(fila_bordas_t *fila)
+{
+    return atomic_load_explicit(&fila->transbordos, memory_order_relaxed);
+}
@@ -0,0 +1,22 @@
+#include "filtro_glitch.h"
+
+#include <string.h>
+
+void filtro_glitch_inicializar(filtro_glitch_t *filtro, const filtro_glitch_config_t *config)
+{
+    memset(filtro, 0, sizeof(*filtro));
+    filtro->config = *config;
+    if (filtro->config.suavizacao_shift > 8) {
+        filtro->config.suavizacao_shift = 8;
+    }
+}
+
+uint32_t filtro_glitch_rejeitadas(filtro_glitch_t *filtro)
+{
+    return atomic_load_explicit(&filtro->rejeitadas, memory_order_relaxed);
+}
+
+uint32_t filtro_glitch_aceitas(filtro_glitch_t *filtro)
+{
+    return atomic_load_explicit(&filtro->aceitas, memory_order_relaxed);
+}
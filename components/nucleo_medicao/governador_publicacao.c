@@ -0,0 +1,33 @@
+#include "governador_publicacao.h"
+
+#include <string.h>
+
+void governador_publicacao_inicializar(governador_publicacao_t *governador, const governador_config_t *config)
+{
+    memset(governador, 0, sizeof(*governador));
+    governador->config = *config;
+    governador->modo = GOVERNADOR_PARADO;
+}
+
+uint32_t governador_publicacao_avaliar(governador_publicacao_t *governador, bool mudou, bool sinal_ativo,
+                                       uint32_t prazo_ms)
+{
+    if (mudou) {
+        governador->estaveis = 0;
+    } else if (governador->estaveis < UINT32_MAX) {
+        governador->estaveis++;
+    }
+
+    uint32_t espera_ms;
+    if (!sinal_ativo) {
+        governador->modo = GOVERNADOR_PARADO;
+        espera_ms = GOVERNADOR_ESPERA_INFINITA;
+    } else if (governador->estaveis >= governador->config.publicacoes_estaveis) {
+        governador->modo = GOVERNADOR_LENTO;
+        espera_ms = governador->config.intervalo_lento_ms;
+    } else {
+        governador->modo = GOVERNADOR_RAPIDO;
+        espera_ms = governador->config.intervalo_rapido_ms;
+    }
+    return prazo_ms < espera_ms ? prazo_ms : espera_ms;
+}
@@ -0,0 +1,36 @@
+#include "histograma_latencia.h"
+
+#include <string.h>
+
+void histograma_latencia_zerar(histograma_latencia_t *histograma)
+{
+    memset(histograma, 0, sizeof(*histograma));
+}
+
+void histograma_latencia_registrar(histograma_latencia_t *histograma, uint32_t latencia_us)
+{
+    histograma->faixas[faixas_log2_indice(latencia_us, HISTOGRAMA_LATENCIA_SUBFAIXAS_LOG2)]++;
+    histograma->amostras++;
+    if (latencia_us > histograma->maximo_us) {
+        histograma->maximo_us = latencia_us;
+    }
+}
+
+uint32_t histograma_latencia_percentil(const histograma_latencia_t *histograma, uint32_t por_mil)
+{
+    if (histograma->amostras == 0) {
+        return 0;
+    }
+    /* Posicao da amostra (1..amostras) que o percentil pede, arredondada para cima */
+    const uint64_t alvo = ((uint64_t)histograma->amostras * por_mil + 999U) / 1000U;
+    uint64_t acumulado = 0;
+    for (uint32_t i = 0; i < HISTOGRAMA_LATENCIA_FAIXAS; i++) {
+        acumulado += histograma->faixas[i];
+        if (acumulado >= alvo && histograma->faixas[i] > 0) {
+            const uint64_t meio = (faixas_log2_inicio(i, HISTOGRAMA_LATENCIA_SUBFAIXAS_LOG2) +
+                                   faixas_log2_inicio(i + 1U, HISTOGRAMA_LATENCIA_SUBFAIXAS_LOG2)) / 2U;
+            return meio < histograma->maximo_us ? (uint32_t)meio : histograma->maximo_us;
+        }
+    }
+    return histograma->maximo_us;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CURSO_MIN_MM 1.0f
+#define CURSO_MAX_MM 5.0f
+#define CURSO_MIN_CM (CURSO_MIN_MM / 10.0f)
+#define CURSO_MAX_CM (CURSO_MAX_MM / 10.0f)
+#define UM_POR_CM 10000U
+
+/* Ponto fixo Q16.16 */
+#define Q16_UM (1UL << 16)
+
+static inline float q16_para_float(uint32_t valor_q16)
+{
+    return (float)valor_q16 / (float)Q16_UM;
+}
+
+static inline uint32_t q16_arredondar(uint64_t valor_q16)
+{
+    return (uint32_t)((valor_q16 + (Q16_UM / 2U)) >> 16);
+}
+
+/* Regularidade do curso: media/desvio desde o inicio da sessao, extremos da janela recente */
+typedef struct {
+    uint32_t amostras;
+    uint32_t periodo_medio_us;
+    uint32_t desvio_padrao_us;
+    uint32_t minimo_janela_us;
+    uint32_t maximo_janela_us;
+} resumo_periodos_t;
+
+/* Ciclo de uma sessao: ATIVA <-> PAUSADA -> ENCERRADA -> (proxima borda) ATIVA */
+typedef enum {
+    SESSAO_OCIOSA = 0,         /* nenhuma borda desde o boot */
+    SESSAO_ATIVA,
+    SESSAO_PAUSADA,            /* sem bordas alem do tempo de pausa; totais mantidos */
+    SESSAO_ENCERRADA,          /* pausada alem do tempo de encerrar; resumo emitido */
+} sessao_estado_t;
+
+/* Carimbos da medicao para a latencia pulso-tela (ver main/latencia_tela.h) */
+typedef struct {
+    uint32_t sequencia;        /* publicacao do canal, cresce de 1 em 1 */
+    int64_t borda_us;          /* ultima borda desta publicacao; 0 se nenhuma chegou desde a anterior */
+    int64_t publicacao_us;
+} carimbo_medicao_t;
+
+typedef struct {
+    uint32_t frequencia_q16;   /* Hz */
+    uint32_t rpm_q16;
+    uint32_t velocidade_q16;   /* cm/s */
+    uint64_t distancia_um;     /* furos x curso, acumulado por trecho de curso */
+    uint32_t furos;
+    uint64_t tempo_sinal_ms;
+    resumo_periodos_t periodos;
+    uint8_t estado_sessao;     /* sessao_estado_t */
+    carimbo_medicao_t carimbo; /* preenchido pela tarefa de metricas, nao pelo nucleo */
+} dados_medidos_t;
+
+/* Registro compacto gravado quando uma sessao encerra */
+typedef struct {
+    uint32_t numero;           /* ordem global, atribuida ao arquivar */
+    uint8_t canal;
+    uint8_t reservado[3];
+    uint32_t duracao_ms;       /* primeira a ultima borda, pausas incluidas */
+    uint32_t tempo_ativo_ms;
+    uint32_t furos;
+    uint32_t rpm_medio_q16;    /* furos por tempo ativo */
+    uint32_t rpm_pico_q16;     /* maior RPM publicado */
+    uint64_t distancia_um;
+} resumo_sessao_t;
+
+typedef struct {
+    float curso_cm;
+} configuracao_curso_t;
+
+#define SESSAO_PAUSA_MIN_MS      300U
+#define SESSAO_PAUSA_MAX_MS      10000U
+#define SESSAO_ENCERRAR_MIN_MS   5000U
+#define SESSAO_ENCERRAR_MAX_MS   7200000U
+#define SESSAO_PAUSA_PADRAO_MS   1000U
+#define SESSAO_ENCERRAR_PADRAO_MS 300000U
+
+typedef struct {
+    uint32_t tempo_pausa_ms;      /* sem bordas por mais que isso: sessao pausada */
+    uint32_t tempo_encerrar_ms;   /* pausada por mais que isso: sessao encerrada */
+} configuracao_sessao_t;
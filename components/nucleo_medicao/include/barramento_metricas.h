@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "app_types.h"
+
+/*
+ * Ultima medicao de cada canal, publicada por um unico escritor (tarefa de
+ * metricas) e lida por quantos consumidores houver (UI, gravador, serial).
+ * Cada canal e um seqlock: a sequencia fica impar durante a escrita e o
+ * leitor repete a copia se ela mudou no meio. O escritor nunca espera
+ * leitores; o leitor desiste apos BARRAMENTO_METRICAS_TENTATIVAS (pode ter
+ * preemptado o escritor no mesmo nucleo) e fica com o que ja tinha.
+ * A versao (sequencia / 2) cresce a cada publicacao e permite perguntar
+ * "mudou desde a versao N?" sem copiar nada.
+ */
+#define BARRAMENTO_METRICAS_MAX_CANAIS 4
+#define BARRAMENTO_METRICAS_TENTATIVAS 4
+
+#define BARRAMENTO_METRICAS_PALAVRAS ((sizeof(dados_medidos_t) + sizeof(uint32_t) - 1U) / sizeof(uint32_t))
+
+typedef struct {
+    _Atomic uint32_t sequencia;
+    /* Palavras atomicas relaxadas: a copia concorrente fica definida em C11 */
+    _Atomic uint32_t palavras[BARRAMENTO_METRICAS_PALAVRAS];
+} slot_metricas_t;
+
+typedef struct {
+    slot_metricas_t canais[BARRAMENTO_METRICAS_MAX_CANAIS];
+    uint8_t total_canais;
+} barramento_metricas_t;
+
+void barramento_metricas_inicializar(barramento_metricas_t *barramento, uint8_t total_canais);
+/* So a tarefa de metricas publica; nao bloqueia nem espera leitores. */
+void barramento_metricas_publicar(barramento_metricas_t *barramento, uint8_t canal, const dados_medidos_t *dados);
+/* Versao da ultima publicacao completa do canal (0 antes da primeira). */
+uint32_t barramento_metricas_versao(const barramento_metricas_t *barramento, uint8_t canal);
+/*
+ * Copia a medicao se a versao do canal for diferente de *versao (ou sempre,
+ * com versao NULL) e atualiza *versao. Retorna false sem tocar em destino
+ * quando nada mudou ou a copia nao fechou dentro das tentativas.
+ */
+bool barramento_metricas_ler(const barramento_metricas_t *barramento, uint8_t canal, uint32_t *versao,
+                             dados_medidos_t *destino);
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Decimador do osciloscopio: reconstroi a forma de onda a partir das bordas
+ * (nivel baixo na borda, subida na metade do periodo anterior) e a reduz a
+ * colunas de largura fixa com minimo/maximo, como um osciloscopio faz por
+ * pixel. As colunas prontas vao para um anel lido por outra tarefa com um
+ * cursor proprio; o leitor so recebe as colunas novas.
+ */
+#define DECIMADOR_ESCOPO_CAPACIDADE  256   /* potencia de 2 */
+#define DECIMADOR_ESCOPO_AMPLITUDE   90
+
+typedef struct {
+    int8_t minimo;
+    int8_t maximo;
+} coluna_escopo_t;
+
+typedef struct {
+    uint32_t largura_coluna_us;
+    uint32_t periodo_maximo_us;   /* acima disso a borda vira um pulso de uma coluna */
+    int64_t inicio_coluna_us;
+    int64_t subida_us;
+    int64_t ultima_borda_us;
+    bool nivel_alto;
+    coluna_escopo_t atual;
+    coluna_escopo_t colunas[DECIMADOR_ESCOPO_CAPACIDADE];
+    _Atomic uint32_t total_colunas;   /* publicado pelo produtor depois de escrever a coluna */
+} decimador_escopo_t;
+
+void decimador_escopo_inicializar(decimador_escopo_t *decimador, uint32_t largura_coluna_us, uint32_t periodo_maximo_us);
+void decimador_escopo_registrar_borda(decimador_escopo_t *decimador, int64_t borda_us);
+/* Fecha as colunas ate o instante dado; chamado tambem sem bordas para o traco seguir andando. */
+void decimador_escopo_avancar(decimador_escopo_t *decimador, int64_t agora_us);
+/* Copia as colunas desde *cursor (no maximo max, as mais recentes) e avanca o cursor. */
+size_t decimador_escopo_ler(decimador_escopo_t *decimador, uint32_t *cursor, coluna_escopo_t *destino, size_t max);
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "app_types.h"
+#include "faixas_log2.h"
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Estatisticas de regularidade do curso, alimentadas borda a borda em O(1):
+ * media e variancia do periodo (somas inteiras em torno de uma referencia,
+ * sem ponto flutuante no caminho quente), minimo/maximo dos ultimos
+ * ESTATISTICAS_JANELA periodos (deques monotonicos) e histograma log2 com
+ * sub-faixas. Tudo preso na struct, sem heap. Roda no contexto da tarefa de
+ * metricas; so o histograma e lido por outras tarefas.
+ */
+#define ESTATISTICAS_JANELA              64
+#define ESTATISTICAS_SUBFAIXAS_LOG2      2     /* 4 sub-faixas por oitava */
+#define ESTATISTICAS_FAIXAS_HISTOGRAMA   FAIXAS_LOG2_TOTAL(ESTATISTICAS_SUBFAIXAS_LOG2)
+
+typedef struct {
+    uint32_t indices[ESTATISTICAS_JANELA];   /* numeros de sequencia, valores monotonicos */
+    uint32_t inicio;
+    uint32_t tamanho;
+} estatisticas_deque_t;
+
+typedef struct {
+    uint32_t periodo_maximo_us;   /* intervalos maiores nao contam como periodo */
+    int64_t ultima_borda_us;
+    uint32_t sequencia;
+    uint32_t janela[ESTATISTICAS_JANELA];
+    estatisticas_deque_t deque_minimo;
+    estatisticas_deque_t deque_maximo;
+    uint32_t amostras;
+    /* Somas dos desvios em relacao a referencia; rebase exato quando a soma cresce */
+    int64_t referencia_us;
+    int64_t soma_desvios_us;
+    uint64_t soma_quadrados_us2;   /* cabe enquanto amostras x variancia < 2^64 */
+    /* Unico escritor (tarefa de metricas); leitores podem ver faixas de momentos diferentes */
+    _Atomic uint32_t histograma[ESTATISTICAS_FAIXAS_HISTOGRAMA];
+} estatisticas_curso_t;
+
+void estatisticas_curso_inicializar(estatisticas_curso_t *estatisticas, uint32_t periodo_maximo_us);
+void estatisticas_curso_zerar(estatisticas_curso_t *estatisticas);
+void estatisticas_curso_registrar_borda(estatisticas_curso_t *estatisticas, int64_t borda_us);
+void estatisticas_curso_registrar_periodo(estatisticas_curso_t *estatisticas, uint32_t periodo_us);
+void estatisticas_curso_resumir(const estatisticas_curso_t *estatisticas, resumo_periodos_t *resumo);
+size_t estatisticas_curso_copiar_histograma(estatisticas_curso_t *estatisticas, uint32_t *destino, size_t max);
+uint32_t estatisticas_curso_faixa(uint32_t periodo_us);
+uint32_t estatisticas_curso_inicio_faixa(uint32_t faixa);
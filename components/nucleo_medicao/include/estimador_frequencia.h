@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Estimador reciproco de frequencia: numero de periodos completos na janela
+ * dividido pelo tempo entre a primeira e a ultima borda. A janela comeca na
+ * ultima borda da janela anterior, entao nenhum periodo fica de fora.
+ * Resultado em Hz no formato Q16.16.
+ */
+typedef struct {
+    uint32_t periodos_minimos;    /* abaixo disso a janela usa so o ultimo periodo */
+    uint32_t periodo_maximo_us;   /* intervalos maiores reiniciam a medicao */
+} estimador_frequencia_config_t;
+
+typedef struct {
+    estimador_frequencia_config_t config;
+    int64_t inicio_janela_us;
+    int64_t ultima_borda_us;
+    uint32_t periodos_janela;
+    uint32_t ultimo_periodo_us;
+    uint32_t frequencia_q16;
+} estimador_frequencia_t;
+
+void estimador_frequencia_inicializar(estimador_frequencia_t *estimador, const estimador_frequencia_config_t *config);
+void estimador_frequencia_zerar(estimador_frequencia_t *estimador);
+void estimador_frequencia_registrar_borda(estimador_frequencia_t *estimador, int64_t borda_us);
+uint32_t estimador_frequencia_fechar_janela(estimador_frequencia_t *estimador);
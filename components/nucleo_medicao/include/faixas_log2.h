@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Faixas log-lineares de valores de 32 bits, comuns aos histogramas do
+ * nucleo: valores abaixo de 2^subfaixas_log2 tem faixa propria; acima, cada
+ * oitava 2^e..2^(e+1) e dividida pelos subfaixas_log2 bits logo abaixo do
+ * mais significativo. Inline: a faixa e calculada a cada borda.
+ */
+#define FAIXAS_LOG2_TOTAL(subfaixas_log2) (((32 - (subfaixas_log2)) + 1) << (subfaixas_log2))
+
+static inline uint32_t faixas_log2_indice(uint32_t valor, uint32_t subfaixas_log2)
+{
+    const uint32_t subfaixas = 1U << subfaixas_log2;
+    if (valor < subfaixas) {
+        return valor;
+    }
+    const uint32_t expoente = 31U - (uint32_t)__builtin_clz(valor);
+    const uint32_t sub = (valor >> (expoente - subfaixas_log2)) & (subfaixas - 1U);
+    return ((expoente - subfaixas_log2 + 1U) << subfaixas_log2) + sub;
+}
+
+/* Menor valor da faixa; 64 bits porque o fim da ultima faixa e 2^32 */
+static inline uint64_t faixas_log2_inicio(uint32_t indice, uint32_t subfaixas_log2)
+{
+    const uint32_t subfaixas = 1U << subfaixas_log2;
+    if (indice < subfaixas) {
+        return indice;
+    }
+    const uint32_t expoente = (indice >> subfaixas_log2) + subfaixas_log2 - 1U;
+    const uint32_t sub = indice & (subfaixas - 1U);
+    return (uint64_t)(subfaixas | sub) << (expoente - subfaixas_log2);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Fila SPSC sem trava: um unico produtor (ISR) e um unico consumidor (tarefa). */
+#define FILA_BORDAS_CAPACIDADE 256U
+
+_Static_assert((FILA_BORDAS_CAPACIDADE & (FILA_BORDAS_CAPACIDADE - 1U)) == 0U,
+               "FILA_BORDAS_CAPACIDADE deve ser potencia de 2");
+
+typedef struct {
+    int64_t bordas_us[FILA_BORDAS_CAPACIDADE];
+    _Atomic uint32_t cabeca;
+    _Atomic uint32_t cauda;
+    _Atomic uint32_t transbordos;
+} fila_bordas_t;
+
+void fila_bordas_inicializar(fila_bordas_t *fila);
+size_t fila_bordas_drenar(fila_bordas_t *fila, int64_t *destino, size_t max);
+uint32_t fila_bordas_transbordos(fila_bordas_t *fila);
+bool fila_bordas_vazia(fila_bordas_t *fila);
+
+/* Chamada do contexto de ISR; sempre inline para ficar junto do codigo em IRAM. */
+static inline __attribute__((always_inline)) bool fila_bordas_inserir(fila_bordas_t *fila, int64_t borda_us)
+{
+    const uint32_t cabeca = atomic_load_explicit(&fila->cabeca, memory_order_relaxed);
+    const uint32_t cauda = atomic_load_explicit(&fila->cauda, memory_order_acquire);
+    if ((uint32_t)(cabeca - cauda) >= FILA_BORDAS_CAPACIDADE) {
+        const uint32_t perdidas = atomic_load_explicit(&fila->transbordos, memory_order_relaxed);
+        atomic_store_explicit(&fila->transbordos, perdidas + 1U, memory_order_relaxed);
+        return false;
+    }
+    fila->bordas_us[cabeca & (FILA_BORDAS_CAPACIDADE - 1U)] = borda_us;
+    atomic_store_explicit(&fila->cabeca, cabeca + 1U, memory_order_release);
+    return true;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Filtro de glitch adaptativo. Rejeita bordas que chegam antes de uma fracao
+ * do periodo estimado (media movel exponencial dos periodos aceitos). Bordas
+ * rejeitadas nao movem a referencia, entao um sensor ruidoso nao consegue
+ * atrasar indefinidamente a proxima borda real. Tempo constante e sem
+ * chamadas externas: seguro para ISR em IRAM.
+ */
+typedef struct {
+    uint32_t bloqueio_minimo_us;  /* piso do bloqueio, usado tambem sem estimativa */
+    uint32_t fracao_q8;           /* fracao do periodo estimado (256 = 1.0) */
+    uint32_t periodo_maximo_us;   /* intervalos maiores descartam a estimativa */
+    uint8_t suavizacao_shift;     /* peso da media movel ao descer: 1 / 2^shift */
+} filtro_glitch_config_t;
+
+typedef struct {
+    filtro_glitch_config_t config;
+    int64_t ultima_aceita_us;
+    uint32_t periodo_estimado_us;
+    _Atomic uint32_t aceitas;
+    _Atomic uint32_t rejeitadas;
+} filtro_glitch_t;
+
+void filtro_glitch_inicializar(filtro_glitch_t *filtro, const filtro_glitch_config_t *config);
+uint32_t filtro_glitch_rejeitadas(filtro_glitch_t *filtro);
+uint32_t filtro_glitch_aceitas(filtro_glitch_t *filtro);
+
+static inline __attribute__((always_inline)) void filtro_glitch_contar(_Atomic uint32_t *contador)
+{
+    /* Unico escritor: leitura + escrita relaxadas bastam e evitam instrucoes atomicas RMW. */
+    atomic_store_explicit(contador, atomic_load_explicit(contador, memory_order_relaxed) + 1U,
+                          memory_order_relaxed);
+}
+
+static inline __attribute__((always_inline)) bool filtro_glitch_aceitar(filtro_glitch_t *filtro, int64_t borda_us)
+{
+    const int64_t delta_us = borda_us - filtro->ultima_aceita_us;
+    if (filtro->ultima_aceita_us == 0 || delta_us > (int64_t)filtro->config.periodo_maximo_us) {
+        filtro->periodo_estimado_us = 0;
+        filtro->ultima_aceita_us = borda_us;
+        filtro_glitch_contar(&filtro->aceitas);
+        return true;
+    }
+
+    uint32_t limite_us = (uint32_t)(((uint64_t)filtro->periodo_estimado_us * filtro->config.fracao_q8) >> 8);
+    if (limite_us < filtro->config.bloqueio_minimo_us) {
+        limite_us = filtro->config.bloqueio_minimo_us;
+    }
+    if (delta_us < (int64_t)limite_us) {
+        filtro_glitch_contar(&filtro->rejeitadas);
+        return false;
+    }
+
+    /*
+     * Media assimetrica: sobe rapido e desce devagar. Um repique aceito antes
+     * da estimativa convergir puxa a media para baixo so um pouco, e o
+     * periodo real seguinte a recupera; sem isso o filtro pode estabilizar
+     * aceitando um repique por ciclo.
+     */
+    const uint32_t periodo_us = (uint32_t)delta_us;
+    if (filtro->periodo_estimado_us == 0) {
+        filtro->periodo_estimado_us = periodo_us;
+    } else {
+        const int32_t erro = (int32_t)(periodo_us - filtro->periodo_estimado_us);
+        const uint8_t shift = erro > 0 ? 1U : filtro->config.suavizacao_shift;
+        filtro->periodo_estimado_us = (uint32_t)((int32_t)filtro->periodo_estimado_us + (erro >> shift));
+    }
+    filtro->ultima_aceita_us = borda_us;
+    filtro_glitch_contar(&filtro->aceitas);
+    return true;
+}
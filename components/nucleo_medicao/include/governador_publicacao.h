@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define GOVERNADOR_ESPERA_INFINITA UINT32_MAX
+
+/*
+ * Decide quanto tarefa_metricas pode dormir depois de cada publicacao:
+ * intervalo rapido enquanto o valor muda, batimento lento quando estavel
+ * e parada total (ate a proxima borda ou prazo) sem sinal.
+ */
+typedef enum {
+    GOVERNADOR_RAPIDO = 0,
+    GOVERNADOR_LENTO,
+    GOVERNADOR_PARADO,
+} governador_modo_t;
+
+typedef struct {
+    uint32_t intervalo_rapido_ms;
+    uint32_t intervalo_lento_ms;
+    uint32_t publicacoes_estaveis;  /* sem mudanca antes de passar para o batimento lento */
+} governador_config_t;
+
+typedef struct {
+    governador_config_t config;
+    governador_modo_t modo;
+    uint32_t estaveis;
+} governador_publicacao_t;
+
+void governador_publicacao_inicializar(governador_publicacao_t *governador, const governador_config_t *config);
+/* prazo_ms: tempo ate o proximo evento de tempo (ocioso/reset) ou GOVERNADOR_ESPERA_INFINITA */
+uint32_t governador_publicacao_avaliar(governador_publicacao_t *governador, bool mudou, bool sinal_ativo,
+                                       uint32_t prazo_ms);
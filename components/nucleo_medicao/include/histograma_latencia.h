@@ -0,0 +1,24 @@
+#pragma once
+
+#include "faixas_log2.h"
+
+#include <stdint.h>
+
+/*
+ * Histograma de latencias em microssegundos com faixas log-lineares (8 por
+ * oitava, erro de ate 1/16 no meio da faixa), de onde saem percentis sem
+ * guardar amostras. O maximo e exato. Sem travas: quem usa protege.
+ */
+#define HISTOGRAMA_LATENCIA_SUBFAIXAS_LOG2 3
+#define HISTOGRAMA_LATENCIA_FAIXAS FAIXAS_LOG2_TOTAL(HISTOGRAMA_LATENCIA_SUBFAIXAS_LOG2)
+
+typedef struct {
+    uint32_t faixas[HISTOGRAMA_LATENCIA_FAIXAS];
+    uint32_t amostras;
+    uint32_t maximo_us;
+} histograma_latencia_t;
+
+void histograma_latencia_zerar(histograma_latencia_t *histograma);
+void histograma_latencia_registrar(histograma_latencia_t *histograma, uint32_t latencia_us);
+/* Latencia abaixo da qual ficam `por_mil` milesimos das amostras (meio da faixa, limitado ao maximo) */
+uint32_t histograma_latencia_percentil(const histograma_latencia_t *histograma, uint32_t por_mil);
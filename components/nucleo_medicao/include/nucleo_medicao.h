@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "app_types.h"
+#include "estatisticas_curso.h"
+#include "estimador_frequencia.h"
+
+/*
+ * Nucleo de medicao sem dependencia de plataforma: recebe bordas ja
+ * filtradas, mantem contagem, distancia por trechos de curso, tempo de
+ * sinal e a maquina de estados da sessao (ver sessao_estado_t). Ao encerrar,
+ * o resumo sai dos acumuladores correntes e os totais continuam publicados
+ * ate a proxima borda abrir outra sessao. O tempo vem de um relogio
+ * injetado, entao o mesmo codigo roda no firmware e no host.
+ */
+typedef int64_t (*nucleo_relogio_us_t)(void *contexto);
+
+typedef struct {
+    configuracao_sessao_t sessao;   /* valores iniciais; ver nucleo_medicao_definir_sessao() */
+    uint32_t periodo_maximo_us;     /* intervalos maiores nao contam como periodo */
+    uint32_t periodos_minimos;      /* ver estimador_frequencia_config_t */
+    nucleo_relogio_us_t relogio;
+    void *contexto_relogio;
+} nucleo_medicao_config_t;
+
+typedef struct {
+    nucleo_medicao_config_t config;
+    estimador_frequencia_t estimador;
+    estatisticas_curso_t estatisticas;
+    /* Unicos campos escritos fora da tarefa dona */
+    _Atomic uint32_t curso_um;
+    _Atomic uint32_t tempo_pausa_ms;
+    _Atomic uint32_t tempo_encerrar_ms;
+    uint32_t total_furos;
+    int64_t ultimo_pulso_us;
+    int64_t ultima_atualizacao_ms;
+    sessao_estado_t estado;
+    int64_t inicio_sessao_ms;
+    int64_t inicio_sinal_ms;
+    uint64_t tempo_sinal_ms;
+    /* Distancia por trechos: cada mudanca de curso fecha o trecho anterior */
+    uint64_t distancia_base_um;
+    uint32_t furos_inicio_trecho;
+    uint32_t curso_trecho_um;
+    /* Resumo da sessao */
+    uint32_t frequencia_pico_q16;
+    uint32_t periodos_ativos;        /* bordas com antecessora no mesmo trecho ativo */
+    bool resumo_pendente;
+    resumo_sessao_t resumo;
+} nucleo_medicao_t;
+
+void nucleo_medicao_inicializar(nucleo_medicao_t *nucleo, const nucleo_medicao_config_t *config);
+/* Pode ser chamada de outra tarefa; vale a partir da proxima publicacao. */
+void nucleo_medicao_definir_curso_um(nucleo_medicao_t *nucleo, uint32_t curso_um);
+/* Pode ser chamada de outra tarefa; valores fora dos limites SESSAO_* sao saturados. */
+void nucleo_medicao_definir_sessao(nucleo_medicao_t *nucleo, const configuracao_sessao_t *sessao);
+/* Retorna o periodo desde a borda anterior (saturado) ou 0 na primeira borda da sessao. */
+uint32_t nucleo_medicao_registrar_borda(nucleo_medicao_t *nucleo, int64_t borda_us);
+/* Fecha a janela no instante atual do relogio e preenche a medicao; retorna se a sessao esta ativa. */
+bool nucleo_medicao_publicar(nucleo_medicao_t *nucleo, dados_medidos_t *medicao);
+/* Tempo ate a proxima transicao (pausa ou encerramento); UINT32_MAX sem sessao aberta. */
+uint32_t nucleo_medicao_prazo_ms(nucleo_medicao_t *nucleo);
+/* Entrega uma vez o resumo da ultima sessao encerrada (numero e canal ficam para quem arquiva). */
+bool nucleo_medicao_retirar_resumo(nucleo_medicao_t *nucleo, resumo_sessao_t *resumo);
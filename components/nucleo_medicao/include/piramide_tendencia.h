@@ -0,0 +1,91 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Historico de tendencia em niveis de resolucao (1 s, 10 s e 1 min), cada um
+ * um anel de tamanho fixo com minimo/maximo/media de frequencia e
+ * velocidade por periodo. As amostras entram no nivel de 1 s com peso pelo
+ * tempo em que valeram (ate a seguinte, no maximo
+ * PIRAMIDE_TENDENCIA_RETENCAO_MS); cada periodo fechado sobe para o
+ * acumulador do nivel seguinte, entao o custo por amostra e constante.
+ * Periodos sem amostra viram lacunas sem ocupar o anel: cada registro leva o
+ * indice do seu periodo e a leitura preenche os buracos, entao uma pausa de
+ * horas custa o mesmo que um segundo. A memoria dos aneis vem de quem usa
+ * (PSRAM no ESP). Sem travas: quem usa protege.
+ */
+#define PIRAMIDE_TENDENCIA_NIVEIS     3
+#define PIRAMIDE_TENDENCIA_RETENCAO_MS 1000   /* publicacao mais velha que isso nao vale mais: lacuna */
+
+typedef struct {
+    uint32_t minimo_q16;
+    uint32_t maximo_q16;
+    uint32_t media_q16;
+} faixa_tendencia_t;
+
+/* Um periodo de um nivel; minimo > maximo marca lacuna */
+typedef struct {
+    faixa_tendencia_t frequencia;   /* Hz */
+    faixa_tendencia_t velocidade;   /* cm/s */
+} ponto_tendencia_t;
+
+/* Periodo fechado com amostra; `periodo` e o indice (tempo / periodo_s) truncado */
+typedef struct {
+    ponto_tendencia_t ponto;
+    uint32_t periodo;
+} registro_tendencia_t;
+
+typedef struct {
+    uint32_t minimo_q16[2];
+    uint32_t maximo_q16[2];
+    uint64_t soma_q16[2];           /* valor x peso */
+    uint32_t peso;                  /* ms no nivel de 1 s, periodos de baixo acima dele */
+} acumulador_tendencia_t;
+
+typedef struct {
+    registro_tendencia_t *registros;
+    uint32_t capacidade;
+    uint32_t periodo_s;
+    uint32_t total;                 /* registros no anel, ate a capacidade */
+    uint32_t proximo;               /* posicao de escrita */
+    int64_t periodo_inicial;        /* primeiro periodo do historico */
+    int64_t periodo_aberto;         /* indice (tempo / periodo_s) do acumulador */
+    acumulador_tendencia_t acumulador;
+} nivel_tendencia_t;
+
+typedef struct {
+    nivel_tendencia_t niveis[PIRAMIDE_TENDENCIA_NIVEIS];
+    uint32_t retido_q16[2];         /* ultima amostra, vale ate retido_ate_ms */
+    int64_t retido_ate_ms;
+    int64_t contado_ate_ms;         /* o nivel de 1 s ja tem o tempo ate aqui */
+    bool iniciada;
+} piramide_tendencia_t;
+
+/* Periodo de cada nivel em segundos */
+uint32_t piramide_tendencia_periodo_s(uint8_t nivel);
+/* Registros que o nivel precisa para cobrir `duracao_s` */
+uint32_t piramide_tendencia_capacidade(uint8_t nivel, uint32_t duracao_s);
+/* `memoria[n]` com piramide_tendencia_capacidade(n, duracao_s) registros */
+void piramide_tendencia_inicializar(piramide_tendencia_t *piramide,
+                                    registro_tendencia_t *memoria[PIRAMIDE_TENDENCIA_NIVEIS], uint32_t duracao_s);
+void piramide_tendencia_registrar(piramide_tendencia_t *piramide, int64_t agora_ms, uint32_t frequencia_q16,
+                                  uint32_t velocidade_q16);
+/* Fecha os periodos ate agora sem amostra nova (sinal parado ainda anda o tempo) */
+void piramide_tendencia_avancar(piramide_tendencia_t *piramide, int64_t agora_ms);
+/*
+ * Os ultimos `janela_s` segundos em no maximo `maximo_pontos`, do mais antigo
+ * ao mais novo: le o nivel mais fino que cabe e, se nem o mais grosso cabe,
+ * junta pontos vizinhos dele. Um dia custa o mesmo que um minuto: os pontos
+ * lidos ficam perto de `maximo_pontos` em qualquer janela. Devolve quantos
+ * pontos escreveu; *periodo_s recebe a duracao de cada um. Janelas maiores
+ * que o historico devolvem o que houver.
+ */
+size_t piramide_tendencia_ler(const piramide_tendencia_t *piramide, uint32_t janela_s, uint32_t maximo_pontos,
+                              ponto_tendencia_t *destino, uint32_t *periodo_s);
+
+static inline bool ponto_tendencia_lacuna(const ponto_tendencia_t *ponto)
+{
+    return ponto->frequencia.minimo_q16 > ponto->frequencia.maximo_q16;
+}
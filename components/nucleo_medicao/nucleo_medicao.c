@@ -0,0 +1,188 @@
+#include "nucleo_medicao.h"
+
+#include <string.h>
+
+static uint32_t saturar_u32(uint64_t valor)
+{
+    return valor > UINT32_MAX ? UINT32_MAX : (uint32_t)valor;
+}
+
+static uint32_t limitar(uint32_t valor, uint32_t minimo, uint32_t maximo)
+{
+    return valor < minimo ? minimo : valor > maximo ? maximo : valor;
+}
+
+void nucleo_medicao_inicializar(nucleo_medicao_t *nucleo, const nucleo_medicao_config_t *config)
+{
+    memset(nucleo, 0, sizeof(*nucleo));
+    nucleo->config = *config;
+    const estimador_frequencia_config_t estimador_config = {
+        .periodos_minimos = config->periodos_minimos,
+        .periodo_maximo_us = config->periodo_maximo_us,
+    };
+    estimador_frequencia_inicializar(&nucleo->estimador, &estimador_config);
+    estatisticas_curso_inicializar(&nucleo->estatisticas, config->periodo_maximo_us);
+    nucleo_medicao_definir_sessao(nucleo, &config->sessao);
+}
+
+void nucleo_medicao_definir_curso_um(nucleo_medicao_t *nucleo, uint32_t curso_um)
+{
+    atomic_store_explicit(&nucleo->curso_um, curso_um, memory_order_relaxed);
+}
+
+void nucleo_medicao_definir_sessao(nucleo_medicao_t *nucleo, const configuracao_sessao_t *sessao)
+{
+    const uint32_t pausa_ms = limitar(sessao->tempo_pausa_ms, SESSAO_PAUSA_MIN_MS, SESSAO_PAUSA_MAX_MS);
+    uint32_t encerrar_ms = limitar(sessao->tempo_encerrar_ms, SESSAO_ENCERRAR_MIN_MS, SESSAO_ENCERRAR_MAX_MS);
+    if (encerrar_ms < pausa_ms) {
+        encerrar_ms = pausa_ms;
+    }
+    atomic_store_explicit(&nucleo->tempo_pausa_ms, pausa_ms, memory_order_relaxed);
+    atomic_store_explicit(&nucleo->tempo_encerrar_ms, encerrar_ms, memory_order_relaxed);
+}
+
+static void zerar_sessao(nucleo_medicao_t *nucleo)
+{
+    estimador_frequencia_zerar(&nucleo->estimador);
+    estatisticas_curso_zerar(&nucleo->estatisticas);
+    nucleo->total_furos = 0;
+    nucleo->ultimo_pulso_us = 0;
+    nucleo->ultima_atualizacao_ms = 0;
+    nucleo->estado = SESSAO_OCIOSA;
+    nucleo->inicio_sessao_ms = 0;
+    nucleo->inicio_sinal_ms = 0;
+    nucleo->tempo_sinal_ms = 0;
+    nucleo->distancia_base_um = 0;
+    nucleo->furos_inicio_trecho = 0;
+    nucleo->frequencia_pico_q16 = 0;
+    nucleo->periodos_ativos = 0;
+}
+
+uint32_t nucleo_medicao_registrar_borda(nucleo_medicao_t *nucleo, int64_t borda_us)
+{
+    if (nucleo->estado == SESSAO_ENCERRADA) {
+        /* Os totais anteriores ja viraram resumo: a borda abre outra sessao */
+        zerar_sessao(nucleo);
+    }
+    uint32_t periodo_us = 0;
+    if (nucleo->ultimo_pulso_us > 0 && borda_us > nucleo->ultimo_pulso_us) {
+        periodo_us = saturar_u32((uint64_t)(borda_us - nucleo->ultimo_pulso_us));
+    }
+    if (nucleo->total_furos == 0) {
+        /* O primeiro trecho comeca com o curso atual, nao na primeira publicacao */
+        nucleo->curso_trecho_um = atomic_load_explicit(&nucleo->curso_um, memory_order_relaxed);
+    }
+    estimador_frequencia_registrar_borda(&nucleo->estimador, borda_us);
+    estatisticas_curso_registrar_borda(&nucleo->estatisticas, borda_us);
+    nucleo->ultimo_pulso_us = borda_us;
+    nucleo->ultima_atualizacao_ms = borda_us / 1000;
+    nucleo->total_furos++;
+    if (nucleo->estado == SESSAO_ATIVA) {
+        nucleo->periodos_ativos++;
+    } else {
+        if (nucleo->estado == SESSAO_OCIOSA) {
+            nucleo->inicio_sessao_ms = nucleo->ultima_atualizacao_ms;
+        }
+        nucleo->estado = SESSAO_ATIVA;
+        nucleo->inicio_sinal_ms = nucleo->ultima_atualizacao_ms;
+    }
+    return periodo_us;
+}
+
+static uint64_t calcular_distancia_um(nucleo_medicao_t *nucleo)
+{
+    const uint32_t curso_um = atomic_load_explicit(&nucleo->curso_um, memory_order_relaxed);
+    if (curso_um != nucleo->curso_trecho_um) {
+        nucleo->distancia_base_um += (uint64_t)(nucleo->total_furos - nucleo->furos_inicio_trecho) * nucleo->curso_trecho_um;
+        nucleo->furos_inicio_trecho = nucleo->total_furos;
+        nucleo->curso_trecho_um = curso_um;
+    }
+    return nucleo->distancia_base_um +
+           (uint64_t)(nucleo->total_furos - nucleo->furos_inicio_trecho) * nucleo->curso_trecho_um;
+}
+
+/* Resumo a partir dos acumuladores da sessao; nada e recalculado do zero */
+static void encerrar_sessao(nucleo_medicao_t *nucleo, uint64_t distancia_um)
+{
+    resumo_sessao_t *resumo = &nucleo->resumo;
+    memset(resumo, 0, sizeof(*resumo));
+    resumo->duracao_ms = saturar_u32((uint64_t)(nucleo->ultima_atualizacao_ms - nucleo->inicio_sessao_ms));
+    resumo->tempo_ativo_ms = saturar_u32(nucleo->tempo_sinal_ms);
+    resumo->furos = nucleo->total_furos;
+    if (nucleo->tempo_sinal_ms > 0) {
+        /* periodos (< 2^32) x 60000 x 2^16 cabe em 64 bits: sem ponto flutuante no encerramento */
+        const uint64_t periodos_q16_min = (uint64_t)nucleo->periodos_ativos * (60000U * Q16_UM);
+        resumo->rpm_medio_q16 =
+            saturar_u32((periodos_q16_min + nucleo->tempo_sinal_ms / 2U) / nucleo->tempo_sinal_ms);
+    }
+    resumo->rpm_pico_q16 = saturar_u32((uint64_t)nucleo->frequencia_pico_q16 * 60U);
+    resumo->distancia_um = distancia_um;
+    nucleo->estado = SESSAO_ENCERRADA;
+    nucleo->resumo_pendente = true;
+}
+
+bool nucleo_medicao_publicar(nucleo_medicao_t *nucleo, dados_medidos_t *medicao)
+{
+    const int64_t agora_ms = nucleo->config.relogio(nucleo->config.contexto_relogio) / 1000;
+    uint32_t frequencia_q16 = estimador_frequencia_fechar_janela(&nucleo->estimador);
+    const int64_t sem_bordas_ms = agora_ms - nucleo->ultima_atualizacao_ms;
+
+    if (nucleo->estado == SESSAO_ATIVA &&
+        sem_bordas_ms > atomic_load_explicit(&nucleo->tempo_pausa_ms, memory_order_relaxed)) {
+        nucleo->estado = SESSAO_PAUSADA;
+        estimador_frequencia_zerar(&nucleo->estimador);
+        /* O trecho ativo termina na ultima borda, nao quando a pausa foi percebida */
+        nucleo->tempo_sinal_ms += (uint64_t)(nucleo->ultima_atualizacao_ms - nucleo->inicio_sinal_ms);
+        nucleo->inicio_sinal_ms = 0;
+        frequencia_q16 = 0;
+    }
+    const uint64_t distancia_um = calcular_distancia_um(nucleo);
+    if (nucleo->estado == SESSAO_PAUSADA &&
+        sem_bordas_ms > atomic_load_explicit(&nucleo->tempo_encerrar_ms, memory_order_relaxed)) {
+        encerrar_sessao(nucleo, distancia_um);
+    }
+    if (nucleo->estado == SESSAO_ATIVA && frequencia_q16 > nucleo->frequencia_pico_q16) {
+        nucleo->frequencia_pico_q16 = frequencia_q16;
+    }
+
+    uint64_t tempo_total_ms = nucleo->tempo_sinal_ms;
+    if (nucleo->estado == SESSAO_ATIVA && agora_ms > nucleo->inicio_sinal_ms) {
+        tempo_total_ms += (uint64_t)(agora_ms - nucleo->inicio_sinal_ms);
+    }
+
+    memset(medicao, 0, sizeof(*medicao));
+    medicao->frequencia_q16 = frequencia_q16;
+    medicao->rpm_q16 = saturar_u32((uint64_t)frequencia_q16 * 60U);
+    medicao->velocidade_q16 = saturar_u32(((uint64_t)frequencia_q16 * nucleo->curso_trecho_um) / UM_POR_CM);
+    medicao->distancia_um = distancia_um;
+    medicao->furos = nucleo->total_furos;
+    medicao->tempo_sinal_ms = tempo_total_ms;
+    medicao->estado_sessao = (uint8_t)nucleo->estado;
+    estatisticas_curso_resumir(&nucleo->estatisticas, &medicao->periodos);
+    return nucleo->estado == SESSAO_ATIVA;
+}
+
+uint32_t nucleo_medicao_prazo_ms(nucleo_medicao_t *nucleo)
+{
+    int64_t limite_ms;
+    if (nucleo->estado == SESSAO_ATIVA) {
+        limite_ms = atomic_load_explicit(&nucleo->tempo_pausa_ms, memory_order_relaxed);
+    } else if (nucleo->estado == SESSAO_PAUSADA) {
+        limite_ms = atomic_load_explicit(&nucleo->tempo_encerrar_ms, memory_order_relaxed);
+    } else {
+        return UINT32_MAX;
+    }
+    const int64_t agora_ms = nucleo->config.relogio(nucleo->config.contexto_relogio) / 1000;
+    const int64_t prazo = nucleo->ultima_atualizacao_ms + limite_ms + 1 - agora_ms;
+    return prazo > 0 ? (uint32_t)prazo : 0;
+}
+
+bool nucleo_medicao_retirar_resumo(nucleo_medicao_t *nucleo, resumo_sessao_t *resumo)
+{
+    if (!nucleo->resumo_pendente) {
+        return false;
+    }
+    *resumo = nucleo->resumo;
+    nucleo->resumo_pendente = false;
+    return true;
+}
@@ -0,0 +1,285 @@
+#include "piramide_tendencia.h"
+
+#include <string.h>
+
+#define METRICAS 2   /* frequencia, velocidade */
+#define MS_POR_S 1000
+
+static const uint32_t s_periodos_s[PIRAMIDE_TENDENCIA_NIVEIS] = {1U, 10U, 60U};
+
+static const ponto_tendencia_t s_lacuna = {
+    .frequencia = {.minimo_q16 = UINT32_MAX, .maximo_q16 = 0, .media_q16 = 0},
+    .velocidade = {.minimo_q16 = UINT32_MAX, .maximo_q16 = 0, .media_q16 = 0},
+};
+
+uint32_t piramide_tendencia_periodo_s(uint8_t nivel)
+{
+    return nivel < PIRAMIDE_TENDENCIA_NIVEIS ? s_periodos_s[nivel] : 0;
+}
+
+uint32_t piramide_tendencia_capacidade(uint8_t nivel, uint32_t duracao_s)
+{
+    const uint32_t periodo_s = piramide_tendencia_periodo_s(nivel);
+    return periodo_s ? (duracao_s + periodo_s - 1U) / periodo_s : 0;
+}
+
+static void zerar_acumulador(acumulador_tendencia_t *acumulador)
+{
+    for (size_t i = 0; i < METRICAS; i++) {
+        acumulador->minimo_q16[i] = UINT32_MAX;
+        acumulador->maximo_q16[i] = 0;
+        acumulador->soma_q16[i] = 0;
+    }
+    acumulador->peso = 0;
+}
+
+static void acumular(acumulador_tendencia_t *acumulador, const uint32_t minimo[METRICAS],
+                     const uint32_t maximo[METRICAS], const uint32_t media[METRICAS], uint32_t peso)
+{
+    for (size_t i = 0; i < METRICAS; i++) {
+        if (minimo[i] < acumulador->minimo_q16[i]) {
+            acumulador->minimo_q16[i] = minimo[i];
+        }
+        if (maximo[i] > acumulador->maximo_q16[i]) {
+            acumulador->maximo_q16[i] = maximo[i];
+        }
+        acumulador->soma_q16[i] += (uint64_t)media[i] * peso;
+    }
+    acumulador->peso += peso;
+}
+
+/* Media dos periodos de baixo com peso igual: media no tempo, nao por publicacao */
+static void acumular_ponto(acumulador_tendencia_t *acumulador, const ponto_tendencia_t *ponto)
+{
+    const uint32_t minimo[METRICAS] = {ponto->frequencia.minimo_q16, ponto->velocidade.minimo_q16};
+    const uint32_t maximo[METRICAS] = {ponto->frequencia.maximo_q16, ponto->velocidade.maximo_q16};
+    const uint32_t media[METRICAS] = {ponto->frequencia.media_q16, ponto->velocidade.media_q16};
+    acumular(acumulador, minimo, maximo, media, 1U);
+}
+
+static ponto_tendencia_t resultado(const acumulador_tendencia_t *acumulador)
+{
+    if (acumulador->peso == 0) {
+        return s_lacuna;
+    }
+    faixa_tendencia_t faixas[METRICAS];
+    for (size_t i = 0; i < METRICAS; i++) {
+        faixas[i] = (faixa_tendencia_t){
+            .minimo_q16 = acumulador->minimo_q16[i],
+            .maximo_q16 = acumulador->maximo_q16[i],
+            .media_q16 = (uint32_t)(acumulador->soma_q16[i] / acumulador->peso),
+        };
+    }
+    return (ponto_tendencia_t){.frequencia = faixas[0], .velocidade = faixas[1]};
+}
+
+static void empilhar(nivel_tendencia_t *nivel, const ponto_tendencia_t *ponto)
+{
+    nivel->registros[nivel->proximo] =
+        (registro_tendencia_t){.ponto = *ponto, .periodo = (uint32_t)nivel->periodo_aberto};
+    nivel->proximo = nivel->proximo + 1U == nivel->capacidade ? 0 : nivel->proximo + 1U;
+    if (nivel->total < nivel->capacidade) {
+        nivel->total++;
+    }
+}
+
+static void avancar_nivel(piramide_tendencia_t *piramide, uint8_t indice, int64_t periodo);
+
+/* Fecha o periodo aberto do nivel e o entrega ao acumulador do nivel de cima; lacuna nao ocupa o anel */
+static void fechar_periodo(piramide_tendencia_t *piramide, uint8_t indice)
+{
+    nivel_tendencia_t *nivel = &piramide->niveis[indice];
+    const ponto_tendencia_t ponto = resultado(&nivel->acumulador);
+    if (ponto_tendencia_lacuna(&ponto)) {
+        return;
+    }
+    empilhar(nivel, &ponto);
+    if (indice + 1U < PIRAMIDE_TENDENCIA_NIVEIS) {
+        nivel_tendencia_t *acima = &piramide->niveis[indice + 1U];
+        const int64_t inicio_s = nivel->periodo_aberto * nivel->periodo_s;
+        avancar_nivel(piramide, indice + 1U, inicio_s / acima->periodo_s);
+        acumular_ponto(&acima->acumulador, &ponto);
+    }
+}
+
+static void avancar_nivel(piramide_tendencia_t *piramide, uint8_t indice, int64_t periodo)
+{
+    nivel_tendencia_t *nivel = &piramide->niveis[indice];
+    if (periodo <= nivel->periodo_aberto) {
+        return;
+    }
+    fechar_periodo(piramide, indice);
+    /* Os periodos pulados ficam sem registro: a leitura os ve como lacuna */
+    nivel->periodo_aberto = periodo;
+    zerar_acumulador(&nivel->acumulador);
+}
+
+/*
+ * Conta no nivel de 1 s o tempo em que a ultima amostra valeu, ate `ate_ms`,
+ * cortado nos limites de segundo. A retencao nao passa de um periodo, entao
+ * sao no maximo dois trechos.
+ */
+static void contar_retido(piramide_tendencia_t *piramide, int64_t ate_ms)
+{
+    nivel_tendencia_t *nivel = &piramide->niveis[0];
+    const int64_t fim_ms = ate_ms < piramide->retido_ate_ms ? ate_ms : piramide->retido_ate_ms;
+    while (piramide->contado_ate_ms < fim_ms) {
+        const int64_t periodo = piramide->contado_ate_ms / MS_POR_S;
+        const int64_t limite_ms = (periodo + 1) * MS_POR_S < fim_ms ? (periodo + 1) * MS_POR_S : fim_ms;
+        avancar_nivel(piramide, 0, periodo);
+        acumular(&nivel->acumulador, piramide->retido_q16, piramide->retido_q16, piramide->retido_q16,
+                 (uint32_t)(limite_ms - piramide->contado_ate_ms));
+        piramide->contado_ate_ms = limite_ms;
+    }
+    if (ate_ms > piramide->contado_ate_ms) {
+        piramide->contado_ate_ms = ate_ms;
+    }
+}
+
+void piramide_tendencia_inicializar(piramide_tendencia_t *piramide,
+                                    registro_tendencia_t *memoria[PIRAMIDE_TENDENCIA_NIVEIS], uint32_t duracao_s)
+{
+    memset(piramide, 0, sizeof(*piramide));
+    for (uint8_t i = 0; i < PIRAMIDE_TENDENCIA_NIVEIS; i++) {
+        nivel_tendencia_t *nivel = &piramide->niveis[i];
+        nivel->registros = memoria[i];
+        nivel->capacidade = piramide_tendencia_capacidade(i, duracao_s);
+        nivel->periodo_s = s_periodos_s[i];
+        zerar_acumulador(&nivel->acumulador);
+    }
+}
+
+static void iniciar(piramide_tendencia_t *piramide, int64_t agora_ms)
+{
+    for (uint8_t i = 0; i < PIRAMIDE_TENDENCIA_NIVEIS; i++) {
+        nivel_tendencia_t *nivel = &piramide->niveis[i];
+        nivel->periodo_inicial = agora_ms / MS_POR_S / nivel->periodo_s;
+        nivel->periodo_aberto = nivel->periodo_inicial;
+    }
+    piramide->contado_ate_ms = agora_ms;
+    piramide->retido_ate_ms = agora_ms;
+    piramide->iniciada = true;
+}
+
+void piramide_tendencia_avancar(piramide_tendencia_t *piramide, int64_t agora_ms)
+{
+    if (!piramide->iniciada) {
+        return;
+    }
+    contar_retido(piramide, agora_ms);
+    const int64_t agora_s = agora_ms / MS_POR_S;
+    /* De baixo para cima: o periodo fechado embaixo ainda cai no periodo certo de cima */
+    for (uint8_t i = 0; i < PIRAMIDE_TENDENCIA_NIVEIS; i++) {
+        avancar_nivel(piramide, i, agora_s / piramide->niveis[i].periodo_s);
+    }
+}
+
+void piramide_tendencia_registrar(piramide_tendencia_t *piramide, int64_t agora_ms, uint32_t frequencia_q16,
+                                  uint32_t velocidade_q16)
+{
+    if (!piramide->iniciada) {
+        iniciar(piramide, agora_ms);
+    }
+    /* A amostra anterior vale ate esta; uma amostra atrasada nao reabre tempo ja contado */
+    contar_retido(piramide, agora_ms);
+    piramide->retido_q16[0] = frequencia_q16;
+    piramide->retido_q16[1] = velocidade_q16;
+    piramide->retido_ate_ms = piramide->contado_ate_ms + PIRAMIDE_TENDENCIA_RETENCAO_MS;
+}
+
+/* Registro `atras` posicoes antes do mais novo (0 = mais novo) */
+static const registro_tendencia_t *registro_recente(const nivel_tendencia_t *nivel, uint32_t atras)
+{
+    const uint32_t indice = (nivel->proximo + nivel->capacidade - 1U - atras) % nivel->capacidade;
+    return &nivel->registros[indice];
+}
+
+/*
+ * Ponto do `periodo`, ou NULL se ele foi lacuna. Os periodos pedidos descem
+ * e *lidos guarda ate onde o anel ja foi percorrido: uma leitura anda cada
+ * registro uma vez so.
+ */
+static const ponto_tendencia_t *buscar_periodo(const nivel_tendencia_t *nivel, uint32_t *lidos, uint32_t periodo)
+{
+    while (*lidos < nivel->total) {
+        const registro_tendencia_t *registro = registro_recente(nivel, *lidos);
+        const int32_t distancia = (int32_t)(registro->periodo - periodo);
+        if (distancia <= 0) {
+            return distancia == 0 ? &registro->ponto : NULL;
+        }
+        (*lidos)++;
+    }
+    return NULL;
+}
+
+static void juntar(ponto_tendencia_t *destino, const ponto_tendencia_t *ponto, uint32_t *juntados)
+{
+    if (ponto_tendencia_lacuna(ponto)) {
+        return;
+    }
+    faixa_tendencia_t *faixas[METRICAS] = {&destino->frequencia, &destino->velocidade};
+    const faixa_tendencia_t *origem[METRICAS] = {&ponto->frequencia, &ponto->velocidade};
+    for (size_t i = 0; i < METRICAS; i++) {
+        if (origem[i]->minimo_q16 < faixas[i]->minimo_q16) {
+            faixas[i]->minimo_q16 = origem[i]->minimo_q16;
+        }
+        if (origem[i]->maximo_q16 > faixas[i]->maximo_q16) {
+            faixas[i]->maximo_q16 = origem[i]->maximo_q16;
+        }
+        /* Media incremental: evita uma soma separada por ponto de saida */
+        const int64_t diferenca = (int64_t)origem[i]->media_q16 - faixas[i]->media_q16;
+        faixas[i]->media_q16 = (uint32_t)((int64_t)faixas[i]->media_q16 + diferenca / (int64_t)(*juntados + 1U));
+    }
+    (*juntados)++;
+}
+
+size_t piramide_tendencia_ler(const piramide_tendencia_t *piramide, uint32_t janela_s, uint32_t maximo_pontos,
+                              ponto_tendencia_t *destino, uint32_t *periodo_s)
+{
+    if (maximo_pontos == 0 || janela_s == 0) {
+        return 0;
+    }
+    uint8_t indice = 0;
+    while (indice + 1U < PIRAMIDE_TENDENCIA_NIVEIS &&
+           piramide_tendencia_capacidade(indice, janela_s) > maximo_pontos) {
+        indice++;
+    }
+    const nivel_tendencia_t *nivel = &piramide->niveis[indice];
+    /* Periodos fechados desde o inicio, com ou sem registro */
+    const int64_t fechados = piramide->iniciada ? nivel->periodo_aberto - nivel->periodo_inicial : 0;
+    uint32_t pontos = piramide_tendencia_capacidade(indice, janela_s);
+    if (pontos > nivel->capacidade) {
+        pontos = nivel->capacidade;
+    }
+    if ((int64_t)pontos > fechados) {
+        pontos = (uint32_t)fechados;
+    }
+    const uint32_t grupo = (pontos + maximo_pontos - 1U) / maximo_pontos;
+    if (periodo_s) {
+        *periodo_s = nivel->periodo_s * (grupo ? grupo : 1U);
+    }
+    if (pontos == 0) {
+        return 0;
+    }
+
+    /* Grupos alinhados ao ponto mais novo; o mais antigo pode sair incompleto */
+    const uint32_t saida = (pontos + grupo - 1U) / grupo;
+    const uint32_t ultimo = (uint32_t)(nivel->periodo_aberto - 1);
+    uint32_t lidos = 0;
+    for (uint32_t s = 0; s < saida; s++) {
+        ponto_tendencia_t *ponto = &destino[saida - 1U - s];
+        *ponto = s_lacuna;
+        uint32_t juntados = 0;
+        for (uint32_t g = 0; g < grupo; g++) {
+            const uint32_t atras = s * grupo + g;
+            if (atras >= pontos) {
+                break;
+            }
+            const ponto_tendencia_t *origem = buscar_periodo(nivel, &lidos, ultimo - atras);
+            if (origem) {
+                juntar(ponto, origem, &juntados);
+            }
+        }
+    }
+    return saida;
+}
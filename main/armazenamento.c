@@ -7,6 +7,8 @@
 static const char *TAG = "armazenamento";
 static const char *ESPACO = "cfg";
 static const char *CHAVE_CURSO = "curso";
+static const char *CHAVE_PAUSA = "pausa_ms";
+static const char *CHAVE_ENCERRAR = "encerrar_ms";
 
 static void aplicar_limites_curso(configuracao_curso_t *config)
 {
@@ -64,3 +66,46 @@ esp_err_t armazenamento_salvar_curso(const configuracao_curso_t *config)
     nvs_close(handle);
     return err;
 }
+
+esp_err_t armazenamento_carregar_sessao(configuracao_sessao_t *sessao)
+{
+    if (!sessao) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    sessao->tempo_pausa_ms = SESSAO_PAUSA_PADRAO_MS;
+    sessao->tempo_encerrar_ms = SESSAO_ENCERRAR_PADRAO_MS;
+
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(ESPACO, NVS_READONLY, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Falha ao abrir NVS (%s), usando tempos de sessao padrao", esp_err_to_name(err));
+        return err;
+    }
+    /* Chaves ausentes mantem o padrao; os limites sao aplicados pelo nucleo */
+    nvs_get_u32(handle, CHAVE_PAUSA, &sessao->tempo_pausa_ms);
+    nvs_get_u32(handle, CHAVE_ENCERRAR, &sessao->tempo_encerrar_ms);
+    nvs_close(handle);
+    return ESP_OK;
+}
+
+esp_err_t armazenamento_salvar_sessao(const configuracao_sessao_t *sessao)
+{
+    if (!sessao) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(ESPACO, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "NVS indisponivel (%s)", esp_err_to_name(err));
+        return err;
+    }
+    err = nvs_set_u32(handle, CHAVE_PAUSA, sessao->tempo_pausa_ms);
+    if (err == ESP_OK) {
+        err = nvs_set_u32(handle, CHAVE_ENCERRAR, sessao->tempo_encerrar_ms);
+    }
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    return err;
+}
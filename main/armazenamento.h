@@ -5,3 +5,5 @@
 
 esp_err_t armazenamento_inicializar(configuracao_curso_t *config);
 esp_err_t armazenamento_salvar_curso(const configuracao_curso_t *config);
+esp_err_t armazenamento_carregar_sessao(configuracao_sessao_t *sessao);
+esp_err_t armazenamento_salvar_sessao(const configuracao_sessao_t *sessao);
@@ -0,0 +1,129 @@
+#include "codec_gravador.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#define CABECALHO_BYTES sizeof(codec_gravador_cabecalho_t)
+
+static const uint32_t s_crc_nibble[16] = {
+    0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU, 0x76DC4190U, 0x6B6B51F4U, 0x4DB26158U, 0x5005713CU,
+    0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU, 0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU,
+};
+
+uint32_t codec_gravador_crc32(uint32_t crc, const uint8_t *dados, size_t tamanho)
+{
+    crc = ~crc;
+    for (size_t i = 0; i < tamanho; i++) {
+        crc ^= dados[i];
+        crc = (crc >> 4) ^ s_crc_nibble[crc & 0x0FU];
+        crc = (crc >> 4) ^ s_crc_nibble[crc & 0x0FU];
+    }
+    return ~crc;
+}
+
+static uint64_t zigzag(int64_t valor)
+{
+    return ((uint64_t)valor << 1) ^ (uint64_t)(valor >> 63);
+}
+
+static int64_t dezigzag(uint64_t valor)
+{
+    return (int64_t)(valor >> 1) ^ -(int64_t)(valor & 1U);
+}
+
+void codec_gravador_iniciar_bloco(codec_gravador_t *codec)
+{
+    memset(codec->bloco, 0xFF, sizeof(codec->bloco));
+    codec->usado = CABECALHO_BYTES;
+    codec->quantidade = 0;
+    codec->anterior = 0;
+}
+
+bool codec_gravador_vazio(const codec_gravador_t *codec)
+{
+    return codec->quantidade == 0;
+}
+
+bool codec_gravador_adicionar(codec_gravador_t *codec, uint32_t periodo_us)
+{
+    if (codec->quantidade >= UINT16_MAX ||
+        codec->usado + CODEC_GRAVADOR_VARINT_MAX > CODEC_GRAVADOR_BLOCO_BYTES) {
+        return false;
+    }
+    /* Delta de dois uint32 cabe em 33 bits com sinal: no maximo 5 bytes de varint */
+    uint64_t valor = zigzag((int64_t)periodo_us - (int64_t)codec->anterior);
+    while (valor >= 0x80U) {
+        codec->bloco[codec->usado++] = (uint8_t)(valor | 0x80U);
+        valor >>= 7;
+    }
+    codec->bloco[codec->usado++] = (uint8_t)valor;
+    codec->anterior = periodo_us;
+    codec->quantidade++;
+    return true;
+}
+
+const uint8_t *codec_gravador_fechar_bloco(codec_gravador_t *codec, uint32_t sequencia)
+{
+    const codec_gravador_cabecalho_t cabecalho = {
+        .magico = CODEC_GRAVADOR_MAGICO,
+        .sequencia = sequencia,
+        .versao = CODEC_GRAVADOR_VERSAO,
+        .quantidade = (uint16_t)codec->quantidade,
+        .bytes_dados = (uint16_t)(codec->usado - CABECALHO_BYTES),
+        .reservado = 0,
+        .crc32 = 0,
+    };
+    memcpy(codec->bloco, &cabecalho, CABECALHO_BYTES);
+    const uint32_t crc = codec_gravador_crc32(0, codec->bloco, codec->usado);
+    memcpy(codec->bloco + offsetof(codec_gravador_cabecalho_t, crc32), &crc, sizeof(crc));
+    return codec->bloco;
+}
+
+bool codec_gravador_validar(const uint8_t *bloco, codec_gravador_cabecalho_t *cabecalho)
+{
+    codec_gravador_cabecalho_t lido;
+    memcpy(&lido, bloco, CABECALHO_BYTES);
+    if (lido.magico != CODEC_GRAVADOR_MAGICO || lido.versao != CODEC_GRAVADOR_VERSAO ||
+        lido.bytes_dados > CODEC_GRAVADOR_DADOS_BYTES) {
+        return false;
+    }
+    codec_gravador_cabecalho_t zerado = lido;
+    zerado.crc32 = 0;
+    uint32_t crc = codec_gravador_crc32(0, (const uint8_t *)&zerado, CABECALHO_BYTES);
+    crc = codec_gravador_crc32(crc, bloco + CABECALHO_BYTES, lido.bytes_dados);
+    if (crc != lido.crc32) {
+        return false;
+    }
+    if (cabecalho) {
+        *cabecalho = lido;
+    }
+    return true;
+}
+
+int codec_gravador_decodificar(const uint8_t *bloco, uint32_t *destino, size_t max)
+{
+    codec_gravador_cabecalho_t cabecalho;
+    if (!codec_gravador_validar(bloco, &cabecalho)) {
+        return -1;
+    }
+    const uint8_t *dados = bloco + CABECALHO_BYTES;
+    const uint8_t *fim = dados + cabecalho.bytes_dados;
+    uint32_t anterior = 0;
+    size_t escritos = 0;
+    for (uint32_t i = 0; i < cabecalho.quantidade && escritos < max; i++) {
+        uint64_t valor = 0;
+        unsigned deslocamento = 0;
+        uint8_t byte;
+        do {
+            if (dados >= fim || deslocamento > 7U * (CODEC_GRAVADOR_VARINT_MAX - 1U)) {
+                return -1;
+            }
+            byte = *dados++;
+            valor |= (uint64_t)(byte & 0x7FU) << deslocamento;
+            deslocamento += 7;
+        } while (byte & 0x80U);
+        anterior = (uint32_t)((int64_t)anterior + dezigzag(valor));
+        destino[escritos++] = anterior;
+    }
+    return (int)escritos;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Formato dos blocos do gravador de sessao. Cada bloco ocupa um setor de
+ * flash e e decodificavel sozinho: cabecalho fixo seguido de periodos (us)
+ * codificados como delta em relacao ao anterior, zig-zag e varint LEB128.
+ * O primeiro periodo do bloco e delta contra zero. Bytes livres ficam 0xFF
+ * (estado apagado), entao um bloco e escrito uma unica vez apos o erase.
+ * Sem dependencia de plataforma: usado no firmware e nas ferramentas de host.
+ */
+#define CODEC_GRAVADOR_BLOCO_BYTES   4096U
+#define CODEC_GRAVADOR_MAGICO        0x56415247U   /* "GRAV" */
+#define CODEC_GRAVADOR_VERSAO        1U
+#define CODEC_GRAVADOR_VARINT_MAX    5U
+
+typedef struct __attribute__((packed)) {
+    uint32_t magico;
+    uint32_t sequencia;       /* cresce a cada bloco; o maior e o mais recente */
+    uint16_t versao;
+    uint16_t quantidade;      /* periodos no bloco */
+    uint16_t bytes_dados;
+    uint16_t reservado;
+    uint32_t crc32;           /* CRC-32 (IEEE) do cabecalho com crc32 = 0 mais os dados */
+} codec_gravador_cabecalho_t;
+
+#define CODEC_GRAVADOR_DADOS_BYTES   (CODEC_GRAVADOR_BLOCO_BYTES - sizeof(codec_gravador_cabecalho_t))
+
+typedef struct {
+    uint8_t bloco[CODEC_GRAVADOR_BLOCO_BYTES];
+    size_t usado;
+    uint32_t quantidade;
+    uint32_t anterior;
+} codec_gravador_t;
+
+void codec_gravador_iniciar_bloco(codec_gravador_t *codec);
+/* Retorna false quando o periodo nao cabe mais: feche o bloco e comece outro. */
+bool codec_gravador_adicionar(codec_gravador_t *codec, uint32_t periodo_us);
+bool codec_gravador_vazio(const codec_gravador_t *codec);
+/* Preenche cabecalho e CRC; o bloco fica pronto para gravar em codec->bloco. */
+const uint8_t *codec_gravador_fechar_bloco(codec_gravador_t *codec, uint32_t sequencia);
+
+/* Valida o bloco; retorna false se apagado, corrompido ou de outra versao. */
+bool codec_gravador_validar(const uint8_t *bloco, codec_gravador_cabecalho_t *cabecalho);
+/* Decodifica ate max periodos; retorna quantos foram escritos ou -1 se o bloco for invalido. */
+int codec_gravador_decodificar(const uint8_t *bloco, uint32_t *destino, size_t max);
+
+uint32_t codec_gravador_crc32(uint32_t crc, const uint8_t *dados, size_t tamanho);
@@ -0,0 +1,270 @@
+#include "codec_telemetria.h"
+
+#include <string.h>
+
+#include "codec_gravador.h"
+
+#define MEDICAO_BYTES 60U
+
+static uint8_t *escrever_u16(uint8_t *destino, uint16_t valor)
+{
+    destino[0] = (uint8_t)valor;
+    destino[1] = (uint8_t)(valor >> 8);
+    return destino + 2;
+}
+
+static uint8_t *escrever_u32(uint8_t *destino, uint32_t valor)
+{
+    for (size_t i = 0; i < 4; i++) {
+        destino[i] = (uint8_t)(valor >> (8 * i));
+    }
+    return destino + 4;
+}
+
+static uint8_t *escrever_u64(uint8_t *destino, uint64_t valor)
+{
+    for (size_t i = 0; i < 8; i++) {
+        destino[i] = (uint8_t)(valor >> (8 * i));
+    }
+    return destino + 8;
+}
+
+static uint16_t ler_u16(const uint8_t *origem)
+{
+    return (uint16_t)(origem[0] | (origem[1] << 8));
+}
+
+static uint32_t ler_u32(const uint8_t *origem)
+{
+    uint32_t valor = 0;
+    for (size_t i = 0; i < 4; i++) {
+        valor |= (uint32_t)origem[i] << (8 * i);
+    }
+    return valor;
+}
+
+static uint64_t ler_u64(const uint8_t *origem)
+{
+    uint64_t valor = 0;
+    for (size_t i = 0; i < 8; i++) {
+        valor |= (uint64_t)origem[i] << (8 * i);
+    }
+    return valor;
+}
+
+/* COBS: cada zero vira a distancia ate o proximo; o quadro sai sem zeros e ganha o delimitador */
+static size_t cobs_codificar(const uint8_t *pacote, size_t tamanho, uint8_t *quadro)
+{
+    size_t escrito = 1;
+    size_t posicao_codigo = 0;
+    uint8_t codigo = 1;
+    for (size_t i = 0; i < tamanho; i++) {
+        if (pacote[i] == 0) {
+            quadro[posicao_codigo] = codigo;
+            posicao_codigo = escrito++;
+            codigo = 1;
+            continue;
+        }
+        quadro[escrito++] = pacote[i];
+        if (++codigo == 0xFF) {
+            quadro[posicao_codigo] = codigo;
+            posicao_codigo = escrito++;
+            codigo = 1;
+        }
+    }
+    quadro[posicao_codigo] = codigo;
+    quadro[escrito++] = 0;
+    return escrito;
+}
+
+/* Decodifica no proprio buffer (a saida nunca passa da entrada); retorna 0 se malformado */
+static size_t cobs_decodificar(uint8_t *dados, size_t tamanho)
+{
+    size_t lido = 0;
+    size_t escrito = 0;
+    while (lido < tamanho) {
+        const uint8_t codigo = dados[lido++];
+        if (codigo == 0 || lido + codigo - 1U > tamanho) {
+            return 0;
+        }
+        for (uint8_t i = 1; i < codigo; i++) {
+            dados[escrito++] = dados[lido++];
+        }
+        if (codigo != 0xFF && lido < tamanho) {
+            dados[escrito++] = 0;
+        }
+    }
+    return escrito;
+}
+
+static size_t fechar_pacote(uint8_t *pacote, uint8_t *fim, uint8_t quadro[CODEC_TELEMETRIA_QUADRO_MAX])
+{
+    const uint32_t crc = codec_gravador_crc32(0, pacote, (size_t)(fim - pacote));
+    fim = escrever_u32(fim, crc);
+    return cobs_codificar(pacote, (size_t)(fim - pacote), quadro);
+}
+
+static uint8_t *escrever_cabecalho(uint8_t *destino, telemetria_tipo_t tipo, uint8_t canal, uint16_t sequencia)
+{
+    destino[0] = (uint8_t)tipo;
+    destino[1] = canal;
+    return escrever_u16(destino + 2, sequencia);
+}
+
+size_t codec_telemetria_bordas(uint8_t canal, uint16_t sequencia, const int64_t *bordas_us, size_t quantidade,
+                               uint8_t quadro[CODEC_TELEMETRIA_QUADRO_MAX])
+{
+    if (!bordas_us || quantidade == 0 || quantidade > CODEC_TELEMETRIA_BORDAS_MAX) {
+        return 0;
+    }
+    uint8_t pacote[CODEC_TELEMETRIA_PACOTE_MAX];
+    uint8_t *cursor = escrever_cabecalho(pacote, TELEMETRIA_BORDAS, canal, sequencia);
+    *cursor++ = (uint8_t)quantidade;
+    cursor = escrever_u64(cursor, (uint64_t)bordas_us[0]);
+    for (size_t i = 1; i < quantidade; i++) {
+        /* Bordas da fila sao crescentes: delta sem sinal, 2 bytes tipicos ate 16 ms */
+        uint64_t delta = (uint64_t)(bordas_us[i] - bordas_us[i - 1]);
+        while (delta >= 0x80U) {
+            *cursor++ = (uint8_t)(delta | 0x80U);
+            delta >>= 7;
+        }
+        *cursor++ = (uint8_t)delta;
+    }
+    return fechar_pacote(pacote, cursor, quadro);
+}
+
+size_t codec_telemetria_medicao(uint8_t canal, uint16_t sequencia, const telemetria_medicao_t *medicao,
+                                uint8_t quadro[CODEC_TELEMETRIA_QUADRO_MAX])
+{
+    if (!medicao) {
+        return 0;
+    }
+    const dados_medidos_t *dados = &medicao->dados;
+    uint8_t pacote[CODEC_TELEMETRIA_CABECALHO + MEDICAO_BYTES + CODEC_TELEMETRIA_CRC];
+    uint8_t *cursor = escrever_cabecalho(pacote, TELEMETRIA_MEDICAO, canal, sequencia);
+    cursor = escrever_u32(cursor, medicao->versao);
+    cursor = escrever_u32(cursor, dados->frequencia_q16);
+    cursor = escrever_u32(cursor, dados->rpm_q16);
+    cursor = escrever_u32(cursor, dados->velocidade_q16);
+    cursor = escrever_u64(cursor, dados->distancia_um);
+    cursor = escrever_u32(cursor, dados->furos);
+    cursor = escrever_u64(cursor, dados->tempo_sinal_ms);
+    cursor = escrever_u32(cursor, dados->periodos.amostras);
+    cursor = escrever_u32(cursor, dados->periodos.periodo_medio_us);
+    cursor = escrever_u32(cursor, dados->periodos.desvio_padrao_us);
+    cursor = escrever_u32(cursor, dados->periodos.minimo_janela_us);
+    cursor = escrever_u32(cursor, dados->periodos.maximo_janela_us);
+    cursor = escrever_u32(cursor, medicao->bordas_descartadas);
+    return fechar_pacote(pacote, cursor, quadro);
+}
+
+static bool ler_bordas(const uint8_t *carga, size_t tamanho, telemetria_pacote_t *pacote)
+{
+    if (tamanho < 9U || carga[0] == 0 || carga[0] > CODEC_TELEMETRIA_BORDAS_MAX) {
+        return false;
+    }
+    const uint32_t quantidade = carga[0];
+    pacote->bordas.quantidade = quantidade;
+    pacote->bordas.bordas_us[0] = (int64_t)ler_u64(carga + 1);
+    size_t lido = 9U;
+    for (uint32_t i = 1; i < quantidade; i++) {
+        uint64_t delta = 0;
+        uint32_t deslocamento = 0;
+        uint8_t byte;
+        do {
+            if (lido >= tamanho || deslocamento >= 64U) {
+                return false;
+            }
+            byte = carga[lido++];
+            delta |= (uint64_t)(byte & 0x7FU) << deslocamento;
+            deslocamento += 7U;
+        } while (byte & 0x80U);
+        pacote->bordas.bordas_us[i] = pacote->bordas.bordas_us[i - 1] + (int64_t)delta;
+    }
+    return lido == tamanho;
+}
+
+static bool ler_medicao(const uint8_t *carga, size_t tamanho, telemetria_pacote_t *pacote)
+{
+    if (tamanho != MEDICAO_BYTES) {
+        return false;
+    }
+    telemetria_medicao_t *medicao = &pacote->medicao;
+    dados_medidos_t *dados = &medicao->dados;
+    medicao->versao = ler_u32(carga);
+    dados->frequencia_q16 = ler_u32(carga + 4);
+    dados->rpm_q16 = ler_u32(carga + 8);
+    dados->velocidade_q16 = ler_u32(carga + 12);
+    dados->distancia_um = ler_u64(carga + 16);
+    dados->furos = ler_u32(carga + 24);
+    dados->tempo_sinal_ms = ler_u64(carga + 28);
+    dados->periodos.amostras = ler_u32(carga + 36);
+    dados->periodos.periodo_medio_us = ler_u32(carga + 40);
+    dados->periodos.desvio_padrao_us = ler_u32(carga + 44);
+    dados->periodos.minimo_janela_us = ler_u32(carga + 48);
+    dados->periodos.maximo_janela_us = ler_u32(carga + 52);
+    medicao->bordas_descartadas = ler_u32(carga + 56);
+    return true;
+}
+
+static bool abrir_quadro(uint8_t *quadro, size_t tamanho, telemetria_pacote_t *pacote)
+{
+    const size_t bytes = cobs_decodificar(quadro, tamanho);
+    if (bytes < CODEC_TELEMETRIA_CABECALHO + CODEC_TELEMETRIA_CRC) {
+        return false;
+    }
+    const size_t sem_crc = bytes - CODEC_TELEMETRIA_CRC;
+    if (codec_gravador_crc32(0, quadro, sem_crc) != ler_u32(quadro + sem_crc)) {
+        return false;
+    }
+    pacote->tipo = quadro[0];
+    pacote->canal = quadro[1];
+    pacote->sequencia = ler_u16(quadro + 2);
+    const uint8_t *carga = quadro + CODEC_TELEMETRIA_CABECALHO;
+    const size_t tamanho_carga = sem_crc - CODEC_TELEMETRIA_CABECALHO;
+    switch (pacote->tipo) {
+    case TELEMETRIA_BORDAS:
+        return ler_bordas(carga, tamanho_carga, pacote);
+    case TELEMETRIA_MEDICAO:
+        return ler_medicao(carga, tamanho_carga, pacote);
+    default:
+        return false;
+    }
+}
+
+void codec_telemetria_leitor_inicializar(codec_telemetria_leitor_t *leitor)
+{
+    memset(leitor, 0, sizeof(*leitor));
+}
+
+void codec_telemetria_leitor_alimentar(codec_telemetria_leitor_t *leitor, const uint8_t *bytes, size_t tamanho,
+                                       codec_telemetria_pacote_cb_t ao_receber, void *contexto)
+{
+    for (size_t i = 0; i < tamanho; i++) {
+        const uint8_t byte = bytes[i];
+        if (byte != 0) {
+            if (leitor->usado < sizeof(leitor->quadro)) {
+                leitor->quadro[leitor->usado++] = byte;
+            } else {
+                leitor->descartando = true;
+            }
+            continue;
+        }
+        /* Delimitador: fecha o quadro acumulado (zeros seguidos nao contam) */
+        if (leitor->descartando) {
+            leitor->quadros_invalidos++;
+        } else if (leitor->usado > 0) {
+            telemetria_pacote_t pacote;
+            if (abrir_quadro(leitor->quadro, leitor->usado, &pacote)) {
+                leitor->quadros_validos++;
+                if (ao_receber) {
+                    ao_receber(&pacote, contexto);
+                }
+            } else {
+                leitor->quadros_invalidos++;
+            }
+        }
+        leitor->usado = 0;
+        leitor->descartando = false;
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "app_types.h"
+
+/*
+ * Formato da telemetria serial. Cada pacote e
+ *   tipo (1) | canal (1) | sequencia (2) | carga | CRC-32 (4)
+ * com inteiros little-endian e CRC-32 (IEEE) de tudo que vem antes dele. O
+ * pacote vai em COBS terminado por 0x00, entao o receptor se ressincroniza
+ * no proximo zero depois de qualquer byte perdido. A sequencia cresce a cada
+ * pacote enviado: lacunas no receptor sao pacotes perdidos no enlace.
+ * Cargas:
+ *   BORDAS:  quantidade (1) | primeira borda us (8) | deltas varint LEB128
+ *   MEDICAO: versao do barramento, dados_medidos_t campo a campo e bordas
+ *            descartadas pelo buffer do firmware (acumulado)
+ * Sem dependencia de plataforma: usado no firmware e nas ferramentas de host.
+ */
+#define CODEC_TELEMETRIA_BORDAS_MAX   64U
+#define CODEC_TELEMETRIA_VARINT_MAX   10U
+#define CODEC_TELEMETRIA_CABECALHO    4U
+#define CODEC_TELEMETRIA_CRC          4U
+#define CODEC_TELEMETRIA_PACOTE_MAX \
+    (CODEC_TELEMETRIA_CABECALHO + 1U + 8U + (CODEC_TELEMETRIA_BORDAS_MAX - 1U) * CODEC_TELEMETRIA_VARINT_MAX + \
+     CODEC_TELEMETRIA_CRC)
+/* COBS acrescenta um byte a cada 254 mais o primeiro, e o delimitador no fim */
+#define CODEC_TELEMETRIA_QUADRO_MAX   (CODEC_TELEMETRIA_PACOTE_MAX + CODEC_TELEMETRIA_PACOTE_MAX / 254U + 2U)
+
+typedef enum {
+    TELEMETRIA_BORDAS = 1,
+    TELEMETRIA_MEDICAO = 2,
+} telemetria_tipo_t;
+
+typedef struct {
+    uint32_t versao;                 /* metricas_versao() do canal */
+    dados_medidos_t dados;
+    uint32_t bordas_descartadas;
+} telemetria_medicao_t;
+
+typedef struct {
+    uint8_t tipo;
+    uint8_t canal;
+    uint16_t sequencia;
+    union {
+        struct {
+            uint32_t quantidade;
+            int64_t bordas_us[CODEC_TELEMETRIA_BORDAS_MAX];
+        } bordas;
+        telemetria_medicao_t medicao;
+    };
+} telemetria_pacote_t;
+
+/* Montam o quadro completo (COBS + 0x00) e retornam seu tamanho; 0 se invalido. */
+size_t codec_telemetria_bordas(uint8_t canal, uint16_t sequencia, const int64_t *bordas_us, size_t quantidade,
+                               uint8_t quadro[CODEC_TELEMETRIA_QUADRO_MAX]);
+size_t codec_telemetria_medicao(uint8_t canal, uint16_t sequencia, const telemetria_medicao_t *medicao,
+                                uint8_t quadro[CODEC_TELEMETRIA_QUADRO_MAX]);
+
+/* Receptor incremental: recebe bytes em qualquer fatiamento e entrega pacotes validos. */
+typedef void (*codec_telemetria_pacote_cb_t)(const telemetria_pacote_t *pacote, void *contexto);
+
+typedef struct {
+    uint8_t quadro[CODEC_TELEMETRIA_QUADRO_MAX];
+    size_t usado;
+    bool descartando;                /* quadro longo demais: ignora ate o proximo 0x00 */
+    uint32_t quadros_validos;
+    uint32_t quadros_invalidos;      /* COBS, CRC, tamanho ou tipo */
+} codec_telemetria_leitor_t;
+
+void codec_telemetria_leitor_inicializar(codec_telemetria_leitor_t *leitor);
+void codec_telemetria_leitor_alimentar(codec_telemetria_leitor_t *leitor, const uint8_t *bytes, size_t tamanho,
+                                       codec_telemetria_pacote_cb_t ao_receber, void *contexto);
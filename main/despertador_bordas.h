@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Aviso da fonte de pulsos para tarefa_metricas. A tarefa arma o despertador
+ * com o periodo que acabou de publicar; a fonte so chama despertar() quando o
+ * periodo estimado se afasta dessa referencia (ou em qualquer borda, se a
+ * referencia for 0). Depois de disparar fica desarmado ate a tarefa rearmar,
+ * entao cada publicacao custa no maximo um despertar vindo da ISR.
+ * despertar() retorna true se uma tarefa de prioridade maior foi acordada;
+ * o backend decide como ceder a CPU (portYIELD_FROM_ISR ou retorno do callback).
+ */
+typedef struct {
+    _Atomic uint32_t armado;
+    _Atomic uint32_t periodo_referencia_us;
+    uint8_t tolerancia_shift;           /* desvio aceito: referencia >> shift */
+    bool (*despertar)(void *contexto);  /* chamado no contexto da ISR */
+    void *contexto;
+} despertador_bordas_t;
+
+static inline void despertador_bordas_armar(despertador_bordas_t *despertador, uint32_t periodo_referencia_us)
+{
+    atomic_store_explicit(&despertador->periodo_referencia_us, periodo_referencia_us, memory_order_relaxed);
+    atomic_store_explicit(&despertador->armado, 1U, memory_order_release);
+}
+
+static inline void despertador_bordas_desarmar(despertador_bordas_t *despertador)
+{
+    atomic_store_explicit(&despertador->armado, 0U, memory_order_relaxed);
+}
+
+static inline __attribute__((always_inline)) bool despertador_bordas_avaliar(despertador_bordas_t *despertador,
+                                                                            uint32_t periodo_us)
+{
+    if (!despertador || !atomic_load_explicit(&despertador->armado, memory_order_acquire)) {
+        return false;
+    }
+    const uint32_t referencia = atomic_load_explicit(&despertador->periodo_referencia_us, memory_order_relaxed);
+    if (referencia != 0 && periodo_us != 0) {
+        const uint32_t desvio = periodo_us > referencia ? periodo_us - referencia : referencia - periodo_us;
+        if (desvio <= (referencia >> despertador->tolerancia_shift)) {
+            return false;
+        }
+    }
+    atomic_store_explicit(&despertador->armado, 0U, memory_order_relaxed);
+    return despertador->despertar(despertador->contexto);
+}
@@ -43,7 +43,7 @@ static const int s_lcd_data_pins[16] = {
 #define TOUCH_I2C_SCL    GPIO_NUM_9
 #define TOUCH_I2C_SDA    GPIO_NUM_8
 #define TOUCH_RST_GPIO   GPIO_NUM_NC
-#define TOUCH_INT_GPIO   GPIO_NUM_4
+#define TOUCH_INT_GPIO   ((gpio_num_t)DISPLAY_TOUCH_INT_GPIO)
 
 static const char *TAG = "display_driver";
 
@@ -80,6 +80,14 @@ void display_driver_set_backlight(bool enabled)
 #endif
 }
 
+esp_err_t display_driver_restart_panel(display_driver_t *driver)
+{
+    if (!driver || !driver->panel) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return esp_lcd_rgb_panel_restart(driver->panel);
+}
+
 static esp_err_t init_rgb_panel(esp_lcd_panel_handle_t *panel_handle)
 {
     esp_lcd_rgb_panel_config_t config = {
@@ -8,6 +8,7 @@
 
 #define DISPLAY_H_RES 800
 #define DISPLAY_V_RES 480
+#define DISPLAY_TOUCH_INT_GPIO 4
 
 typedef struct {
     esp_lcd_panel_handle_t panel;
@@ -18,3 +19,5 @@ typedef struct {
 
 esp_err_t display_driver_init(display_driver_t *driver);
 void display_driver_set_backlight(bool enabled);
+/* Re-sync the RGB scan after light sleep; the frame buffer in PSRAM is kept */
+esp_err_t display_driver_restart_panel(display_driver_t *driver);
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "despertador_bordas.h"
+#include "fila_bordas.h"
+#include "filtro_glitch.h"
+
+/*
+ * Interface de fonte de pulsos. Cada backend entrega timestamps de borda (us)
+ * ja filtrados na fila_bordas indicada em iniciar(). Backends que contam em
+ * hardware sem gerar interrupcao por borda implementam amostrar(), chamado
+ * periodicamente por tarefa_metricas. Backends que filtram em software
+ * expoem o filtro_glitch usado para diagnostico (NULL nos demais). Backends
+ * com interrupcao por borda avaliam o despertador apos cada borda aceita.
+ *
+ * Light sleep (opcional): em sono a deteccao de borda para. preparar_sono()
+ * arma o pino para acordar o chip no nivel oposto ao de repouso;
+ * sono_interrompido(), chamado logo antes de dormir, diz se o pino ja saiu
+ * do repouso depois de armado (o sono entao nem comeca); retomar_sono()
+ * volta ao modo normal e, se o pino passou por uma borda contada enquanto
+ * armado, a entrega com o instante do despertar, mesmo que o pulso ja tenha
+ * acabado. As tres rodam no nucleo onde as ISRs da fonte foram instaladas.
+ */
+typedef struct fonte_pulsos fonte_pulsos_t;
+
+struct fonte_pulsos {
+    const char *nome;
+    int (*iniciar)(fonte_pulsos_t *fonte, fila_bordas_t *fila); /* 0 em sucesso */
+    void (*amostrar)(fonte_pulsos_t *fonte, int64_t agora_us);  /* opcional */
+    int (*preparar_sono)(fonte_pulsos_t *fonte);                /* opcional, 0 em sucesso */
+    bool (*sono_interrompido)(fonte_pulsos_t *fonte);
+    bool (*retomar_sono)(fonte_pulsos_t *fonte, int64_t despertar_us); /* true se entregou borda */
+    filtro_glitch_t *filtro;
+    despertador_bordas_t *despertador;  /* definido pelo consumidor antes de iniciar() */
+};
+
+typedef struct {
+    int gpio_num;
+    filtro_glitch_config_t filtro;
+} fonte_pulsos_config_t;
+
+static inline int fonte_pulsos_iniciar(fonte_pulsos_t *fonte, fila_bordas_t *fila)
+{
+    return fonte->iniciar(fonte, fila);
+}
+
+static inline bool fonte_pulsos_suporta_sono(const fonte_pulsos_t *fonte)
+{
+    return fonte->preparar_sono && fonte->sono_interrompido && fonte->retomar_sono;
+}
+
+static inline void fonte_pulsos_amostrar(fonte_pulsos_t *fonte, int64_t agora_us)
+{
+    if (fonte->amostrar) {
+        fonte->amostrar(fonte, agora_us);
+    }
+}
@@ -0,0 +1,110 @@
+#include "fonte_pulsos_hw.h"
+#include "gpio_despertar.h"
+
+#include "driver/gpio.h"
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+
+typedef struct {
+    fonte_pulsos_t base;
+    gpio_num_t gpio;
+    fila_bordas_t *fila;
+    filtro_glitch_t filtro;
+    int nivel_repouso;              /* nivel do pino ao entrar em light sleep */
+    int64_t pendente_us;            /* descida que a ISR nao atendeu ao armar; 0 se nenhuma */
+} fonte_gpio_t;
+
+static const char *TAG = "fonte_gpio";
+
+static void IRAM_ATTR isr_pulso(void *arg)
+{
+    fonte_gpio_t *fonte = (fonte_gpio_t *)arg;
+    const int64_t agora_us = esp_timer_get_time();
+    if (filtro_glitch_aceitar(&fonte->filtro, agora_us)) {
+        fila_bordas_inserir(fonte->fila, agora_us);
+        if (despertador_bordas_avaliar(fonte->base.despertador, fonte->filtro.periodo_estimado_us)) {
+            portYIELD_FROM_ISR();
+        }
+    }
+}
+
+static int gpio_preparar_sono(fonte_pulsos_t *base)
+{
+    fonte_gpio_t *fonte = (fonte_gpio_t *)base;
+    /* O despertar e por nivel: com a interrupcao de borda ligada ele dispararia sem parar ao acordar */
+    gpio_intr_disable(fonte->gpio);
+    /* Descida travada que a ISR nao chegou a atender: entra no retomar e o sono nem comeca */
+    fonte->pendente_us = gpio_despertar_consumir(fonte->gpio) ? esp_timer_get_time() : 0;
+    fonte->nivel_repouso = gpio_get_level(fonte->gpio);
+    return gpio_wakeup_enable(fonte->gpio, fonte->nivel_repouso ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+}
+
+static bool gpio_sono_interrompido(fonte_pulsos_t *base)
+{
+    fonte_gpio_t *fonte = (fonte_gpio_t *)base;
+    /* Pulso inteiro entre armar e dormir: o pino ja voltou ao repouso, mas o status travou */
+    return fonte->pendente_us != 0 || gpio_despertar_travado(fonte->gpio) ||
+           gpio_get_level(fonte->gpio) != fonte->nivel_repouso;
+}
+
+static bool gpio_retomar_sono(fonte_pulsos_t *base, int64_t despertar_us)
+{
+    fonte_gpio_t *fonte = (fonte_gpio_t *)base;
+    gpio_wakeup_disable(fonte->gpio);
+    gpio_set_intr_type(fonte->gpio, GPIO_INTR_NEGEDGE);
+    /* Conta pelo status travado, nao pelo nivel de agora: um pulso curto ja terminou quando o chip acorda */
+    const bool disparou = gpio_despertar_consumir(fonte->gpio);
+    bool entregou = false;
+    if (fonte->pendente_us != 0 && filtro_glitch_aceitar(&fonte->filtro, fonte->pendente_us)) {
+        fila_bordas_inserir(fonte->fila, fonte->pendente_us);
+        entregou = true;
+    }
+    fonte->pendente_us = 0;
+    /* Despertar pela subida (repouso baixo) nao e borda contada; a descida seguinte chega pela ISR */
+    if (disparou && fonte->nivel_repouso == 1 && filtro_glitch_aceitar(&fonte->filtro, despertar_us)) {
+        fila_bordas_inserir(fonte->fila, despertar_us);
+        entregou = true;
+    }
+    gpio_intr_enable(fonte->gpio);
+    return entregou;
+}
+
+static int gpio_iniciar(fonte_pulsos_t *base, fila_bordas_t *fila)
+{
+    fonte_gpio_t *fonte = (fonte_gpio_t *)base;
+    fonte->fila = fila;
+
+    gpio_config_t config = {
+        .pin_bit_mask = 1ULL << fonte->gpio,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_ENABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_NEGEDGE,
+    };
+    ESP_RETURN_ON_ERROR(gpio_config(&config), TAG, "gpio_config");
+    /* ISR em IRAM: continua atendendo bordas enquanto o gravador apaga/escreve a flash */
+    esp_err_t err = gpio_install_isr_service(ESP_INTR_FLAG_IRAM);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        return err;
+    }
+    return gpio_isr_handler_add(fonte->gpio, isr_pulso, fonte);
+}
+
+esp_err_t fonte_pulsos_nova_gpio(const fonte_pulsos_config_t *config, fonte_pulsos_t **fonte)
+{
+    ESP_RETURN_ON_FALSE(config && fonte, ESP_ERR_INVALID_ARG, TAG, "argumento invalido");
+    fonte_gpio_t *gpio = heap_caps_calloc(1, sizeof(*gpio), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    ESP_RETURN_ON_FALSE(gpio, ESP_ERR_NO_MEM, TAG, "sem memoria");
+    gpio->base.nome = "gpio";
+    gpio->base.iniciar = gpio_iniciar;
+    gpio->base.preparar_sono = gpio_preparar_sono;
+    gpio->base.sono_interrompido = gpio_sono_interrompido;
+    gpio->base.retomar_sono = gpio_retomar_sono;
+    gpio->base.filtro = &gpio->filtro;
+    gpio->gpio = (gpio_num_t)config->gpio_num;
+    filtro_glitch_inicializar(&gpio->filtro, &config->filtro);
+    *fonte = &gpio->base;
+    return ESP_OK;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "esp_err.h"
+#include "fonte_pulsos.h"
+
+esp_err_t fonte_pulsos_nova_gpio(const fonte_pulsos_config_t *config, fonte_pulsos_t **fonte);
+esp_err_t fonte_pulsos_nova_mcpwm(const fonte_pulsos_config_t *config, fonte_pulsos_t **fonte);
+esp_err_t fonte_pulsos_nova_pcnt(const fonte_pulsos_config_t *config, fonte_pulsos_t **fonte);
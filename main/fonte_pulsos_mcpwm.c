@@ -0,0 +1,166 @@
+#include "fonte_pulsos_hw.h"
+#include "gpio_despertar.h"
+
+#include "driver/gpio.h"
+#include "driver/mcpwm_cap.h"
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "sdkconfig.h"
+#include "soc/soc_caps.h"
+
+/* Acima disso o contador de 32 bits do timer de captura pode ter dado a volta. */
+#define MCPWM_REANCORAR_US (10LL * 1000 * 1000)
+
+#if CONFIG_CONTADOR_FONTE_MCPWM
+/* O Kconfig ja limita; isto pega um sdkconfig editado a mao */
+_Static_assert(CONFIG_CONTADOR_CANAIS <= SOC_MCPWM_CAPTURE_CHANNELS_PER_TIMER, "mais canais que capturas no timer MCPWM");
+#endif
+
+typedef struct {
+    fonte_pulsos_t base;
+    int gpio;
+    fila_bordas_t *fila;
+    filtro_glitch_t filtro;
+    mcpwm_cap_channel_handle_t canal;
+    uint32_t ticks_por_us;
+    uint32_t ultima_captura;
+    uint32_t resto_ticks;
+    int64_t ultima_borda_us;
+    int nivel_repouso;              /* nivel do pino ao entrar em light sleep */
+    bool interrompido;              /* nao dormiu: a captura viu tudo desde que armou */
+} fonte_mcpwm_t;
+
+static const char *TAG = "fonte_mcpwm";
+
+/* Um timer de captura atende todos os canais (3 por grupo no ESP32-S3); criado pelo primeiro */
+static mcpwm_cap_timer_handle_t s_timer = NULL;
+static uint32_t s_ticks_por_us = 0;
+/* Exclui a ISR de captura (mesmo nucleo) enquanto retomar_sono mexe no estado do canal */
+static portMUX_TYPE s_trava_sono = portMUX_INITIALIZER_UNLOCKED;
+
+static esp_err_t obter_timer_compartilhado(void)
+{
+    if (s_timer) {
+        return ESP_OK;
+    }
+    const mcpwm_capture_timer_config_t timer_cfg = {
+        .group_id = 0,
+        .clk_src = MCPWM_CAPTURE_CLK_SRC_DEFAULT,
+    };
+    ESP_RETURN_ON_ERROR(mcpwm_new_capture_timer(&timer_cfg, &s_timer), TAG, "timer de captura");
+    uint32_t resolucao_hz = 0;
+    ESP_RETURN_ON_ERROR(mcpwm_capture_timer_get_resolution(s_timer, &resolucao_hz), TAG, "resolucao");
+    s_ticks_por_us = resolucao_hz / 1000000U;
+    ESP_RETURN_ON_FALSE(s_ticks_por_us > 0, ESP_ERR_INVALID_STATE, TAG, "resolucao abaixo de 1 MHz");
+    ESP_RETURN_ON_ERROR(mcpwm_capture_timer_enable(s_timer), TAG, "habilitar timer");
+    return mcpwm_capture_timer_start(s_timer);
+}
+
+static bool IRAM_ATTR ao_capturar(mcpwm_cap_channel_handle_t canal, const mcpwm_capture_event_data_t *evento,
+                                  void *contexto)
+{
+    fonte_mcpwm_t *fonte = (fonte_mcpwm_t *)contexto;
+    const int64_t agora_us = esp_timer_get_time();
+
+    /* O timestamp vem do registrador de captura, nao do instante de entrada na ISR. */
+    int64_t borda_us;
+    if (fonte->ultima_borda_us == 0 || (agora_us - fonte->ultima_borda_us) > MCPWM_REANCORAR_US) {
+        borda_us = agora_us;
+        fonte->resto_ticks = 0;
+    } else {
+        const uint32_t delta_ticks = (evento->cap_value - fonte->ultima_captura) + fonte->resto_ticks;
+        borda_us = fonte->ultima_borda_us + (int64_t)(delta_ticks / fonte->ticks_por_us);
+        fonte->resto_ticks = delta_ticks % fonte->ticks_por_us;
+    }
+    fonte->ultima_captura = evento->cap_value;
+    fonte->ultima_borda_us = borda_us;
+
+    bool acordou = false;
+    if (filtro_glitch_aceitar(&fonte->filtro, borda_us)) {
+        fila_bordas_inserir(fonte->fila, borda_us);
+        acordou = despertador_bordas_avaliar(fonte->base.despertador, fonte->filtro.periodo_estimado_us);
+    }
+    return acordou;
+}
+
+static int mcpwm_preparar_sono(fonte_pulsos_t *base)
+{
+    fonte_mcpwm_t *fonte = (fonte_mcpwm_t *)base;
+    /* A captura nao tem despertar proprio: o pino acorda pela matriz GPIO, sem ISR de GPIO ligada */
+    fonte->interrompido = false;
+    gpio_despertar_consumir((gpio_num_t)fonte->gpio);
+    fonte->nivel_repouso = gpio_get_level(fonte->gpio);
+    return gpio_wakeup_enable(fonte->gpio, fonte->nivel_repouso ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+}
+
+static bool mcpwm_sono_interrompido(fonte_pulsos_t *base)
+{
+    fonte_mcpwm_t *fonte = (fonte_mcpwm_t *)base;
+    /* Acordado, a captura ainda conta: o pulso entre armar e dormir ja entrou por ela */
+    fonte->interrompido = gpio_despertar_travado((gpio_num_t)fonte->gpio) ||
+                          gpio_get_level(fonte->gpio) != fonte->nivel_repouso;
+    return fonte->interrompido;
+}
+
+static bool mcpwm_retomar_sono(fonte_pulsos_t *base, int64_t despertar_us)
+{
+    fonte_mcpwm_t *fonte = (fonte_mcpwm_t *)base;
+    gpio_wakeup_disable(fonte->gpio);
+    gpio_set_intr_type(fonte->gpio, GPIO_INTR_DISABLE);
+    /* Mesmo criterio da fonte GPIO: o status travado, nao o nivel lido depois de acordar */
+    const bool disparou = gpio_despertar_consumir((gpio_num_t)fonte->gpio) && !fonte->interrompido;
+    fonte->interrompido = false;
+
+    bool entregou = false;
+    portENTER_CRITICAL(&s_trava_sono);
+    /* O timer de captura parou durante o sono: a proxima captura reancora no esp_timer */
+    fonte->ultima_borda_us = 0;
+    if (disparou && fonte->nivel_repouso == 1 && filtro_glitch_aceitar(&fonte->filtro, despertar_us)) {
+        fila_bordas_inserir(fonte->fila, despertar_us);
+        entregou = true;
+    }
+    portEXIT_CRITICAL(&s_trava_sono);
+    return entregou;
+}
+
+static int mcpwm_iniciar(fonte_pulsos_t *base, fila_bordas_t *fila)
+{
+    fonte_mcpwm_t *fonte = (fonte_mcpwm_t *)base;
+    fonte->fila = fila;
+    ESP_RETURN_ON_ERROR(obter_timer_compartilhado(), TAG, "timer compartilhado");
+    fonte->ticks_por_us = s_ticks_por_us;
+
+    const mcpwm_capture_channel_config_t canal_cfg = {
+        .gpio_num = fonte->gpio,
+        .prescale = 1,
+        .flags.neg_edge = true,
+        .flags.pos_edge = false,
+        .flags.pull_up = true,
+    };
+    ESP_RETURN_ON_ERROR(mcpwm_new_capture_channel(s_timer, &canal_cfg, &fonte->canal), TAG, "canal de captura");
+
+    const mcpwm_capture_event_callbacks_t cbs = {
+        .on_cap = ao_capturar,
+    };
+    ESP_RETURN_ON_ERROR(mcpwm_capture_channel_register_event_callbacks(fonte->canal, &cbs, fonte), TAG, "callbacks");
+    return mcpwm_capture_channel_enable(fonte->canal);
+}
+
+esp_err_t fonte_pulsos_nova_mcpwm(const fonte_pulsos_config_t *config, fonte_pulsos_t **fonte)
+{
+    ESP_RETURN_ON_FALSE(config && fonte, ESP_ERR_INVALID_ARG, TAG, "argumento invalido");
+    fonte_mcpwm_t *mcpwm = heap_caps_calloc(1, sizeof(*mcpwm), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    ESP_RETURN_ON_FALSE(mcpwm, ESP_ERR_NO_MEM, TAG, "sem memoria");
+    mcpwm->base.nome = "mcpwm";
+    mcpwm->base.iniciar = mcpwm_iniciar;
+    mcpwm->base.preparar_sono = mcpwm_preparar_sono;
+    mcpwm->base.sono_interrompido = mcpwm_sono_interrompido;
+    mcpwm->base.retomar_sono = mcpwm_retomar_sono;
+    mcpwm->base.filtro = &mcpwm->filtro;
+    mcpwm->gpio = config->gpio_num;
+    filtro_glitch_inicializar(&mcpwm->filtro, &config->filtro);
+    *fonte = &mcpwm->base;
+    return ESP_OK;
+}
@@ -0,0 +1,108 @@
+#include "fonte_pulsos_hw.h"
+
+#include "driver/gpio.h"
+#include "driver/pulse_cnt.h"
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+
+#define PCNT_LIMITE_ALTO      30000
+#define PCNT_GLITCH_MAX_NS    10000     /* perto do maximo do hardware (1023 ciclos de APB) */
+#define PCNT_BORDAS_POR_AMOSTRA ((int)FILA_BORDAS_CAPACIDADE)
+
+/*
+ * O PCNT conta bordas em hardware sem interrupcao por borda. A cada amostra
+ * as N bordas novas sao distribuidas uniformemente entre a amostra anterior
+ * e a atual, entao a resolucao de periodo individual fica limitada ao
+ * intervalo de amostragem; contagem e frequencia media permanecem exatas.
+ *
+ * Cada amostra entrega no maximo uma fila cheia (a tarefa drena logo depois).
+ * O excedente fica no contador e sai na amostra seguinte, com o inicio da
+ * janela avancado na mesma proporcao, entao nenhuma borda vira transbordo.
+ *
+ * Limitacao: o filtro de glitch do PCNT so rejeita pulsos de ate ~12 us. O
+ * repique de bobina na faixa de CONTADOR_FILTRO_BLOQUEIO_MIN_US e contado
+ * como borda, e o filtro_glitch de software nao ajuda aqui porque os
+ * instantes sao sintetizados. Para sensores com repique use GPIO ou MCPWM.
+ */
+typedef struct {
+    fonte_pulsos_t base;
+    int gpio;
+    fila_bordas_t *fila;
+    pcnt_unit_handle_t unidade;
+    pcnt_channel_handle_t canal;
+    int ultima_contagem;
+    int64_t ultima_amostra_us;
+} fonte_pcnt_t;
+
+static const char *TAG = "fonte_pcnt";
+
+static void pcnt_amostrar(fonte_pulsos_t *base, int64_t agora_us)
+{
+    fonte_pcnt_t *fonte = (fonte_pcnt_t *)base;
+    int contagem = 0;
+    if (pcnt_unit_get_count(fonte->unidade, &contagem) != ESP_OK) {
+        return;
+    }
+    const int novas = contagem - fonte->ultima_contagem;
+    if (novas <= 0) {
+        fonte->ultima_amostra_us = agora_us;
+        return;
+    }
+
+    const int entregues = novas < PCNT_BORDAS_POR_AMOSTRA ? novas : PCNT_BORDAS_POR_AMOSTRA;
+    const int64_t janela_us = agora_us - fonte->ultima_amostra_us;
+    for (int i = 1; i <= entregues; i++) {
+        fila_bordas_inserir(fonte->fila, fonte->ultima_amostra_us + (janela_us * i) / novas);
+    }
+    fonte->ultima_contagem += entregues;
+    fonte->ultima_amostra_us += (janela_us * entregues) / novas;
+}
+
+static int pcnt_iniciar(fonte_pulsos_t *base, fila_bordas_t *fila)
+{
+    fonte_pcnt_t *fonte = (fonte_pcnt_t *)base;
+    fonte->fila = fila;
+
+    const pcnt_unit_config_t unidade_cfg = {
+        .low_limit = -1,
+        .high_limit = PCNT_LIMITE_ALTO,
+        .flags.accum_count = true,
+    };
+    ESP_RETURN_ON_ERROR(pcnt_new_unit(&unidade_cfg, &fonte->unidade), TAG, "unidade");
+
+    const pcnt_glitch_filter_config_t filtro_cfg = {
+        .max_glitch_ns = PCNT_GLITCH_MAX_NS,
+    };
+    ESP_RETURN_ON_ERROR(pcnt_unit_set_glitch_filter(fonte->unidade, &filtro_cfg), TAG, "filtro");
+
+    const pcnt_chan_config_t canal_cfg = {
+        .edge_gpio_num = fonte->gpio,
+        .level_gpio_num = -1,
+    };
+    ESP_RETURN_ON_ERROR(pcnt_new_channel(fonte->unidade, &canal_cfg, &fonte->canal), TAG, "canal");
+    ESP_RETURN_ON_ERROR(pcnt_channel_set_edge_action(fonte->canal, PCNT_CHANNEL_EDGE_ACTION_HOLD,
+                                                     PCNT_CHANNEL_EDGE_ACTION_INCREASE),
+                        TAG, "acao de borda");
+    ESP_RETURN_ON_ERROR(gpio_set_pull_mode(fonte->gpio, GPIO_PULLUP_ONLY), TAG, "pull-up");
+    ESP_RETURN_ON_ERROR(pcnt_unit_add_watch_point(fonte->unidade, PCNT_LIMITE_ALTO), TAG, "watch point");
+    ESP_RETURN_ON_ERROR(pcnt_unit_enable(fonte->unidade), TAG, "habilitar");
+    ESP_RETURN_ON_ERROR(pcnt_unit_clear_count(fonte->unidade), TAG, "zerar");
+    /* Janela da primeira amostra comeca aqui: bordas desde a partida entram nela */
+    fonte->ultima_contagem = 0;
+    fonte->ultima_amostra_us = esp_timer_get_time();
+    return pcnt_unit_start(fonte->unidade);
+}
+
+esp_err_t fonte_pulsos_nova_pcnt(const fonte_pulsos_config_t *config, fonte_pulsos_t **fonte)
+{
+    ESP_RETURN_ON_FALSE(config && fonte, ESP_ERR_INVALID_ARG, TAG, "argumento invalido");
+    fonte_pcnt_t *pcnt = heap_caps_calloc(1, sizeof(*pcnt), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    ESP_RETURN_ON_FALSE(pcnt, ESP_ERR_NO_MEM, TAG, "sem memoria");
+    pcnt->base.nome = "pcnt";
+    pcnt->base.iniciar = pcnt_iniciar;
+    pcnt->base.amostrar = pcnt_amostrar;
+    pcnt->gpio = config->gpio_num;
+    *fonte = &pcnt->base;
+    return ESP_OK;
+}
@@ -0,0 +1,101 @@
+#include "fonte_pulsos_sim.h"
+
+#include <string.h>
+
+#define SIM_LOTE_BORDAS 32
+
+static uint32_t prng_proximo(uint32_t *estado)
+{
+    /* xorshift32: deterministico e barato, suficiente para jitter de teste */
+    uint32_t x = *estado;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *estado = x;
+    return x;
+}
+
+static int64_t calcular_periodo_us(fonte_pulsos_sim_t *sim)
+{
+    if (sim->config.frequencia_mhz == 0) {
+        return INT64_MAX;
+    }
+    int64_t periodo_us = (int64_t)(1000000000ULL / sim->config.frequencia_mhz);
+    if (sim->config.jitter_us > 0) {
+        const uint32_t faixa = 2U * sim->config.jitter_us + 1U;
+        periodo_us += (int64_t)(prng_proximo(&sim->estado_prng) % faixa) - (int64_t)sim->config.jitter_us;
+    }
+    return periodo_us > 1 ? periodo_us : 1;
+}
+
+static int sim_iniciar(fonte_pulsos_t *fonte, fila_bordas_t *fila)
+{
+    fonte_pulsos_sim_t *sim = (fonte_pulsos_sim_t *)fonte;
+    sim->fila = fila;
+    return 0;
+}
+
+static void sim_amostrar(fonte_pulsos_t *fonte, int64_t agora_us)
+{
+    fonte_pulsos_sim_t *sim = (fonte_pulsos_sim_t *)fonte;
+    int64_t lote[SIM_LOTE_BORDAS];
+    size_t quantidade;
+    do {
+        quantidade = fonte_pulsos_sim_gerar(sim, agora_us, lote, SIM_LOTE_BORDAS);
+        for (size_t i = 0; i < quantidade; i++) {
+            if (filtro_glitch_aceitar(&sim->filtro, lote[i])) {
+                fila_bordas_inserir(sim->fila, lote[i]);
+            }
+        }
+    } while (quantidade == SIM_LOTE_BORDAS);
+}
+
+void fonte_pulsos_sim_configurar(fonte_pulsos_sim_t *sim, const fonte_pulsos_sim_config_t *config, int64_t inicio_us)
+{
+    memset(sim, 0, sizeof(*sim));
+    sim->base.nome = "simulada";
+    sim->base.iniciar = sim_iniciar;
+    sim->base.amostrar = sim_amostrar;
+    sim->base.filtro = &sim->filtro;
+    sim->config = *config;
+    filtro_glitch_inicializar(&sim->filtro, &config->filtro);
+    sim->estado_prng = config->semente ? config->semente : 0x9E3779B9U;
+    sim->gerado_ate_us = inicio_us;
+    sim->proxima_borda_us = inicio_us + calcular_periodo_us(sim);
+}
+
+void fonte_pulsos_sim_definir_frequencia(fonte_pulsos_sim_t *sim, uint32_t frequencia_mhz)
+{
+    const bool estava_parada = sim->config.frequencia_mhz == 0;
+    sim->config.frequencia_mhz = frequencia_mhz;
+    if (estava_parada && frequencia_mhz > 0) {
+        sim->proxima_borda_us = sim->gerado_ate_us + calcular_periodo_us(sim);
+    }
+}
+
+size_t fonte_pulsos_sim_gerar(fonte_pulsos_sim_t *sim, int64_t ate_us, int64_t *destino, size_t max)
+{
+    size_t gerados = 0;
+    if (ate_us > sim->gerado_ate_us) {
+        sim->gerado_ate_us = ate_us;
+    }
+    while (gerados < max) {
+        if (sim->repiques_pendentes > 0 && sim->proximo_repique_us <= ate_us &&
+            sim->proximo_repique_us < sim->proxima_borda_us) {
+            destino[gerados++] = sim->proximo_repique_us;
+            sim->proximo_repique_us += sim->config.intervalo_repique_us;
+            sim->repiques_pendentes--;
+            continue;
+        }
+        if (sim->config.frequencia_mhz == 0 || sim->proxima_borda_us > ate_us) {
+            break;
+        }
+        const int64_t borda_us = sim->proxima_borda_us;
+        destino[gerados++] = borda_us;
+        sim->bordas_reais++;
+        sim->repiques_pendentes = sim->config.repiques;
+        sim->proximo_repique_us = borda_us + sim->config.intervalo_repique_us;
+        sim->proxima_borda_us = borda_us + calcular_periodo_us(sim);
+    }
+    return gerados;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "fonte_pulsos.h"
+
+/* Gerador de bordas em software, sem dependencia de hardware (roda tambem no Linux). */
+typedef struct {
+    uint32_t frequencia_mhz;        /* frequencia nominal em mHz */
+    uint32_t jitter_us;             /* desvio maximo (+/-) aplicado a cada periodo */
+    uint32_t repiques;              /* bordas espurias geradas apos cada borda real */
+    uint32_t intervalo_repique_us;  /* espacamento entre repiques */
+    filtro_glitch_config_t filtro;
+    uint32_t semente;
+} fonte_pulsos_sim_config_t;
+
+typedef struct {
+    fonte_pulsos_t base;
+    fonte_pulsos_sim_config_t config;
+    fila_bordas_t *fila;
+    uint32_t estado_prng;
+    int64_t proxima_borda_us;
+    uint32_t repiques_pendentes;
+    int64_t proximo_repique_us;
+    filtro_glitch_t filtro;
+    int64_t gerado_ate_us;
+    uint64_t bordas_reais;
+} fonte_pulsos_sim_t;
+
+void fonte_pulsos_sim_configurar(fonte_pulsos_sim_t *sim, const fonte_pulsos_sim_config_t *config, int64_t inicio_us);
+void fonte_pulsos_sim_definir_frequencia(fonte_pulsos_sim_t *sim, uint32_t frequencia_mhz);
+/* Gera as bordas cruas (incluindo repiques) ate ate_us, sem filtro. */
+size_t fonte_pulsos_sim_gerar(fonte_pulsos_sim_t *sim, int64_t ate_us, int64_t *destino, size_t max);
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "driver/gpio.h"
+#include "hal/gpio_ll.h"
+#include "soc/gpio_struct.h"
+
+/*
+ * Status bruto de interrupcao de um pino da matriz GPIO. Ele trava a
+ * condicao configurada (borda ou, com gpio_wakeup_enable, o nivel de
+ * despertar) mesmo com a interrupcao desligada e ate ser limpo: diz se o
+ * pino passou pelo nivel de despertar durante o sono, ainda que o pulso ja
+ * tenha terminado quando o chip acorda.
+ */
+static inline bool gpio_despertar_travado(gpio_num_t gpio)
+{
+    if (gpio < 32) {
+        return (GPIO.status & (1UL << gpio)) != 0;
+    }
+    return (GPIO.status1.intr_st & (1UL << (gpio - 32))) != 0;
+}
+
+/* Le e limpa; limpa so se estava travado, entao uma borda nova depois da leitura nao se perde */
+static inline bool gpio_despertar_consumir(gpio_num_t gpio)
+{
+    if (!gpio_despertar_travado(gpio)) {
+        return false;
+    }
+    if (gpio < 32) {
+        gpio_ll_clear_intr_status(&GPIO, 1UL << gpio);
+    } else {
+        gpio_ll_clear_intr_status_high(&GPIO, 1UL << (gpio - 32));
+    }
+    return true;
+}
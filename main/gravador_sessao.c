@@ -0,0 +1,154 @@
+#include "gravador_sessao.h"
+
+#include "codec_gravador.h"
+
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/stream_buffer.h"
+#include "freertos/task.h"
+
+#define ROTULO_PARTICAO          "gravador"
+#define SUBTIPO_PARTICAO         0x40
+#define BUFFER_PERIODOS          2048
+#define LOTE_LEITURA             128
+#define PILHA_TAREFA_GRAVADOR    3072
+#define PRIORIDADE_GRAVADOR      1
+#define ESPERA_DADOS_MS          1000
+#define DESCARGA_OCIOSA_MS       5000
+
+static const char *TAG = "gravador";
+
+static const esp_partition_t *s_particao = NULL;
+static StreamBufferHandle_t s_buffer = NULL;
+static _Atomic uint32_t s_periodos_descartados = 0;
+
+/* Estado exclusivo de tarefa_gravador */
+static codec_gravador_t s_codec;
+static uint32_t s_setor_atual = 0;
+static uint32_t s_total_setores = 0;
+static _Atomic uint32_t s_proxima_sequencia = 0;
+static _Atomic uint32_t s_blocos_gravados = 0;
+static _Atomic uint32_t s_erros_flash = 0;
+
+static void localizar_ponto_de_escrita(void);
+static void gravar_bloco(void);
+static void tarefa_gravador(void *param);
+
+esp_err_t gravador_sessao_inicializar(void)
+{
+    s_particao = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, SUBTIPO_PARTICAO, ROTULO_PARTICAO);
+    ESP_RETURN_ON_FALSE(s_particao, ESP_ERR_NOT_FOUND, TAG, "Particao '%s' ausente", ROTULO_PARTICAO);
+    s_total_setores = s_particao->size / CODEC_GRAVADOR_BLOCO_BYTES;
+    ESP_RETURN_ON_FALSE(s_total_setores > 0, ESP_ERR_INVALID_SIZE, TAG, "Particao menor que um setor");
+
+    localizar_ponto_de_escrita();
+    codec_gravador_iniciar_bloco(&s_codec);
+
+    s_buffer = xStreamBufferCreate(BUFFER_PERIODOS * sizeof(uint32_t), sizeof(uint32_t));
+    ESP_RETURN_ON_FALSE(s_buffer, ESP_ERR_NO_MEM, TAG, "Sem memoria para o buffer");
+    BaseType_t criada = xTaskCreate(tarefa_gravador, "gravador", PILHA_TAREFA_GRAVADOR, NULL, PRIORIDADE_GRAVADOR,
+                                    NULL);
+    ESP_RETURN_ON_FALSE(criada == pdPASS, ESP_FAIL, TAG, "Falha ao criar tarefa");
+    ESP_LOGI(TAG, "%" PRIu32 " setores, proximo %" PRIu32 " (seq %" PRIu32 ")", s_total_setores, s_setor_atual,
+             atomic_load(&s_proxima_sequencia));
+    return ESP_OK;
+}
+
+void gravador_sessao_registrar(const uint32_t *periodos_us, size_t quantidade)
+{
+    if (!s_buffer || quantidade == 0) {
+        return;
+    }
+    /* Lote inteiro ou nada: o leitor sempre recebe periodos alinhados */
+    const size_t bytes = quantidade * sizeof(uint32_t);
+    if (xStreamBufferSpacesAvailable(s_buffer) < bytes || xStreamBufferSend(s_buffer, periodos_us, bytes, 0) != bytes) {
+        atomic_fetch_add_explicit(&s_periodos_descartados, (uint32_t)quantidade, memory_order_relaxed);
+    }
+}
+
+void gravador_sessao_obter_diagnostico(gravador_diagnostico_t *diagnostico)
+{
+    if (!diagnostico) {
+        return;
+    }
+    diagnostico->blocos_gravados = atomic_load_explicit(&s_blocos_gravados, memory_order_relaxed);
+    diagnostico->periodos_descartados = atomic_load_explicit(&s_periodos_descartados, memory_order_relaxed);
+    diagnostico->erros_flash = atomic_load_explicit(&s_erros_flash, memory_order_relaxed);
+    diagnostico->proxima_sequencia = atomic_load_explicit(&s_proxima_sequencia, memory_order_relaxed);
+}
+
+/* Le so os cabecalhos: o bloco de maior sequencia e o mais recente, o seguinte e sobrescrito */
+static void localizar_ponto_de_escrita(void)
+{
+    bool encontrado = false;
+    uint32_t maior_sequencia = 0;
+    uint32_t setor_maior = 0;
+    for (uint32_t setor = 0; setor < s_total_setores; setor++) {
+        codec_gravador_cabecalho_t cabecalho;
+        if (esp_partition_read(s_particao, setor * CODEC_GRAVADOR_BLOCO_BYTES, &cabecalho, sizeof(cabecalho)) != ESP_OK) {
+            continue;
+        }
+        if (cabecalho.magico != CODEC_GRAVADOR_MAGICO || cabecalho.versao != CODEC_GRAVADOR_VERSAO) {
+            continue;
+        }
+        if (!encontrado || (int32_t)(cabecalho.sequencia - maior_sequencia) > 0) {
+            encontrado = true;
+            maior_sequencia = cabecalho.sequencia;
+            setor_maior = setor;
+        }
+    }
+    s_setor_atual = encontrado ? (setor_maior + 1U) % s_total_setores : 0;
+    atomic_store(&s_proxima_sequencia, encontrado ? maior_sequencia + 1U : 0);
+}
+
+static void gravar_bloco(void)
+{
+    const uint32_t sequencia = atomic_load_explicit(&s_proxima_sequencia, memory_order_relaxed);
+    const uint8_t *bloco = codec_gravador_fechar_bloco(&s_codec, sequencia);
+    const size_t deslocamento = (size_t)s_setor_atual * CODEC_GRAVADOR_BLOCO_BYTES;
+
+    esp_err_t err = esp_partition_erase_range(s_particao, deslocamento, CODEC_GRAVADOR_BLOCO_BYTES);
+    if (err == ESP_OK) {
+        err = esp_partition_write(s_particao, deslocamento, bloco, CODEC_GRAVADOR_BLOCO_BYTES);
+    }
+    if (err != ESP_OK) {
+        atomic_fetch_add_explicit(&s_erros_flash, 1, memory_order_relaxed);
+        ESP_LOGE(TAG, "Falha ao gravar setor %" PRIu32 " (0x%x)", s_setor_atual, err);
+    } else {
+        atomic_fetch_add_explicit(&s_blocos_gravados, 1, memory_order_relaxed);
+    }
+    /* Avanca mesmo com erro: um setor ruim nao trava o anel */
+    atomic_store_explicit(&s_proxima_sequencia, sequencia + 1U, memory_order_relaxed);
+    s_setor_atual = (s_setor_atual + 1U) % s_total_setores;
+    codec_gravador_iniciar_bloco(&s_codec);
+}
+
+static void tarefa_gravador(void *param)
+{
+    (void)param;
+    uint32_t lote[LOTE_LEITURA];
+    TickType_t ultima_entrada = xTaskGetTickCount();
+    while (true) {
+        const size_t bytes = xStreamBufferReceive(s_buffer, lote, sizeof(lote), pdMS_TO_TICKS(ESPERA_DADOS_MS));
+        const size_t quantidade = bytes / sizeof(uint32_t);
+        for (size_t i = 0; i < quantidade; i++) {
+            if (!codec_gravador_adicionar(&s_codec, lote[i])) {
+                gravar_bloco();
+                codec_gravador_adicionar(&s_codec, lote[i]);
+            }
+        }
+        if (quantidade > 0) {
+            ultima_entrada = xTaskGetTickCount();
+        } else if (!codec_gravador_vazio(&s_codec) &&
+                   xTaskGetTickCount() - ultima_entrada >= pdMS_TO_TICKS(DESCARGA_OCIOSA_MS)) {
+            /* Sinal parado: fecha o bloco parcial para nao perder o fim da sessao num desligamento */
+            gravar_bloco();
+        }
+    }
+}
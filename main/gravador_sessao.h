@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+/*
+ * Gravador de sessao: periodos brutos (us) vao para a particao "gravador"
+ * em blocos de um setor (ver codec_gravador.h), em anel append-only. A
+ * tarefa de metricas entrega lotes sem bloquear; erase e escrita ficam numa
+ * tarefa de baixa prioridade.
+ */
+typedef struct {
+    uint32_t blocos_gravados;
+    uint32_t periodos_descartados;   /* lotes que nao couberam no buffer */
+    uint32_t erros_flash;
+    uint32_t proxima_sequencia;
+} gravador_diagnostico_t;
+
+esp_err_t gravador_sessao_inicializar(void);
+void gravador_sessao_registrar(const uint32_t *periodos_us, size_t quantidade);
+void gravador_sessao_obter_diagnostico(gravador_diagnostico_t *diagnostico);
@@ -0,0 +1,149 @@
+#include "historico_sessoes.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_check.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "nvs.h"
+
+#define ESPACO_NVS               "sessoes"
+#define CHAVE_PROXIMO            "proximo"
+#define FILA_RESUMOS             8
+#define PILHA_TAREFA_HISTORICO   3072
+#define PRIORIDADE_HISTORICO     1
+
+static const char *TAG = "historico";
+
+static QueueHandle_t s_fila = NULL;
+static portMUX_TYPE s_trava = portMUX_INITIALIZER_UNLOCKED;
+/* Anel em RAM: s_total resumos, o mais novo em s_anel[(s_total - 1) % CAPACIDADE] */
+static resumo_sessao_t s_anel[HISTORICO_SESSOES_CAPACIDADE];
+static uint32_t s_total = 0;
+/* Estado exclusivo de tarefa_historico depois de inicializar */
+static uint32_t s_proximo_numero = 1;
+
+static void tarefa_historico(void *param);
+
+static void chave_do_numero(uint32_t numero, char *chave, size_t tamanho)
+{
+    snprintf(chave, tamanho, "s%02" PRIu32, numero % HISTORICO_SESSOES_CAPACIDADE);
+}
+
+static void anel_inserir(const resumo_sessao_t *resumo)
+{
+    portENTER_CRITICAL(&s_trava);
+    s_anel[s_total % HISTORICO_SESSOES_CAPACIDADE] = *resumo;
+    s_total++;
+    portEXIT_CRITICAL(&s_trava);
+}
+
+/* Recarrega as chaves do NVS em ordem de numero para reconstruir o anel */
+static void carregar_nvs(nvs_handle_t handle)
+{
+    if (nvs_get_u32(handle, CHAVE_PROXIMO, &s_proximo_numero) != ESP_OK || s_proximo_numero == 0) {
+        s_proximo_numero = 1;
+        return;
+    }
+    const uint32_t primeiro = s_proximo_numero > HISTORICO_SESSOES_CAPACIDADE
+                                  ? s_proximo_numero - HISTORICO_SESSOES_CAPACIDADE
+                                  : 1;
+    for (uint32_t numero = primeiro; numero < s_proximo_numero; numero++) {
+        char chave[8];
+        chave_do_numero(numero, chave, sizeof(chave));
+        resumo_sessao_t resumo;
+        size_t tamanho = sizeof(resumo);
+        if (nvs_get_blob(handle, chave, &resumo, &tamanho) == ESP_OK && tamanho == sizeof(resumo) &&
+            resumo.numero == numero) {
+            anel_inserir(&resumo);
+        }
+    }
+}
+
+esp_err_t historico_sessoes_inicializar(void)
+{
+    nvs_handle_t handle;
+    ESP_RETURN_ON_ERROR(nvs_open(ESPACO_NVS, NVS_READWRITE, &handle), TAG, "Falha ao abrir NVS");
+    carregar_nvs(handle);
+    nvs_close(handle);
+
+    s_fila = xQueueCreate(FILA_RESUMOS, sizeof(resumo_sessao_t));
+    ESP_RETURN_ON_FALSE(s_fila, ESP_ERR_NO_MEM, TAG, "Sem memoria para a fila");
+    BaseType_t criada = xTaskCreate(tarefa_historico, "historico", PILHA_TAREFA_HISTORICO, NULL, PRIORIDADE_HISTORICO,
+                                    NULL);
+    ESP_RETURN_ON_FALSE(criada == pdPASS, ESP_FAIL, TAG, "Falha ao criar tarefa");
+    ESP_LOGI(TAG, "%" PRIu32 " sessoes no historico, proxima #%" PRIu32, s_total, s_proximo_numero);
+    return ESP_OK;
+}
+
+void historico_sessoes_registrar(const resumo_sessao_t *resumo)
+{
+    if (!s_fila || !resumo) {
+        return;
+    }
+    if (xQueueSend(s_fila, resumo, 0) != pdTRUE) {
+        ESP_LOGW(TAG, "Fila cheia, resumo do canal %u descartado", resumo->canal);
+    }
+}
+
+size_t historico_sessoes_copiar(resumo_sessao_t *destino, size_t max)
+{
+    if (!destino) {
+        return 0;
+    }
+    portENTER_CRITICAL(&s_trava);
+    const uint32_t total = s_total;
+    size_t quantidade = total < HISTORICO_SESSOES_CAPACIDADE ? total : HISTORICO_SESSOES_CAPACIDADE;
+    if (quantidade > max) {
+        quantidade = max;
+    }
+    for (size_t i = 0; i < quantidade; i++) {
+        destino[i] = s_anel[(total - 1U - i) % HISTORICO_SESSOES_CAPACIDADE];
+    }
+    portEXIT_CRITICAL(&s_trava);
+    return quantidade;
+}
+
+static void arquivar(resumo_sessao_t *resumo)
+{
+    resumo->numero = s_proximo_numero++;
+    anel_inserir(resumo);
+    ESP_LOGI(TAG, "Sessao #%" PRIu32 " (canal %u): %" PRIu32 " furos, %" PRIu32 " s ativos de %" PRIu32
+             " s, RPM medio %" PRIu32 " pico %" PRIu32,
+             resumo->numero, resumo->canal, resumo->furos, resumo->tempo_ativo_ms / 1000U,
+             resumo->duracao_ms / 1000U, q16_arredondar(resumo->rpm_medio_q16),
+             q16_arredondar(resumo->rpm_pico_q16));
+
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(ESPACO_NVS, NVS_READWRITE, &handle);
+    if (err == ESP_OK) {
+        char chave[8];
+        chave_do_numero(resumo->numero, chave, sizeof(chave));
+        err = nvs_set_blob(handle, chave, resumo, sizeof(*resumo));
+        if (err == ESP_OK) {
+            err = nvs_set_u32(handle, CHAVE_PROXIMO, s_proximo_numero);
+        }
+        if (err == ESP_OK) {
+            err = nvs_commit(handle);
+        }
+        nvs_close(handle);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Falha ao gravar sessao #%" PRIu32 " (%s)", resumo->numero, esp_err_to_name(err));
+    }
+}
+
+static void tarefa_historico(void *param)
+{
+    (void)param;
+    resumo_sessao_t resumo;
+    while (true) {
+        if (xQueueReceive(s_fila, &resumo, portMAX_DELAY) == pdTRUE) {
+            arquivar(&resumo);
+        }
+    }
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "app_types.h"
+#include "esp_err.h"
+
+/*
+ * Resumos das sessoes encerradas: os ultimos HISTORICO_SESSOES_CAPACIDADE
+ * ficam num anel em RAM e cada um ocupa uma chave propria no NVS (anel de
+ * chaves), entao o historico sobrevive ao reboot sem regravar o conjunto.
+ * A tarefa de metricas entrega sem bloquear; a escrita em flash fica numa
+ * tarefa de baixa prioridade.
+ */
+#define HISTORICO_SESSOES_CAPACIDADE 16
+
+esp_err_t historico_sessoes_inicializar(void);
+/* Nao bloqueia; atribui o numero global da sessao antes de arquivar. */
+void historico_sessoes_registrar(const resumo_sessao_t *resumo);
+/* Copia os resumos do mais recente para o mais antigo; retorna quantos. */
+size_t historico_sessoes_copiar(resumo_sessao_t *destino, size_t max);
@@ -10,12 +10,20 @@
 #endif
 
 #include "display_driver.h"
+#include "latencia_tela.h"
 #include "esp_check.h"
 #include "esp_err.h"
+#include "esp_heap_caps.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "lvgl.h"
+#include "metricas.h"
+#include "partida.h"
+#include "mostrador_digitos.h"
+#include "tela_tendencia.h"
+#include "tema_ui.h"
 
 LV_FONT_DECLARE(lv_font_montserrat_14);
 LV_FONT_DECLARE(lv_font_montserrat_20);
@@ -24,6 +32,10 @@ LV_FONT_DECLARE(lv_font_montserrat_48);
 LV_IMAGE_DECLARE(liga_d_logo);
 
 #define SCOPE_POINT_COUNT            (100)
+#define PILHA_PARTIDA_UI             (6144)
+#define PRIORIDADE_PARTIDA_UI        (1)
+#define SPLASH_INTERVALO_MS          (50)
+#define SPLASH_FADE_MS               (250)
 
 typedef dados_medidos_t ui_data_t;
 
@@ -43,14 +55,57 @@ static display_driver_t s_display_driver;
 #define LVGL_DISPLAY (s_display_driver.lvgl_display)
 #define LVGL_TOUCH_INDEV (s_display_driver.touch_indev)
 
+/*
+ * Ultimo valor entregue a um widget. A chave numerica evita formatar o texto
+ * quando a medida nao mudou; o texto anterior e o proprio buffer do label,
+ * comparado antes de lv_label_set_text (que sempre realoca e invalida).
+ */
+typedef struct {
+    int64_t chave;
+    bool valido;
+} cache_widget_t;
+
 /* Objetos LVGL */
 typedef struct {
     lv_obj_t *card;
     lv_obj_t *label_titulo;
     lv_obj_t *label_valor;
     lv_obj_t *label_unidade;
+    cache_widget_t cache_valor;
 } card_ui_t;
 
+/*
+ * Segmento da barra de status; o separador fica antes do texto e some no
+ * primeiro. O label aponta para `texto` (lv_label_set_text_static), entao
+ * trocar o texto nao passa pelo heap.
+ */
+typedef struct {
+    lv_obj_t *separador;
+    lv_obj_t *label;
+    char texto[64];
+} segmento_status_t;
+
+#define STATUS_MAX_SEGMENTOS     (4)   /* ate 3 metricas mais a dica */
+
+/*
+ * Widgets proprios de um modo da tela cheia, filhos de uma raiz transparente
+ * criada na primeira vez que o modo abre. Titulo, valor, unidade, tempo e
+ * status sao comuns e ficam fora. Trocar de modo so oculta uma raiz e mostra
+ * outra; liberar zera os ponteiros listados em `widgets`.
+ */
+#define SUBARVORE_MAX_WIDGETS    (2)
+
+typedef struct {
+    void (*construir)(lv_obj_t *raiz);
+    lv_obj_t **widgets[SUBARVORE_MAX_WIDGETS];
+} subarvore_modo_t;
+
+typedef struct {
+    lv_obj_t *raiz;
+    uint32_t bytes;          /* heap consumido na construcao */
+    uint32_t ultimo_uso;     /* ordem de abertura, para liberar a mais antiga */
+} subarvore_t;
+
 typedef enum {
     UI_LAYOUT_GRID = 0,
     UI_LAYOUT_FULLSCREEN,
@@ -63,20 +118,24 @@ static lv_obj_t *s_full_title;
 static lv_obj_t *s_full_value;
 static lv_obj_t *s_full_unit;
 static lv_obj_t *s_full_status;
+static segmento_status_t s_status_segmentos[STATUS_MAX_SEGMENTOS];
 static lv_obj_t *s_full_arc;
 static lv_obj_t *s_full_arc_label;
 static lv_obj_t *s_full_bar;
 static lv_obj_t *s_full_bar_label;
 static lv_obj_t *s_full_timer_label;
 static lv_obj_t *s_full_scope_chart;
-static lv_chart_series_t *s_full_scope_series;
-static lv_obj_t *s_full_scope_axis_label;
+static lv_chart_series_t *s_full_scope_series_max;
+static lv_chart_series_t *s_full_scope_series_min;
+static uint32_t s_scope_cursor;
 static lv_obj_t *s_full_course_arc;
 static lv_obj_t *s_speed_bar;
 static lv_obj_t *s_speed_bar_label;
 static lv_obj_t *s_furos_circle_left;
 static lv_obj_t *s_furos_circle_right;
 static card_ui_t s_cards[DISPLAY_MODE_COUNT];
+static subarvore_t s_subarvores[DISPLAY_MODE_COUNT];
+static uint32_t s_aberturas;
 static ui_layout_t s_layout_mode = UI_LAYOUT_GRID;
 
 static const char *s_metric_titles[DISPLAY_MODE_COUNT] = {
@@ -99,25 +158,57 @@ static const uint32_t s_metric_colors[DISPLAY_MODE_COUNT] = {
 
 /* Estado dos dados exibidos */
 static configuracao_curso_t s_config_curso = {.curso_cm = CURSO_MAX_CM * 0.7f};
+static const configuracao_curso_t *s_config_origem;
+static lv_obj_t *s_splash_status;
 static ui_callbacks_t s_callbacks = {0};
 static bool s_modo_edicao = false;
 static display_mode_t s_display_mode = DISPLAY_FREQUENCIA;
+/* Ultima medicao recebida; so acessada com o lock do LVGL */
 static ui_data_t s_ui_snapshot = {0};
-static portMUX_TYPE s_ui_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+/* Caches do fullscreen e diagnostico de redesenho; so acessados com o lock do LVGL */
+static cache_widget_t s_cache_full_valor;
+static cache_widget_t s_cache_full_tempo;
+static cache_widget_t s_cache_curso_px;
+static bool s_reposicionar_valor;
+static int32_t s_largura_valor;
+static uint32_t s_versao_ui;
+static uint32_t s_pixels_pendentes;
+static uint64_t s_pixels_total;
+static interface_usuario_diagnostico_t s_diagnostico;
+static int64_t s_inicio_render_us;
 
 /* Prototipacao */
 static void build_ui(void);
 static void show_startup_screen(void);
+static void atualizar_splash(lv_timer_t *timer);
+static void tarefa_partida_ui(void *param);
 static void card_event_cb(lv_event_t *event);
 static void fullscreen_event_cb(lv_event_t *event);
+static void avisar_escopo_visivel(void);
 static void show_fullscreen(display_mode_t mode);
 static void show_grid(void);
+static void show_tendencia(display_mode_t mode);
+static void ao_sair_tendencia(void);
 static void refresh_ui(void);
 static void apply_ui_locked(const ui_data_t *data);
 static void update_cards_ui(const ui_data_t *data);
 static void update_fullscreen_ui(const ui_data_t *data);
+static void configurar_fullscreen(display_mode_t mode);
+static void posicionar_valor_fullscreen(void);
+static void garantir_subarvore(display_mode_t mode);
+static void aplicar_orcamento_subarvores(display_mode_t ativa);
+static void atualizar_tempo(const ui_data_t *data);
+static int64_t chave_metrica(display_mode_t mode, const ui_data_t *data);
+static bool cache_mudou(cache_widget_t *cache, int64_t chave);
+static bool label_definir_texto(lv_obj_t *label, const char *texto);
+static void obj_definir_oculto(lv_obj_t *obj, bool oculto);
+static void ao_invalidar_area(lv_event_t *evento);
+static void ao_renderizar(lv_event_t *evento);
+static void puxar_medicao(lv_timer_t *timer);
 static void get_metric_text(display_mode_t mode, const ui_data_t *data, char *valor, size_t valor_len, char *unidade, size_t unidade_len);
 static void formatar_distancia(char *buffer, size_t len, float distancia_m);
+static float distancia_em_metros(const ui_data_t *data);
 static void formatar_tempo(uint64_t tempo_ms, char *buffer, size_t len);
 static uint32_t calcular_limite_distancia_cm(float distancia_m);
 static lv_color_t obter_cor_rpm(uint32_t rpm);
@@ -125,7 +216,7 @@ static void atualizar_status_bar(const char *hint,
                                  const char **textos,
                                  const lv_color_t *cores,
                                  size_t quantidade);
-static void update_scope_wave(uint32_t freq_hz);
+static void update_scope_wave(void);
 static void limitar_curso(void);
 static void solicitar_salvar_curso(void);
 
@@ -134,33 +225,117 @@ esp_err_t interface_usuario_inicializar(const configuracao_curso_t *config, cons
     if (!config || !callbacks || !callbacks->ao_solicitar_salvar_curso) {
         return ESP_ERR_INVALID_ARG;
     }
-    s_config_curso = *config;
+    s_config_origem = config;
     s_callbacks = *callbacks;
 
-    ESP_RETURN_ON_ERROR(display_driver_init(&s_display_driver), TAG, "Falha init driver display");
-    build_ui();
-    show_startup_screen();
+    /* Mesmo nucleo de app_main: as ISRs do toque ficam junto das fontes de pulsos */
+    BaseType_t criada = xTaskCreatePinnedToCore(tarefa_partida_ui, "ui_partida", PILHA_PARTIDA_UI, NULL,
+                                                PRIORIDADE_PARTIDA_UI, NULL, xPortGetCoreID());
+    ESP_RETURN_ON_FALSE(criada == pdPASS, ESP_FAIL, TAG, "Falha ao criar tarefa de partida da UI");
     return ESP_OK;
 }
 
-void interface_usuario_atualizar(const dados_medidos_t *dados)
+/*
+ * Display e splash primeiro; os widgets esperam a configuracao, que app_main
+ * carrega da NVS enquanto isso. A splash e um timer do LVGL e some sozinha.
+ */
+static void tarefa_partida_ui(void *param)
 {
-    if (!dados) {
+    (void)param;
+    esp_err_t err = display_driver_init(&s_display_driver);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Falha init driver display (0x%x)", err);
+        vTaskDelete(NULL);
         return;
     }
+    show_startup_screen();
+    partida_marcar(PARTIDA_DISPLAY);
 
-    ui_data_t snapshot;
-    portENTER_CRITICAL(&s_ui_spinlock);
-    s_ui_snapshot = *dados;
-    snapshot = s_ui_snapshot;
-    portEXIT_CRITICAL(&s_ui_spinlock);
+    partida_aguardar(PARTIDA_CONFIGURACAO);
+    s_config_curso = *s_config_origem;
+    build_ui();
+    partida_marcar(PARTIDA_UI);
+    vTaskDelete(NULL);
+}
 
-    if (!lvgl_port_lock(portMAX_DELAY)) {
-        ESP_LOGW(TAG, "Nao foi possivel travar LVGL para atualizar UI");
+/*
+ * Timer do LVGL, na tarefa do LVGL e com o lock dela: puxa a publicacao mais
+ * nova do canal principal e aplica uma vez por quadro. Publicacoes que
+ * chegaram entre dois quadros se juntam nesta.
+ */
+static void puxar_medicao(lv_timer_t *timer)
+{
+    (void)timer;
+    const uint32_t versao_anterior = s_versao_ui;
+    dados_medidos_t dados;
+    if (!metricas_ler(0, &s_versao_ui, &dados)) {
         return;
     }
-    apply_ui_locked(&snapshot);
+    const bool primeira = versao_anterior == 0;
+    if (versao_anterior != 0) {
+        s_diagnostico.publicacoes_agrupadas += s_versao_ui - versao_anterior - 1U;
+    }
+
+    const int64_t inicio_us = esp_timer_get_time();
+    s_ui_snapshot = dados;
+    s_pixels_pendentes = 0;
+    apply_ui_locked(&s_ui_snapshot);
+    /* Layout pendente (textos que mudaram de largura) entra na conta desta atualizacao; o refresh faria o mesmo */
+    lv_obj_update_layout(lv_screen_active());
+    latencia_tela_aplicada(&s_ui_snapshot.carimbo);
+
+    const uint32_t tempo_us = (uint32_t)(esp_timer_get_time() - inicio_us);
+    s_diagnostico.tempo_ultima_us = tempo_us;
+    s_diagnostico.tempo_total_us += tempo_us;
+    if (tempo_us > s_diagnostico.tempo_maximo_us) {
+        s_diagnostico.tempo_maximo_us = tempo_us;
+    }
+    const uint32_t pixels = s_pixels_pendentes;
+    s_diagnostico.atualizacoes++;
+    s_diagnostico.atualizacoes_sem_redesenho += pixels == 0 ? 1U : 0U;
+    s_diagnostico.pixels_ultima = pixels;
+    s_diagnostico.pixels_atualizacoes += pixels;
+    if (pixels > s_diagnostico.pixels_maximo) {
+        s_diagnostico.pixels_maximo = pixels;
+    }
+    if (primeira) {
+        partida_marcar(PARTIDA_PRIMEIRA_MEDICAO);
+    }
+}
+
+static uint32_t contar_objetos(lv_obj_t *obj)
+{
+    uint32_t total = 1;
+    const uint32_t filhos = lv_obj_get_child_count(obj);
+    for (uint32_t i = 0; i < filhos; i++) {
+        total += contar_objetos(lv_obj_get_child(obj, (int32_t)i));
+    }
+    return total;
+}
+
+void interface_usuario_obter_diagnostico(interface_usuario_diagnostico_t *diagnostico)
+{
+    if (!diagnostico) {
+        return;
+    }
+    memset(diagnostico, 0, sizeof(*diagnostico));
+    if (!partida_concluida(PARTIDA_UI) || !lvgl_port_lock(portMAX_DELAY)) {
+        return;
+    }
+    *diagnostico = s_diagnostico;
+    diagnostico->pixels_total = s_pixels_total;
+    diagnostico->objetos = contar_objetos(lv_screen_active());
+    for (int i = 0; i < DISPLAY_MODE_COUNT; i++) {
+        if (s_subarvores[i].raiz) {
+            diagnostico->subarvores_montadas++;
+            diagnostico->subarvores_bytes += s_subarvores[i].bytes;
+        }
+    }
     lvgl_port_unlock();
+    /* LVGL usa o malloc da libc (CONFIG_LV_USE_CLIB_MALLOC): o heap e o do sistema */
+    diagnostico->heap_livre = heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
+    diagnostico->heap_livre_minimo = heap_caps_get_minimum_free_size(MALLOC_CAP_DEFAULT);
+    diagnostico->heap_maior_bloco = heap_caps_get_largest_free_block(MALLOC_CAP_DEFAULT);
 }
 
 void interface_usuario_configurar_curso(float curso_cm)
@@ -170,15 +345,54 @@ void interface_usuario_configurar_curso(float curso_cm)
     refresh_ui();
 }
 
-static void build_ui(void)
+esp_err_t interface_usuario_suspender(void)
 {
-    show_startup_screen();
+    ESP_RETURN_ON_FALSE(lvgl_port_lock(portMAX_DELAY), ESP_ERR_TIMEOUT, TAG, "lock LVGL");
+    const esp_err_t err = lvgl_port_stop();
+    lvgl_port_unlock();
+    ESP_RETURN_ON_ERROR(err, TAG, "lvgl_port_stop");
+    /* Tela apagada: sem escopo a desenhar, o sinal parado volta a dormir sem prazo */
+    metricas_definir_escopo_visivel(false);
+    display_driver_set_backlight(false);
+    return ESP_OK;
+}
+
+esp_err_t interface_usuario_retomar(bool acordou_por_toque)
+{
+    ESP_RETURN_ON_ERROR(display_driver_restart_panel(&s_display_driver), TAG, "Falha ao ressincronizar painel");
+    display_driver_set_backlight(true);
+    ESP_RETURN_ON_FALSE(lvgl_port_lock(portMAX_DELAY), ESP_ERR_TIMEOUT, TAG, "lock LVGL");
+    esp_err_t err = lvgl_port_resume();
+    lv_display_trigger_activity(LVGL_DISPLAY);
+    avisar_escopo_visivel();
+    if (acordou_por_toque && LVGL_TOUCH_INDEV) {
+        lv_indev_wait_release(LVGL_TOUCH_INDEV);
+    }
+    lvgl_port_unlock();
+    ESP_RETURN_ON_ERROR(err, TAG, "lvgl_port_resume");
+    /* Sem isso a tarefa do LVGL so olharia a fila no fim da espera maxima dela */
+    return lvgl_port_task_wake(LVGL_PORT_EVENT_USER, NULL);
+}
 
+uint32_t interface_usuario_inativo_ms(void)
+{
+    if (!partida_concluida(PARTIDA_UI) || !lvgl_port_lock(portMAX_DELAY)) {
+        return 0;
+    }
+    const uint32_t inativo_ms = lv_display_get_inactive_time(LVGL_DISPLAY);
+    lvgl_port_unlock();
+    return inativo_ms;
+}
+
+static void build_ui(void)
+{
     if (!lvgl_port_lock(portMAX_DELAY)) {
         ESP_LOGE(TAG, "Failed to lock LVGL");
         return;
     }
 
+    const size_t heap_antes = heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
+    tema_ui_inicializar(s_metric_colors, DISPLAY_MODE_COUNT);
     lv_obj_t *screen = lv_screen_active();
     lv_obj_set_style_bg_color(screen, lv_color_hex(0x101418), 0);
     s_layout_mode = UI_LAYOUT_GRID;
@@ -187,10 +401,7 @@ static void build_ui(void)
     lv_obj_remove_style_all(s_grid_container);
     lv_obj_set_size(s_grid_container, LV_PCT(100), LV_PCT(85));
     lv_obj_align(s_grid_container, LV_ALIGN_TOP_MID, 0, 0);
-    lv_obj_set_style_pad_all(s_grid_container, 16, 0);
-    lv_obj_set_style_pad_row(s_grid_container, 12, 0);
-    lv_obj_set_style_pad_column(s_grid_container, 16, 0);
-    lv_obj_set_style_bg_opa(s_grid_container, LV_OPA_TRANSP, 0);
+    tema_ui_aplicar(s_grid_container, TEMA_GRID);
     lv_obj_set_flex_flow(s_grid_container, LV_FLEX_FLOW_ROW_WRAP);
     lv_obj_set_flex_align(s_grid_container, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_SPACE_EVENLY);
 
@@ -198,30 +409,24 @@ static void build_ui(void)
         lv_obj_t *card = lv_obj_create(s_grid_container);
         lv_obj_remove_style_all(card);
         lv_obj_set_size(card, LV_PCT(48), 120);
-        lv_obj_set_style_radius(card, 14, 0);
-        lv_obj_set_style_pad_all(card, 16, 0);
-        lv_obj_set_style_bg_color(card, lv_color_hex(s_metric_colors[i]), 0);
-        lv_obj_set_style_bg_opa(card, LV_OPA_40, 0);
-        lv_obj_set_style_border_width(card, 0, 0);
+        tema_ui_aplicar(card, TEMA_CARD);
+        tema_ui_aplicar_cor_metrica(card, (size_t)i);
         lv_obj_set_flex_flow(card, LV_FLEX_FLOW_COLUMN);
         lv_obj_set_flex_align(card, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_SPACE_BETWEEN);
         lv_obj_add_flag(card, LV_OBJ_FLAG_CLICKABLE);
         lv_obj_add_event_cb(card, card_event_cb, LV_EVENT_ALL, (void *)(intptr_t)i);
 
         lv_obj_t *title = lv_label_create(card);
-        lv_obj_set_style_text_color(title, lv_color_hex(0xF5F5F5), 0);
-        lv_obj_set_style_text_font(title, &lv_font_montserrat_20, 0);
+        tema_ui_aplicar(title, TEMA_CARD_TITULO);
         lv_label_set_text(title, s_metric_titles[i]);
 
         lv_obj_t *value = lv_label_create(card);
-        lv_obj_set_style_text_color(value, lv_color_hex(0xFFFFFF), 0);
-        lv_obj_set_style_text_font(value, &lv_font_montserrat_28, 0);
-        lv_obj_set_style_text_align(value, LV_TEXT_ALIGN_LEFT, 0);
+        tema_ui_aplicar(value, TEMA_CARD_VALOR);
+        lv_obj_align(value, LV_ALIGN_CENTER, 0, -10);
         lv_label_set_text(value, "--");
 
         lv_obj_t *unit = lv_label_create(card);
-        lv_obj_set_style_text_color(unit, lv_color_hex(0xFFECB3), 0);
-        lv_obj_set_style_text_font(unit, &lv_font_montserrat_20, 0);
+        tema_ui_aplicar(unit, TEMA_CARD_UNIDADE);
         lv_label_set_text(unit, "");
 
         s_cards[i] = (card_ui_t){
@@ -233,8 +438,7 @@ static void build_ui(void)
     }
 
     s_status_label = lv_label_create(screen);
-    lv_obj_set_style_text_color(s_status_label, lv_color_hex(0xCCCCCC), 0);
-    lv_obj_set_style_text_font(s_status_label, &lv_font_montserrat_14, 0);
+    tema_ui_aplicar(s_status_label, TEMA_DICA);
     lv_obj_align(s_status_label, LV_ALIGN_BOTTOM_MID, 0, -12);
     lv_label_set_text(s_status_label, "Toque em um painel para ampliar");
 
@@ -242,168 +446,245 @@ static void build_ui(void)
     lv_obj_remove_style_all(s_fullscreen_container);
     lv_obj_set_size(s_fullscreen_container, LV_PCT(100), LV_PCT(100));
     lv_obj_align(s_fullscreen_container, LV_ALIGN_CENTER, 0, 0);
-    lv_obj_set_style_bg_color(s_fullscreen_container, lv_color_hex(0x111111), 0);
-    lv_obj_set_style_bg_opa(s_fullscreen_container, LV_OPA_COVER, 0);
-    lv_obj_set_style_pad_all(s_fullscreen_container, 32, 0);
+    tema_ui_aplicar(s_fullscreen_container, TEMA_TELA_CHEIA);
     lv_obj_add_flag(s_fullscreen_container, LV_OBJ_FLAG_HIDDEN);
     lv_obj_add_flag(s_fullscreen_container, LV_OBJ_FLAG_CLICKABLE);
     lv_obj_add_event_cb(s_fullscreen_container, fullscreen_event_cb, LV_EVENT_ALL, NULL);
 
     s_full_title = lv_label_create(s_fullscreen_container);
-    lv_obj_set_style_text_color(s_full_title, lv_color_hex(0xFFFFFF), 0);
-    lv_obj_set_style_text_font(s_full_title, &lv_font_montserrat_28, 0);
-    lv_obj_set_style_text_align(s_full_title, LV_TEXT_ALIGN_CENTER, 0);
+    tema_ui_aplicar(s_full_title, TEMA_TITULO);
     lv_obj_align(s_full_title, LV_ALIGN_TOP_MID, 0, 8);
 
-    s_full_value = lv_label_create(s_fullscreen_container);
-    lv_obj_set_style_text_color(s_full_value, lv_color_hex(0xFFFFFF), 0);
-    lv_obj_set_style_text_font(s_full_value, &lv_font_montserrat_48, 0);
-    lv_obj_set_style_text_align(s_full_value, LV_TEXT_ALIGN_CENTER, 0);
+    s_full_value = mostrador_digitos_criar(s_fullscreen_container, &lv_font_montserrat_48, lv_color_hex(0xFFFFFF),
+                                           lv_color_hex(0x111111));
     lv_obj_align(s_full_value, LV_ALIGN_CENTER, 0, -80);
 
     s_full_unit = lv_label_create(s_fullscreen_container);
-    lv_obj_set_style_text_color(s_full_unit, lv_color_hex(0xF5F5F5), 0);
-    lv_obj_set_style_text_font(s_full_unit, &lv_font_montserrat_28, 0);
-    lv_obj_set_style_text_align(s_full_unit, LV_TEXT_ALIGN_CENTER, 0);
+    tema_ui_aplicar(s_full_unit, TEMA_UNIDADE);
     lv_obj_align_to(s_full_unit, s_full_value, LV_ALIGN_OUT_BOTTOM_MID, 0, 6);
 
-    s_full_arc = lv_arc_create(s_fullscreen_container);
+    s_full_timer_label = lv_label_create(s_fullscreen_container);
+    tema_ui_aplicar(s_full_timer_label, TEMA_TEXTO_AUXILIAR);
+    lv_obj_align(s_full_timer_label, LV_ALIGN_CENTER, 0, 120);
+    lv_obj_add_flag(s_full_timer_label, LV_OBJ_FLAG_HIDDEN);
+
+    s_full_status = lv_obj_create(s_fullscreen_container);
+    lv_obj_remove_style_all(s_full_status);
+    lv_obj_set_size(s_full_status, LV_PCT(100), LV_SIZE_CONTENT);
+    lv_obj_set_style_pad_all(s_full_status, 0, 0);
+    lv_obj_set_style_bg_opa(s_full_status, LV_OPA_TRANSP, 0);
+    lv_obj_set_flex_flow(s_full_status, LV_FLEX_FLOW_ROW_WRAP);
+    lv_obj_set_flex_align(s_full_status, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    lv_obj_align(s_full_status, LV_ALIGN_BOTTOM_MID, 0, -12);
+
+    /* Pool fixo: a atualizacao so troca texto, cor e visibilidade, sem alocar no heap */
+    for (size_t i = 0; i < STATUS_MAX_SEGMENTOS; i++) {
+        lv_obj_t *sep = lv_label_create(s_full_status);
+        lv_label_set_text(sep, "|");
+        tema_ui_aplicar(sep, TEMA_SEPARADOR);
+        lv_obj_add_flag(sep, LV_OBJ_FLAG_HIDDEN);
+
+        lv_obj_t *lbl = lv_label_create(s_full_status);
+        tema_ui_aplicar(lbl, TEMA_TEXTO_STATUS);
+        lv_obj_add_flag(lbl, LV_OBJ_FLAG_HIDDEN);
+
+        s_status_segmentos[i] = (segmento_status_t){.separador = sep, .label = lbl};
+        lv_label_set_text_static(lbl, s_status_segmentos[i].texto);
+    }
+
+    tela_tendencia_criar(screen, ao_sair_tendencia);
+
+    apply_ui_locked(&s_ui_snapshot);
+    latencia_tela_inicializar(LVGL_DISPLAY);
+    if (LVGL_DISPLAY) {
+        lv_display_add_event_cb(LVGL_DISPLAY, ao_invalidar_area, LV_EVENT_INVALIDATE_AREA, NULL);
+        lv_display_add_event_cb(LVGL_DISPLAY, ao_renderizar, LV_EVENT_RENDER_START, NULL);
+        lv_display_add_event_cb(LVGL_DISPLAY, ao_renderizar, LV_EVENT_RENDER_READY, NULL);
+    }
+    /* Criado depois do display: o LVGL poe timers novos no inicio da lista, entao
+     * ele roda antes do refresh na mesma passada e o quadro ja sai com a medicao */
+    lv_timer_create(puxar_medicao, LV_DEF_REFR_PERIOD, NULL);
+
+    const size_t heap_depois = heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
+    s_diagnostico.heap_ui_bytes = heap_antes > heap_depois ? (uint32_t)(heap_antes - heap_depois) : 0U;
+    lvgl_port_unlock();
+    ESP_LOGI(TAG, "UI montada com %" PRIu32 " bytes de heap", s_diagnostico.heap_ui_bytes);
+}
+
+/* Subarvores de cada modo: criadas na primeira vez que o modo abre (ver garantir_subarvore) */
+static void construir_frequencia(lv_obj_t *raiz)
+{
+    s_full_scope_chart = lv_chart_create(raiz);
+    lv_obj_set_size(s_full_scope_chart, LV_PCT(82), 162);
+    lv_obj_align(s_full_scope_chart, LV_ALIGN_CENTER, 0, -20);
+    lv_chart_set_point_count(s_full_scope_chart, SCOPE_POINT_COUNT);
+    lv_chart_set_range(s_full_scope_chart, LV_CHART_AXIS_PRIMARY_Y, -100, 100);
+    lv_chart_set_type(s_full_scope_chart, LV_CHART_TYPE_LINE);
+    /* Circular: cada coluna nova invalida so o proprio ponto, sem deslocar o grafico inteiro */
+    lv_chart_set_update_mode(s_full_scope_chart, LV_CHART_UPDATE_MODE_CIRCULAR);
+    s_full_scope_series_max = lv_chart_add_series(s_full_scope_chart, lv_color_hex(0x00FFC0), LV_CHART_AXIS_PRIMARY_Y);
+    s_full_scope_series_min = lv_chart_add_series(s_full_scope_chart, lv_color_hex(0x00FFC0), LV_CHART_AXIS_PRIMARY_Y);
+}
+
+static void construir_rpm(lv_obj_t *raiz)
+{
+    s_full_arc = lv_arc_create(raiz);
     lv_obj_set_size(s_full_arc, 288, 288);
     lv_arc_set_rotation(s_full_arc, 135);
     lv_arc_set_bg_angles(s_full_arc, 0, 270);
+    lv_arc_set_range(s_full_arc, 0, 15000);
     lv_arc_set_value(s_full_arc, 0);
     lv_obj_remove_style(s_full_arc, NULL, LV_PART_KNOB);
-    lv_obj_set_style_arc_width(s_full_arc, 14, LV_PART_MAIN);
-    lv_obj_set_style_arc_width(s_full_arc, 14, LV_PART_INDICATOR);
-    lv_obj_add_flag(s_full_arc, LV_OBJ_FLAG_HIDDEN);
-    lv_obj_align(s_full_arc, LV_ALIGN_CENTER, 0, 70);
-
-    s_full_arc_label = lv_label_create(s_fullscreen_container);
-    lv_obj_set_style_text_color(s_full_arc_label, lv_color_hex(0xE0E0E0), 0);
-    lv_obj_set_style_text_font(s_full_arc_label, &lv_font_montserrat_20, 0);
-    lv_obj_set_style_text_align(s_full_arc_label, LV_TEXT_ALIGN_CENTER, 0);
-    lv_obj_align(s_full_arc_label, LV_ALIGN_CENTER, 0, 160);
-    lv_obj_add_flag(s_full_arc_label, LV_OBJ_FLAG_HIDDEN);
+    tema_ui_aplicar(s_full_arc, TEMA_ARCO_RPM);
+    lv_obj_align(s_full_arc, LV_ALIGN_CENTER, 0, 10);
 
-    s_full_bar = lv_bar_create(s_fullscreen_container);
-    lv_bar_set_range(s_full_bar, 0, 100000);
-    lv_obj_set_size(s_full_bar, LV_PCT(80), 16);
-    lv_obj_align(s_full_bar, LV_ALIGN_CENTER, 0, 60);
-    lv_obj_set_style_bg_color(s_full_bar, lv_color_hex(0x1E1E1E), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(s_full_bar, LV_OPA_40, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(s_full_bar, 8, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_color(s_full_bar, lv_color_hex(0x00E676), LV_PART_INDICATOR | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(s_full_bar, LV_OPA_COVER, LV_PART_INDICATOR | LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(s_full_bar, 8, LV_PART_INDICATOR | LV_STATE_DEFAULT);
-    lv_obj_add_flag(s_full_bar, LV_OBJ_FLAG_HIDDEN);
-
-    s_full_bar_label = lv_label_create(s_fullscreen_container);
-    lv_obj_set_style_text_color(s_full_bar_label, lv_color_hex(0xE0E0E0), 0);
-    lv_obj_set_style_text_font(s_full_bar_label, &lv_font_montserrat_20, 0);
-    lv_obj_align(s_full_bar_label, LV_ALIGN_CENTER, 0, 90);
-    lv_obj_add_flag(s_full_bar_label, LV_OBJ_FLAG_HIDDEN);
-
-    s_full_timer_label = lv_label_create(s_fullscreen_container);
-    lv_obj_set_style_text_color(s_full_timer_label, lv_color_hex(0xE0E0E0), 0);
-    lv_obj_set_style_text_font(s_full_timer_label, &lv_font_montserrat_20, 0);
-    lv_obj_align(s_full_timer_label, LV_ALIGN_CENTER, 0, 120);
-    lv_obj_add_flag(s_full_timer_label, LV_OBJ_FLAG_HIDDEN);
+    s_full_arc_label = lv_label_create(raiz);
+    tema_ui_aplicar(s_full_arc_label, TEMA_TEXTO_AUXILIAR);
+    lv_obj_align(s_full_arc_label, LV_ALIGN_CENTER, 0, 160);
+    lv_label_set_text(s_full_arc_label, "0 - 15k rpm");
+}
 
-    s_speed_bar = lv_bar_create(s_fullscreen_container);
+static void construir_velocidade(lv_obj_t *raiz)
+{
+    s_speed_bar = lv_bar_create(raiz);
     lv_bar_set_range(s_speed_bar, 0, 500);
     lv_obj_set_size(s_speed_bar, LV_PCT(80), 22);
-    lv_obj_align(s_speed_bar, LV_ALIGN_CENTER, 0, 70);
-    lv_obj_set_style_bg_color(s_speed_bar, lv_color_hex(0x0E111B), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_grad_color(s_speed_bar, lv_color_hex(0x05070D), LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_grad_dir(s_speed_bar, LV_GRAD_DIR_HOR, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(s_speed_bar, LV_OPA_COVER, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(s_speed_bar, 12, LV_PART_MAIN | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_color(s_speed_bar, lv_color_hex(0x00C9FF), LV_PART_INDICATOR | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_grad_color(s_speed_bar, lv_color_hex(0x6A1B9A), LV_PART_INDICATOR | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_grad_dir(s_speed_bar, LV_GRAD_DIR_HOR, LV_PART_INDICATOR | LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(s_speed_bar, LV_OPA_COVER, LV_PART_INDICATOR | LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(s_speed_bar, 12, LV_PART_INDICATOR | LV_STATE_DEFAULT);
-    lv_obj_add_flag(s_speed_bar, LV_OBJ_FLAG_HIDDEN);
-
-    s_speed_bar_label = lv_label_create(s_fullscreen_container);
-    lv_obj_set_style_text_color(s_speed_bar_label, lv_color_hex(0xB0BEC5), 0);
-    lv_obj_set_style_text_font(s_speed_bar_label, &lv_font_montserrat_20, 0);
-    lv_obj_align(s_speed_bar_label, LV_ALIGN_CENTER, 0, 110);
-    lv_obj_add_flag(s_speed_bar_label, LV_OBJ_FLAG_HIDDEN);
-
-    s_furos_circle_left = lv_arc_create(s_fullscreen_container);
-    lv_obj_set_size(s_furos_circle_left, 72, 72);
-    lv_arc_set_rotation(s_furos_circle_left, 270);
-    lv_arc_set_bg_angles(s_furos_circle_left, 0, 360);
-    lv_arc_set_range(s_furos_circle_left, 0, 500);
-    lv_arc_set_value(s_furos_circle_left, 0);
-    lv_obj_remove_style(s_furos_circle_left, NULL, LV_PART_KNOB);
-    lv_obj_set_style_arc_width(s_furos_circle_left, 6, LV_PART_MAIN);
-    lv_obj_set_style_arc_width(s_furos_circle_left, 6, LV_PART_INDICATOR);
-    lv_obj_set_style_arc_opa(s_furos_circle_left, LV_OPA_COVER, LV_PART_MAIN);
-    lv_obj_set_style_arc_color(s_furos_circle_left, lv_color_hex(0xFFE0B2), LV_PART_MAIN);
-    lv_obj_set_style_arc_color(s_furos_circle_left, lv_color_hex(0xFF7043), LV_PART_INDICATOR);
-    lv_obj_add_flag(s_furos_circle_left, LV_OBJ_FLAG_HIDDEN);
-
-    s_furos_circle_right = lv_arc_create(s_fullscreen_container);
-    lv_obj_set_size(s_furos_circle_right, 72, 72);
-    lv_arc_set_rotation(s_furos_circle_right, 270);
-    lv_arc_set_bg_angles(s_furos_circle_right, 0, 360);
-    lv_arc_set_range(s_furos_circle_right, 0, 500);
-    lv_arc_set_value(s_furos_circle_right, 0);
-    lv_obj_remove_style(s_furos_circle_right, NULL, LV_PART_KNOB);
-    lv_obj_set_style_arc_width(s_furos_circle_right, 6, LV_PART_MAIN);
-    lv_obj_set_style_arc_width(s_furos_circle_right, 6, LV_PART_INDICATOR);
-    lv_obj_set_style_arc_opa(s_furos_circle_right, LV_OPA_COVER, LV_PART_MAIN);
-    lv_obj_set_style_arc_color(s_furos_circle_right, lv_color_hex(0xFFE0B2), LV_PART_MAIN);
-    lv_obj_set_style_arc_color(s_furos_circle_right, lv_color_hex(0xFF7043), LV_PART_INDICATOR);
-    lv_obj_add_flag(s_furos_circle_right, LV_OBJ_FLAG_HIDDEN);
-
-    s_full_scope_chart = lv_chart_create(s_fullscreen_container);
-    lv_obj_set_size(s_full_scope_chart, LV_PCT(82), 162);
-    lv_obj_align(s_full_scope_chart, LV_ALIGN_CENTER, 0, -5);
-    lv_chart_set_point_count(s_full_scope_chart, SCOPE_POINT_COUNT);
-    lv_chart_set_range(s_full_scope_chart, LV_CHART_AXIS_PRIMARY_Y, -100, 100);
-    lv_chart_set_type(s_full_scope_chart, LV_CHART_TYPE_LINE);
-    lv_chart_set_update_mode(s_full_scope_chart, LV_CHART_UPDATE_MODE_SHIFT);
-    lv_obj_add_flag(s_full_scope_chart, LV_OBJ_FLAG_HIDDEN);
-    s_full_scope_series = lv_chart_add_series(s_full_scope_chart, lv_color_hex(0x00FFC0), LV_CHART_AXIS_PRIMARY_Y);
-
-    s_full_scope_axis_label = lv_label_create(s_fullscreen_container);
-    lv_obj_set_style_text_color(s_full_scope_axis_label, lv_color_hex(0xE0E0E0), 0);
-    lv_obj_set_style_text_font(s_full_scope_axis_label, &lv_font_montserrat_20, 0);
-    lv_obj_set_style_text_align(s_full_scope_axis_label, LV_TEXT_ALIGN_CENTER, 0);
-    lv_obj_align_to(s_full_scope_axis_label, s_full_scope_chart, LV_ALIGN_OUT_BOTTOM_MID, 0, 6);
-    lv_obj_add_flag(s_full_scope_axis_label, LV_OBJ_FLAG_HIDDEN);
-
-    s_full_course_arc = lv_arc_create(s_fullscreen_container);
+    lv_obj_align(s_speed_bar, LV_ALIGN_CENTER, 0, 60);
+    tema_ui_aplicar(s_speed_bar, TEMA_BARRA_VELOCIDADE);
+
+    s_speed_bar_label = lv_label_create(raiz);
+    tema_ui_aplicar(s_speed_bar_label, TEMA_LEGENDA_VELOCIDADE);
+    lv_obj_align(s_speed_bar_label, LV_ALIGN_CENTER, 0, 100);
+}
+
+static void construir_curso(lv_obj_t *raiz)
+{
+    s_full_course_arc = lv_arc_create(raiz);
     lv_arc_set_rotation(s_full_course_arc, 135);
     lv_arc_set_bg_angles(s_full_course_arc, 0, 270);
     lv_arc_set_range(s_full_course_arc, 100, 500);
     lv_arc_set_value(s_full_course_arc, 100);
     lv_obj_remove_style(s_full_course_arc, NULL, LV_PART_KNOB);
-    lv_obj_set_style_arc_width(s_full_course_arc, 12, LV_PART_MAIN);
-    lv_obj_set_style_arc_width(s_full_course_arc, 12, LV_PART_INDICATOR);
-    lv_obj_add_flag(s_full_course_arc, LV_OBJ_FLAG_HIDDEN);
+    tema_ui_aplicar(s_full_course_arc, TEMA_ARCO_CURSO);
+    lv_obj_align(s_full_course_arc, LV_ALIGN_CENTER, 0, -5);
+}
 
-    s_full_status = lv_obj_create(s_fullscreen_container);
-    lv_obj_remove_style_all(s_full_status);
-    lv_obj_set_size(s_full_status, LV_PCT(100), LV_SIZE_CONTENT);
-    lv_obj_set_style_pad_all(s_full_status, 0, 0);
-    lv_obj_set_style_bg_opa(s_full_status, LV_OPA_TRANSP, 0);
-    lv_obj_set_flex_flow(s_full_status, LV_FLEX_FLOW_ROW_WRAP);
-    lv_obj_set_flex_align(s_full_status, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
-    lv_obj_align(s_full_status, LV_ALIGN_BOTTOM_MID, 0, -12);
+static void construir_distancia(lv_obj_t *raiz)
+{
+    s_full_bar = lv_bar_create(raiz);
+    lv_bar_set_range(s_full_bar, 0, 100000);
+    lv_obj_set_size(s_full_bar, LV_PCT(80), 16);
+    lv_obj_align(s_full_bar, LV_ALIGN_CENTER, 0, 60);
+    tema_ui_aplicar(s_full_bar, TEMA_BARRA_DISTANCIA);
 
-    ui_data_t snapshot;
-    portENTER_CRITICAL(&s_ui_spinlock);
-    snapshot = s_ui_snapshot;
-    portEXIT_CRITICAL(&s_ui_spinlock);
-    apply_ui_locked(&snapshot);
+    s_full_bar_label = lv_label_create(raiz);
+    tema_ui_aplicar(s_full_bar_label, TEMA_TEXTO_AUXILIAR);
+    lv_obj_align(s_full_bar_label, LV_ALIGN_CENTER, 0, 90);
+}
 
-    lvgl_port_unlock();
+static lv_obj_t *criar_circulo_furos(lv_obj_t *raiz)
+{
+    lv_obj_t *circulo = lv_arc_create(raiz);
+    lv_obj_set_size(circulo, 72, 72);
+    lv_arc_set_rotation(circulo, 270);
+    lv_arc_set_bg_angles(circulo, 0, 360);
+    lv_arc_set_range(circulo, 0, 500);
+    lv_arc_set_value(circulo, 0);
+    lv_obj_remove_style(circulo, NULL, LV_PART_KNOB);
+    tema_ui_aplicar(circulo, TEMA_CIRCULO_FUROS);
+    lv_obj_add_flag(circulo, LV_OBJ_FLAG_HIDDEN);
+    return circulo;
 }
 
+static void construir_furos(lv_obj_t *raiz)
+{
+    s_furos_circle_left = criar_circulo_furos(raiz);
+    s_furos_circle_right = criar_circulo_furos(raiz);
+}
+
+static const subarvore_modo_t s_modos_fullscreen[DISPLAY_MODE_COUNT] = {
+    [DISPLAY_FREQUENCIA] = {construir_frequencia, {&s_full_scope_chart}},
+    [DISPLAY_RPM] = {construir_rpm, {&s_full_arc, &s_full_arc_label}},
+    [DISPLAY_VELOCIDADE] = {construir_velocidade, {&s_speed_bar, &s_speed_bar_label}},
+    [DISPLAY_CURSO] = {construir_curso, {&s_full_course_arc}},
+    [DISPLAY_DISTANCIA] = {construir_distancia, {&s_full_bar, &s_full_bar_label}},
+    [DISPLAY_FUROS] = {construir_furos, {&s_furos_circle_left, &s_furos_circle_right}},
+};
+
+/* Monta a subarvore do modo se ainda nao existir; o custo no heap e medido na hora */
+static void garantir_subarvore(display_mode_t mode)
+{
+    subarvore_t *subarvore = &s_subarvores[mode];
+    subarvore->ultimo_uso = ++s_aberturas;
+    if (subarvore->raiz) {
+        return;
+    }
+    const size_t livre_antes = heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
+    lv_obj_t *raiz = lv_obj_create(s_fullscreen_container);
+    lv_obj_remove_style_all(raiz);
+    lv_obj_set_size(raiz, LV_PCT(100), LV_PCT(100));
+    lv_obj_clear_flag(raiz, LV_OBJ_FLAG_CLICKABLE);
+    /* Abaixo da barra de status, como se tivesse sido criada no boot */
+    lv_obj_move_to_index(raiz, lv_obj_get_index(s_full_status));
+    s_modos_fullscreen[mode].construir(raiz);
+    const size_t livre_depois = heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
+
+    subarvore->raiz = raiz;
+    /* Estimativa: outras tarefas podem alocar ou liberar no meio */
+    subarvore->bytes = livre_antes > livre_depois ? (uint32_t)(livre_antes - livre_depois) : 0U;
+    s_diagnostico.subarvores_construidas++;
+}
+
+static void liberar_subarvore(display_mode_t mode)
+{
+    subarvore_t *subarvore = &s_subarvores[mode];
+    if (!subarvore->raiz) {
+        return;
+    }
+    lv_obj_delete(subarvore->raiz);
+    for (size_t i = 0; i < SUBARVORE_MAX_WIDGETS; i++) {
+        if (s_modos_fullscreen[mode].widgets[i]) {
+            *s_modos_fullscreen[mode].widgets[i] = NULL;
+        }
+    }
+    if (mode == DISPLAY_FREQUENCIA) {
+        s_full_scope_series_max = NULL;
+        s_full_scope_series_min = NULL;
+    }
+    *subarvore = (subarvore_t){0};
+    s_diagnostico.subarvores_liberadas++;
+}
+
+/*
+ * Orcamento das subarvores ocultas (CONFIG_CONTADOR_UI_ORCAMENTO_TELAS_KB):
+ * libera as usadas ha mais tempo ate caber. `ativa` nunca sai;
+ * DISPLAY_MODE_COUNT quando nenhuma esta na tela.
+ */
+static void aplicar_orcamento_subarvores(display_mode_t ativa)
+{
+    const uint32_t orcamento = (uint32_t)CONFIG_CONTADOR_UI_ORCAMENTO_TELAS_KB * 1024U;
+    while (true) {
+        uint32_t ocupado = 0;
+        int mais_antiga = -1;
+        for (int i = 0; i < DISPLAY_MODE_COUNT; i++) {
+            const subarvore_t *subarvore = &s_subarvores[i];
+            if (!subarvore->raiz || i == (int)ativa) {
+                continue;
+            }
+            ocupado += subarvore->bytes;
+            if (mais_antiga < 0 || subarvore->ultimo_uso < s_subarvores[mais_antiga].ultimo_uso) {
+                mais_antiga = i;
+            }
+        }
+        /* Orcamento zero libera todas, mesmo as de custo medido zero */
+        if (mais_antiga < 0 || (ocupado <= orcamento && orcamento > 0)) {
+            return;
+        }
+        liberar_subarvore((display_mode_t)mais_antiga);
+    }
+}
+
+/* Na camada de cima: os widgets podem ser montados por baixo enquanto ela aparece */
 static void show_startup_screen(void)
 {
     if (!lvgl_port_lock(portMAX_DELAY)) {
@@ -411,13 +692,14 @@ static void show_startup_screen(void)
         return;
     }
 
-    lv_obj_t *screen = lv_screen_active();
-    lv_obj_t *overlay = lv_obj_create(screen);
+    lv_obj_t *overlay = lv_obj_create(lv_layer_top());
     lv_obj_remove_style_all(overlay);
     lv_obj_set_size(overlay, LV_PCT(100), LV_PCT(100));
     lv_obj_align(overlay, LV_ALIGN_CENTER, 0, 0);
     lv_obj_set_style_bg_opa(overlay, LV_OPA_COVER, 0);
     lv_obj_set_style_bg_color(overlay, lv_color_hex(0x000000), 0);
+    /* Clicavel: toques durante o boot nao chegam aos cards */
+    lv_obj_add_flag(overlay, LV_OBJ_FLAG_CLICKABLE);
 
     lv_obj_t *logo_img = lv_image_create(overlay);
     lv_image_set_src(logo_img, &liga_d_logo);
@@ -438,26 +720,35 @@ static void show_startup_screen(void)
     }
     lv_obj_set_style_transform_scale(logo_img, target_scale, 0);
 
-    lv_obj_t *status = lv_label_create(overlay);
-    lv_obj_set_style_text_color(status, lv_color_hex(0xFFFFFF), 0);
-    lv_obj_set_style_text_font(status, &lv_font_montserrat_20, 0);
-    lv_label_set_text(status, "Inicializando sistema...");
-    lv_obj_align(status, LV_ALIGN_BOTTOM_MID, 0, -40);
+    s_splash_status = lv_label_create(overlay);
+    lv_obj_set_style_text_color(s_splash_status, lv_color_hex(0xFFFFFF), 0);
+    lv_obj_set_style_text_font(s_splash_status, &lv_font_montserrat_20, 0);
+    lv_label_set_text(s_splash_status, "Inicializando sistema...");
+    lv_obj_align(s_splash_status, LV_ALIGN_BOTTOM_MID, 0, -40);
 
+    lv_timer_create(atualizar_splash, SPLASH_INTERVALO_MS, overlay);
     lvgl_port_unlock();
-    vTaskDelay(pdMS_TO_TICKS(3000));
-
-    if (lvgl_port_lock(portMAX_DELAY)) {
-        lv_label_set_text(status, "Sistema inicializado");
-        lvgl_port_unlock();
-    }
-
-    vTaskDelay(pdMS_TO_TICKS(3000));
+}
 
-    if (lvgl_port_lock(portMAX_DELAY)) {
-        lv_obj_del(overlay);
-        lvgl_port_unlock();
+/* Timer da splash: mostra a fase que falta e some assim que tudo estiver pronto */
+static void atualizar_splash(lv_timer_t *timer)
+{
+    lv_obj_t *overlay = lv_timer_get_user_data(timer);
+    if (!partida_pronta()) {
+        const char *texto = "Iniciando medicao...";
+        if (!partida_concluida(PARTIDA_CONFIGURACAO)) {
+            texto = "Carregando configuracao...";
+        } else if (!partida_concluida(PARTIDA_UI)) {
+            texto = "Montando interface...";
+        }
+        label_definir_texto(s_splash_status, texto);
+        return;
     }
+    lv_timer_delete(timer);
+    s_splash_status = NULL;
+    lv_obj_fade_out(overlay, SPLASH_FADE_MS, 0);
+    lv_obj_delete_delayed(overlay, SPLASH_FADE_MS);
+    partida_marcar(PARTIDA_SPLASH_FECHADA);
 }
 
 static void card_event_cb(lv_event_t *event)
@@ -479,6 +770,11 @@ static void fullscreen_event_cb(lv_event_t *event)
         return;
     }
 
+    if (code == LV_EVENT_LONG_PRESSED && s_display_mode != DISPLAY_CURSO) {
+        show_tendencia(s_display_mode);
+        return;
+    }
+
     if (s_display_mode != DISPLAY_CURSO) {
         return;
     }
@@ -503,14 +799,17 @@ static void fullscreen_event_cb(lv_event_t *event)
     }
 
     if (ui_changed) {
-        ui_data_t snapshot;
-        portENTER_CRITICAL(&s_ui_spinlock);
-        snapshot = s_ui_snapshot;
-        portEXIT_CRITICAL(&s_ui_spinlock);
-        apply_ui_locked(&snapshot);
+        apply_ui_locked(&s_ui_snapshot);
     }
 }
 
+/* O osciloscopio so existe na tela cheia de frequencia; fora dela a tarefa de metricas volta ao ritmo do governador */
+static void avisar_escopo_visivel(void)
+{
+    metricas_definir_escopo_visivel(s_layout_mode == UI_LAYOUT_FULLSCREEN && s_display_mode == DISPLAY_FREQUENCIA &&
+                                    !lv_obj_has_flag(s_fullscreen_container, LV_OBJ_FLAG_HIDDEN));
+}
+
 static void show_fullscreen(display_mode_t mode)
 {
     s_layout_mode = UI_LAYOUT_FULLSCREEN;
@@ -518,12 +817,33 @@ static void show_fullscreen(display_mode_t mode)
     lv_obj_add_flag(s_grid_container, LV_OBJ_FLAG_HIDDEN);
     lv_obj_add_flag(s_status_label, LV_OBJ_FLAG_HIDDEN);
     lv_obj_clear_flag(s_fullscreen_container, LV_OBJ_FLAG_HIDDEN);
+    configurar_fullscreen(mode);
+    avisar_escopo_visivel();
+
+    apply_ui_locked(&s_ui_snapshot);
+}
+
+/* Pressao longa na tela cheia de frequencia, RPM ou velocidade abre a tendencia */
+static void show_tendencia(display_mode_t mode)
+{
+    tendencia_metrica_t metrica;
+    if (mode == DISPLAY_FREQUENCIA) {
+        metrica = TENDENCIA_FREQUENCIA;
+    } else if (mode == DISPLAY_RPM) {
+        metrica = TENDENCIA_RPM;
+    } else if (mode == DISPLAY_VELOCIDADE) {
+        metrica = TENDENCIA_VELOCIDADE;
+    } else {
+        return;
+    }
+    lv_obj_add_flag(s_fullscreen_container, LV_OBJ_FLAG_HIDDEN);
+    avisar_escopo_visivel();
+    tela_tendencia_mostrar(metrica);
+}
 
-    ui_data_t snapshot;
-    portENTER_CRITICAL(&s_ui_spinlock);
-    snapshot = s_ui_snapshot;
-    portEXIT_CRITICAL(&s_ui_spinlock);
-    apply_ui_locked(&snapshot);
+static void ao_sair_tendencia(void)
+{
+    show_fullscreen(s_display_mode);
 }
 
 static void show_grid(void)
@@ -535,39 +855,39 @@ static void show_grid(void)
     lv_obj_clear_flag(s_grid_container, LV_OBJ_FLAG_HIDDEN);
     lv_obj_clear_flag(s_status_label, LV_OBJ_FLAG_HIDDEN);
     lv_obj_add_flag(s_fullscreen_container, LV_OBJ_FLAG_HIDDEN);
+    avisar_escopo_visivel();
+    aplicar_orcamento_subarvores(DISPLAY_MODE_COUNT);
 
-    ui_data_t snapshot;
-    portENTER_CRITICAL(&s_ui_spinlock);
-    snapshot = s_ui_snapshot;
-    portEXIT_CRITICAL(&s_ui_spinlock);
-    apply_ui_locked(&snapshot);
+    apply_ui_locked(&s_ui_snapshot);
 }
 
 static void refresh_ui(void)
 {
-    ui_data_t snapshot;
-    portENTER_CRITICAL(&s_ui_spinlock);
-    snapshot = s_ui_snapshot;
-    portEXIT_CRITICAL(&s_ui_spinlock);
-
+    if (!partida_concluida(PARTIDA_UI)) {
+        return;
+    }
     if (!lvgl_port_lock(portMAX_DELAY)) {
         ESP_LOGW(TAG, "Nao foi possivel travar LVGL para atualizar UI");
         return;
     }
-    apply_ui_locked(&snapshot);
+    apply_ui_locked(&s_ui_snapshot);
     lvgl_port_unlock();
 }
 
 static void apply_ui_locked(const ui_data_t *data)
 {
-    update_cards_ui(data);
-
     if (s_layout_mode == UI_LAYOUT_FULLSCREEN) {
+        /* Cards ocultos ficam com a chave antiga e se atualizam na volta ao grid */
         update_fullscreen_ui(data);
-    } else if (s_status_label) {
-        lv_label_set_text_fmt(s_status_label,
-                              "Curso: %.1f mm | Toque em um painel para ampliar (duplo clique para voltar)",
-                              s_config_curso.curso_cm * 10.0f);
+    } else {
+        update_cards_ui(data);
+        if (s_status_label) {
+            char status[96];
+            snprintf(status, sizeof(status),
+                     "Curso: %.1f mm | Toque em um painel para ampliar (duplo clique para voltar)",
+                     s_config_curso.curso_cm * 10.0f);
+            label_definir_texto(s_status_label, status);
+        }
     }
 }
 
@@ -575,24 +895,66 @@ static void update_cards_ui(const ui_data_t *data)
 {
     for (int i = 0; i < DISPLAY_MODE_COUNT; i++) {
         card_ui_t *card = &s_cards[i];
-        if (!card->label_valor) {
+        if (!card->label_valor || !cache_mudou(&card->cache_valor, chave_metrica((display_mode_t)i, data))) {
             continue;
         }
         char valor[48];
         char unidade[32];
         get_metric_text((display_mode_t)i, data, valor, sizeof(valor), unidade, sizeof(unidade));
-        lv_label_set_text(card->label_titulo, s_metric_titles[i]);
-        lv_obj_set_style_text_align(card->label_valor, LV_TEXT_ALIGN_LEFT, 0);
-        lv_obj_align(card->label_valor, LV_ALIGN_CENTER, 0, -10);
-        lv_label_set_text(card->label_valor, valor);
-
-        if (strlen(unidade) > 0) {
-            lv_label_set_text(card->label_unidade, unidade);
-            lv_obj_clear_flag(card->label_unidade, LV_OBJ_FLAG_HIDDEN);
-        } else {
-            lv_obj_add_flag(card->label_unidade, LV_OBJ_FLAG_HIDDEN);
+        label_definir_texto(card->label_valor, valor);
+        label_definir_texto(card->label_unidade, unidade);
+        obj_definir_oculto(card->label_unidade, unidade[0] == '\0');
+    }
+}
+
+/* Cor, titulo e widgets visiveis dependem so do modo: aplicados na troca, nao a cada medicao */
+static void configurar_fullscreen(display_mode_t mode)
+{
+    tema_ui_aplicar_cor_metrica(s_fullscreen_container, (size_t)mode);
+    mostrador_digitos_definir_fundo(s_full_value, lv_color_hex(s_metric_colors[mode]));
+    label_definir_texto(s_full_title, s_metric_titles[mode]);
+    garantir_subarvore(mode);
+    for (int i = 0; i < DISPLAY_MODE_COUNT; i++) {
+        if (s_subarvores[i].raiz) {
+            obj_definir_oculto(s_subarvores[i].raiz, i != (int)mode);
         }
     }
+    obj_definir_oculto(s_full_timer_label, mode != DISPLAY_DISTANCIA && mode != DISPLAY_FUROS);
+    aplicar_orcamento_subarvores(mode);
+    s_cache_full_valor.valido = false;
+    s_cache_full_tempo.valido = false;
+    s_cache_curso_px.valido = false;
+    s_reposicionar_valor = true;
+}
+
+/* Unidade e circulos usam lv_obj_align_to, que nao acompanha a largura do valor */
+static void posicionar_valor_fullscreen(void)
+{
+    switch (s_display_mode) {
+    case DISPLAY_FREQUENCIA:
+        lv_obj_align_to(s_full_value, s_full_scope_chart, LV_ALIGN_OUT_BOTTOM_MID, 0, 10);
+        break;
+    case DISPLAY_RPM:
+        lv_obj_align(s_full_value, LV_ALIGN_CENTER, 0, 10);
+        break;
+    case DISPLAY_VELOCIDADE:
+        lv_obj_align(s_full_value, LV_ALIGN_CENTER, 0, -90);
+        break;
+    case DISPLAY_CURSO:
+        lv_obj_align(s_full_value, LV_ALIGN_CENTER, 0, -5);
+        break;
+    case DISPLAY_FUROS:
+        lv_obj_align(s_full_value, LV_ALIGN_CENTER, 0, -10);
+        break;
+    default:
+        lv_obj_align(s_full_value, LV_ALIGN_CENTER, 0, -80);
+        break;
+    }
+    lv_obj_align_to(s_full_unit, s_full_value, LV_ALIGN_OUT_BOTTOM_MID, 0, s_display_mode == DISPLAY_DISTANCIA ? 6 : 4);
+    if (s_display_mode == DISPLAY_FUROS) {
+        lv_obj_align_to(s_furos_circle_right, s_full_value, LV_ALIGN_OUT_RIGHT_MID, 80, 0);
+        lv_obj_align_to(s_furos_circle_left, s_full_value, LV_ALIGN_OUT_LEFT_MID, -80, 0);
+    }
 }
 
 static void update_fullscreen_ui(const ui_data_t *data)
@@ -601,79 +963,36 @@ static void update_fullscreen_ui(const ui_data_t *data)
         return;
     }
 
-    char valor[48];
-    char unidade[16];
-    get_metric_text(s_display_mode, data, valor, sizeof(valor), unidade, sizeof(unidade));
-    lv_obj_set_style_bg_color(s_fullscreen_container, lv_color_hex(s_metric_colors[s_display_mode]), 0);
-    lv_label_set_text(s_full_title, s_metric_titles[s_display_mode]);
-    lv_label_set_text(s_full_value, valor);
-    lv_label_set_text(s_full_unit, unidade);
-
-    if (s_full_arc) {
-        lv_obj_add_flag(s_full_arc, LV_OBJ_FLAG_HIDDEN);
-    }
-    if (s_full_arc_label) {
-        lv_obj_add_flag(s_full_arc_label, LV_OBJ_FLAG_HIDDEN);
-    }
-    if (s_full_bar) {
-        lv_obj_add_flag(s_full_bar, LV_OBJ_FLAG_HIDDEN);
-    }
-    if (s_full_bar_label) {
-        lv_obj_add_flag(s_full_bar_label, LV_OBJ_FLAG_HIDDEN);
-    }
-    if (s_full_timer_label) {
-        lv_obj_add_flag(s_full_timer_label, LV_OBJ_FLAG_HIDDEN);
-    }
-    if (s_full_scope_chart) {
-        lv_obj_add_flag(s_full_scope_chart, LV_OBJ_FLAG_HIDDEN);
-    }
-    if (s_full_scope_axis_label) {
-        lv_obj_add_flag(s_full_scope_axis_label, LV_OBJ_FLAG_HIDDEN);
-    }
-    if (s_full_course_arc) {
-        lv_obj_add_flag(s_full_course_arc, LV_OBJ_FLAG_HIDDEN);
-    }
-    if (s_speed_bar) {
-        lv_obj_add_flag(s_speed_bar, LV_OBJ_FLAG_HIDDEN);
-    }
-    if (s_speed_bar_label) {
-        lv_obj_add_flag(s_speed_bar_label, LV_OBJ_FLAG_HIDDEN);
-    }
-    if (s_furos_circle_left) {
-        lv_obj_add_flag(s_furos_circle_left, LV_OBJ_FLAG_HIDDEN);
+    if (cache_mudou(&s_cache_full_valor, chave_metrica(s_display_mode, data))) {
+        char valor[48];
+        char unidade[16];
+        get_metric_text(s_display_mode, data, valor, sizeof(valor), unidade, sizeof(unidade));
+        mostrador_digitos_definir_texto(s_full_value, valor);
+        s_reposicionar_valor |= label_definir_texto(s_full_unit, unidade);
+        /* Reposicionar invalida o mostrador inteiro: so quando a largura dele muda */
+        lv_obj_update_layout(s_full_value);
+        s_reposicionar_valor |= lv_obj_get_width(s_full_value) != s_largura_valor;
     }
-    if (s_furos_circle_right) {
-        lv_obj_add_flag(s_furos_circle_right, LV_OBJ_FLAG_HIDDEN);
+    if (s_reposicionar_valor) {
+        posicionar_valor_fullscreen();
+        s_largura_valor = lv_obj_get_width(s_full_value);
+        s_reposicionar_valor = false;
     }
-    if (s_display_mode == DISPLAY_FREQUENCIA && s_full_scope_chart && s_full_scope_series) {
-        lv_obj_clear_flag(s_full_scope_chart, LV_OBJ_FLAG_HIDDEN);
-        update_scope_wave(data->frequencia_hz);
-        lv_obj_align(s_full_scope_chart, LV_ALIGN_CENTER, 0, -20);
-        if (s_full_scope_axis_label) {
-            lv_obj_add_flag(s_full_scope_axis_label, LV_OBJ_FLAG_HIDDEN);
-        }
-        lv_obj_align_to(s_full_value, s_full_scope_chart, LV_ALIGN_OUT_BOTTOM_MID, 0, 10);
-        lv_obj_align_to(s_full_unit, s_full_value, LV_ALIGN_OUT_BOTTOM_MID, 0, 4);
-    } else if (s_full_arc && s_display_mode == DISPLAY_RPM) {
+
+    if (s_display_mode == DISPLAY_FREQUENCIA) {
+        update_scope_wave();
+    } else if (s_display_mode == DISPLAY_RPM) {
         uint32_t max_value = 15000;
-        uint32_t current = data->rpm;
+        uint32_t current = q16_arredondar(data->rpm_q16);
         if (current > max_value) {
             current = max_value;
         }
-        lv_arc_set_range(s_full_arc, 0, max_value);
         lv_arc_set_value(s_full_arc, current);
-        lv_obj_clear_flag(s_full_arc, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_align(s_full_arc, LV_ALIGN_CENTER, 0, 10);
-        lv_obj_align(s_full_value, LV_ALIGN_CENTER, 0, 10);
-        lv_obj_align_to(s_full_unit, s_full_value, LV_ALIGN_OUT_BOTTOM_MID, 0, 4);
         lv_color_t arc_color = obter_cor_rpm(current);
-        lv_obj_set_style_arc_color(s_full_arc, arc_color, LV_PART_INDICATOR | LV_STATE_DEFAULT);
-        if (s_full_arc_label) {
-            lv_label_set_text(s_full_arc_label, "0 - 15k rpm");
-            lv_obj_clear_flag(s_full_arc_label, LV_OBJ_FLAG_HIDDEN);
-            lv_obj_align(s_full_arc_label, LV_ALIGN_CENTER, 0, 160);
+        if (!lv_color_eq(lv_obj_get_style_arc_color(s_full_arc, LV_PART_INDICATOR), arc_color)) {
+            lv_obj_set_style_arc_color(s_full_arc, arc_color, LV_PART_INDICATOR | LV_STATE_DEFAULT);
         }
-    } else if (s_display_mode == DISPLAY_VELOCIDADE && s_speed_bar && s_speed_bar_label) {
+    } else if (s_display_mode == DISPLAY_VELOCIDADE) {
         float limite_speed_f = 220.0f * s_config_curso.curso_cm;
         if (limite_speed_f < 1.0f) {
             limite_speed_f = 1.0f;
@@ -683,46 +1002,33 @@ static void update_fullscreen_ui(const ui_data_t *data)
             max_speed = 1;
         }
 
-        uint32_t current = data->velocidade_cm_s;
+        uint32_t current = q16_arredondar(data->velocidade_q16);
         if (current > max_speed) {
             current = max_speed;
         }
         lv_bar_set_range(s_speed_bar, 0, (int32_t)max_speed);
         lv_bar_set_value(s_speed_bar, (int32_t)current, LV_ANIM_OFF);
-        lv_obj_clear_flag(s_speed_bar, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_align(s_speed_bar, LV_ALIGN_CENTER, 0, 60);
 
         uint32_t percentual = max_speed ? (current * 100U) / max_speed : 0;
-        lv_label_set_text_fmt(s_speed_bar_label,
-                              "Boost %" PRIu32"%%   |   Limite: %" PRIu32" cm/s",
-                              percentual,
-                              max_speed);
-        lv_obj_clear_flag(s_speed_bar_label, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_align(s_speed_bar_label, LV_ALIGN_CENTER, 0, 100);
-
-        lv_obj_align(s_full_value, LV_ALIGN_CENTER, 0, -90);
-        lv_obj_align_to(s_full_unit, s_full_value, LV_ALIGN_OUT_BOTTOM_MID, 0, 4);
-    } else if (s_display_mode == DISPLAY_CURSO && s_full_course_arc) {
+        char boost_txt[64];
+        snprintf(boost_txt, sizeof(boost_txt),
+                 "Boost %" PRIu32"%%   |   Limite: %" PRIu32" cm/s",
+                 percentual,
+                 max_speed);
+        label_definir_texto(s_speed_bar_label, boost_txt);
+    } else if (s_display_mode == DISPLAY_CURSO) {
         float curso_mm = s_config_curso.curso_cm * 10.0f;
         if (curso_mm < 1.0f) curso_mm = 1.0f;
         if (curso_mm > 5.0f) curso_mm = 5.0f;
         uint32_t scaled = (uint32_t)(curso_mm * 100.0f);
-        lv_arc_set_range(s_full_course_arc, 100, 500);
         lv_arc_set_value(s_full_course_arc, scaled);
         float ratio = (curso_mm - 1.0f) / 4.0f;
         uint32_t size_px = (uint32_t)(200.0f + ratio * 80.0f);
-        lv_obj_set_size(s_full_course_arc, size_px, size_px);
-        lv_obj_clear_flag(s_full_course_arc, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_align(s_full_course_arc, LV_ALIGN_CENTER, 0, -5);
-        lv_obj_align(s_full_value, LV_ALIGN_CENTER, 0, -5);
-        lv_obj_align_to(s_full_unit, s_full_value, LV_ALIGN_OUT_BOTTOM_MID, 0, 4);
-    } else {
-        lv_obj_align(s_full_value, LV_ALIGN_CENTER, 0, -80);
-        lv_obj_align_to(s_full_unit, s_full_value, LV_ALIGN_OUT_BOTTOM_MID, 0, 6);
-    }
-
-    if (s_display_mode == DISPLAY_DISTANCIA && s_full_bar && s_full_bar_label) {
-        float distancia_m = data->distancia_m;
+        if (cache_mudou(&s_cache_curso_px, size_px)) {
+            lv_obj_set_size(s_full_course_arc, size_px, size_px);
+        }
+    } else if (s_display_mode == DISPLAY_DISTANCIA) {
+        float distancia_m = distancia_em_metros(data);
         if (distancia_m < 0.0f) {
             distancia_m = 0.0f;
         }
@@ -738,36 +1044,23 @@ static void update_fullscreen_ui(const ui_data_t *data)
 
         lv_bar_set_range(s_full_bar, 0, (int32_t)limite_cm);
         lv_bar_set_value(s_full_bar, (int32_t)distancia_cm, LV_ANIM_OFF);
-        lv_obj_clear_flag(s_full_bar, LV_OBJ_FLAG_HIDDEN);
 
         float limite_m = (float)limite_cm / 100.0f;
         char distancia_txt[32];
         char limite_txt[32];
+        char barra_txt[96];
         formatar_distancia(distancia_txt, sizeof(distancia_txt), distancia_m);
         formatar_distancia(limite_txt, sizeof(limite_txt), limite_m);
         uint32_t percentual = limite_cm ? (distancia_cm * 100U) / limite_cm : 0;
-        lv_label_set_text_fmt(s_full_bar_label,
-                              "%s de %s (%" PRIu32"%%)",
-                              distancia_txt,
-                              limite_txt,
-                              percentual);
-        lv_obj_clear_flag(s_full_bar_label, LV_OBJ_FLAG_HIDDEN);
-
-        if (s_full_timer_label) {
-            char tempo_txt[32];
-            formatar_tempo(data->tempo_sinal_ms, tempo_txt, sizeof(tempo_txt));
-            lv_label_set_text_fmt(s_full_timer_label, "Tempo: %s", tempo_txt);
-            lv_obj_clear_flag(s_full_timer_label, LV_OBJ_FLAG_HIDDEN);
-        }
+        snprintf(barra_txt, sizeof(barra_txt),
+                 "%s de %s (%" PRIu32"%%)",
+                 distancia_txt,
+                 limite_txt,
+                 percentual);
+        label_definir_texto(s_full_bar_label, barra_txt);
+        atualizar_tempo(data);
     } else if (s_display_mode == DISPLAY_FUROS) {
-        lv_obj_align(s_full_value, LV_ALIGN_CENTER, 0, -10);
-        lv_obj_align_to(s_full_unit, s_full_value, LV_ALIGN_OUT_BOTTOM_MID, 0, 4);
-        if (s_full_timer_label) {
-            char tempo_txt[32];
-            formatar_tempo(data->tempo_sinal_ms, tempo_txt, sizeof(tempo_txt));
-            lv_label_set_text_fmt(s_full_timer_label, "Tempo: %s", tempo_txt);
-            lv_obj_clear_flag(s_full_timer_label, LV_OBJ_FLAG_HIDDEN);
-        }
+        atualizar_tempo(data);
 
         uint32_t furos = data->furos;
         uint32_t progress = furos % 500U;
@@ -777,19 +1070,10 @@ static void update_fullscreen_ui(const ui_data_t *data)
         lv_obj_t *ativo = direita_ativa ? s_furos_circle_right : s_furos_circle_left;
         lv_obj_t *inativo = direita_ativa ? s_furos_circle_left : s_furos_circle_right;
 
-        if (inativo) {
-            lv_arc_set_value(inativo, 0);
-            lv_obj_add_flag(inativo, LV_OBJ_FLAG_HIDDEN);
-        }
-        if (ativo) {
-            lv_arc_set_value(ativo, (int32_t)progress);
-            lv_obj_clear_flag(ativo, LV_OBJ_FLAG_HIDDEN);
-            if (ativo == s_furos_circle_right) {
-                lv_obj_align_to(ativo, s_full_value, LV_ALIGN_OUT_RIGHT_MID, 80, 0);
-            } else {
-                lv_obj_align_to(ativo, s_full_value, LV_ALIGN_OUT_LEFT_MID, -80, 0);
-            }
-        }
+        lv_arc_set_value(inativo, 0);
+        obj_definir_oculto(inativo, true);
+        lv_arc_set_value(ativo, (int32_t)progress);
+        obj_definir_oculto(ativo, false);
     }
 
     const char *hint = "Toque duplo para voltar";
@@ -810,20 +1094,20 @@ static void update_fullscreen_ui(const ui_data_t *data)
 
     switch (s_display_mode) {
     case DISPLAY_FREQUENCIA:
-        snprintf(freq_txt, sizeof(freq_txt), "Freq: %" PRIu32 " Hz", data->frequencia_hz);
+        snprintf(freq_txt, sizeof(freq_txt), "Freq: %.1f Hz", q16_para_float(data->frequencia_q16));
         status_textos[status_count] = freq_txt;
         status_cores[status_count++] = lv_color_hex(cor_freq);
-        snprintf(rpm_txt, sizeof(rpm_txt), "RPM: %" PRIu32, data->rpm);
+        snprintf(rpm_txt, sizeof(rpm_txt), "RPM: %" PRIu32, q16_arredondar(data->rpm_q16));
         status_textos[status_count] = rpm_txt;
         status_cores[status_count++] = lv_color_hex(cor_rpm);
         break;
     case DISPLAY_RPM:
-        snprintf(freq_txt, sizeof(freq_txt), "Freq: %" PRIu32 " Hz", data->frequencia_hz);
+        snprintf(freq_txt, sizeof(freq_txt), "Freq: %.1f Hz", q16_para_float(data->frequencia_q16));
         status_textos[status_count] = freq_txt;
         status_cores[status_count++] = lv_color_hex(cor_freq);
         break;
     case DISPLAY_VELOCIDADE:
-        snprintf(freq_txt, sizeof(freq_txt), "Freq: %" PRIu32 " Hz", data->frequencia_hz);
+        snprintf(freq_txt, sizeof(freq_txt), "Freq: %.1f Hz", q16_para_float(data->frequencia_q16));
         status_textos[status_count] = freq_txt;
         status_cores[status_count++] = lv_color_hex(cor_freq);
         snprintf(curso_txt, sizeof(curso_txt), "Curso: %.1f mm", s_config_curso.curso_cm * 10.0f);
@@ -848,15 +1132,15 @@ static void get_metric_text(display_mode_t mode, const ui_data_t *data,
 
     switch (mode) {
     case DISPLAY_FREQUENCIA:
-        snprintf(valor, valor_len, "%" PRIu32, data->frequencia_hz);
+        snprintf(valor, valor_len, "%.1f", q16_para_float(data->frequencia_q16));
         unit = "Hz";
         break;
     case DISPLAY_RPM:
-        snprintf(valor, valor_len, "%" PRIu32, data->rpm);
+        snprintf(valor, valor_len, "%" PRIu32, q16_arredondar(data->rpm_q16));
         unit = "rpm";
         break;
     case DISPLAY_VELOCIDADE:
-        snprintf(valor, valor_len, "%" PRIu32, data->velocidade_cm_s);
+        snprintf(valor, valor_len, "%" PRIu32, q16_arredondar(data->velocidade_q16));
         unit = "cm/s";
         break;
     case DISPLAY_CURSO:
@@ -864,7 +1148,7 @@ static void get_metric_text(display_mode_t mode, const ui_data_t *data,
         unit = "mm";
         break;
     case DISPLAY_DISTANCIA:
-        formatar_distancia(valor, valor_len, data->distancia_m);
+        formatar_distancia(valor, valor_len, distancia_em_metros(data));
         unit = "";
         break;
     case DISPLAY_FUROS:
@@ -889,6 +1173,11 @@ static void formatar_distancia(char *buffer, size_t len, float distancia_m)
     }
 }
 
+static float distancia_em_metros(const ui_data_t *data)
+{
+    return (float)data->distancia_um / 1000000.0f;
+}
+
 static void formatar_tempo(uint64_t tempo_ms, char *buffer, size_t len)
 {
     uint64_t total_seg = tempo_ms / 1000ULL;
@@ -903,6 +1192,20 @@ static void formatar_tempo(uint64_t tempo_ms, char *buffer, size_t len)
     }
 }
 
+static void definir_segmento_status(size_t indice, const char *texto, lv_color_t cor)
+{
+    segmento_status_t *segmento = &s_status_segmentos[indice];
+    if (strncmp(segmento->texto, texto, sizeof(segmento->texto) - 1) != 0) {
+        snprintf(segmento->texto, sizeof(segmento->texto), "%s", texto);
+        lv_label_set_text_static(segmento->label, segmento->texto);
+    }
+    if (!lv_color_eq(lv_obj_get_style_text_color(segmento->label, LV_PART_MAIN), cor)) {
+        lv_obj_set_style_text_color(segmento->label, cor, 0);
+    }
+    obj_definir_oculto(segmento->label, false);
+    obj_definir_oculto(segmento->separador, indice == 0);
+}
+
 static void atualizar_status_bar(const char *hint,
                                  const char **textos,
                                  const lv_color_t *cores,
@@ -912,46 +1215,113 @@ static void atualizar_status_bar(const char *hint,
         return;
     }
 
-    while (lv_obj_get_child_cnt(s_full_status) > 0) {
-        lv_obj_del(lv_obj_get_child(s_full_status, 0));
+    size_t usados = 0;
+    for (size_t i = 0; i < quantidade && usados < STATUS_MAX_SEGMENTOS; i++) {
+        if (textos[i]) {
+            definir_segmento_status(usados++, textos[i], cores[i]);
+        }
+    }
+    if (hint && hint[0] && usados < STATUS_MAX_SEGMENTOS) {
+        definir_segmento_status(usados++, hint, lv_color_hex(0xECEFF1));
+    }
+    for (size_t i = usados; i < STATUS_MAX_SEGMENTOS; i++) {
+        obj_definir_oculto(s_status_segmentos[i].separador, true);
+        obj_definir_oculto(s_status_segmentos[i].label, true);
     }
+}
 
-    lv_color_t sep_color = lv_color_hex(0xB0BEC5);
-    lv_color_t hint_color = lv_color_hex(0xECEFF1);
-    size_t items_adicionados = 0;
+static void atualizar_tempo(const ui_data_t *data)
+{
+    if (!cache_mudou(&s_cache_full_tempo, (int64_t)(data->tempo_sinal_ms / 1000ULL))) {
+        return;
+    }
+    char tempo_txt[32];
+    char texto[48];
+    formatar_tempo(data->tempo_sinal_ms, tempo_txt, sizeof(tempo_txt));
+    snprintf(texto, sizeof(texto), "Tempo: %s", tempo_txt);
+    label_definir_texto(s_full_timer_label, texto);
+}
 
-    for (size_t i = 0; i < quantidade; i++) {
-        if (!textos[i]) {
-            continue;
-        }
-        if (items_adicionados > 0) {
-            lv_obj_t *sep = lv_label_create(s_full_status);
-            lv_label_set_text(sep, "|");
-            lv_obj_set_style_text_color(sep, sep_color, 0);
-            lv_obj_set_style_text_font(sep, &lv_font_montserrat_20, 0);
-            lv_obj_set_style_pad_left(sep, 8, 0);
-            lv_obj_set_style_pad_right(sep, 8, 0);
-        }
-        lv_obj_t *lbl = lv_label_create(s_full_status);
-        lv_label_set_text(lbl, textos[i]);
-        lv_obj_set_style_text_color(lbl, cores[i], 0);
-        lv_obj_set_style_text_font(lbl, &lv_font_montserrat_20, 0);
-        items_adicionados++;
-    }
-
-    if (hint && hint[0]) {
-        if (items_adicionados > 0) {
-            lv_obj_t *sep = lv_label_create(s_full_status);
-            lv_label_set_text(sep, "|");
-            lv_obj_set_style_text_color(sep, sep_color, 0);
-            lv_obj_set_style_text_font(sep, &lv_font_montserrat_20, 0);
-            lv_obj_set_style_pad_left(sep, 8, 0);
-            lv_obj_set_style_pad_right(sep, 8, 0);
-        }
-        lv_obj_t *hint_lbl = lv_label_create(s_full_status);
-        lv_label_set_text(hint_lbl, hint);
-        lv_obj_set_style_text_color(hint_lbl, hint_color, 0);
-        lv_obj_set_style_text_font(hint_lbl, &lv_font_montserrat_20, 0);
+/* Tudo de que o texto de cada metrica depende, sem formatar */
+static int64_t chave_metrica(display_mode_t mode, const ui_data_t *data)
+{
+    switch (mode) {
+    case DISPLAY_FREQUENCIA:
+        return data->frequencia_q16;
+    case DISPLAY_RPM:
+        return data->rpm_q16;
+    case DISPLAY_VELOCIDADE:
+        return data->velocidade_q16;
+    case DISPLAY_CURSO:
+        return lroundf(s_config_curso.curso_cm * 10000.0f);
+    case DISPLAY_DISTANCIA:
+        return (int64_t)data->distancia_um;
+    case DISPLAY_FUROS:
+        return data->furos;
+    default:
+        return 0;
+    }
+}
+
+static bool cache_mudou(cache_widget_t *cache, int64_t chave)
+{
+    if (cache->valido && cache->chave == chave) {
+        return false;
+    }
+    cache->chave = chave;
+    cache->valido = true;
+    return true;
+}
+
+static bool label_definir_texto(lv_obj_t *label, const char *texto)
+{
+    const char *atual = lv_label_get_text(label);
+    if (atual && strcmp(atual, texto) == 0) {
+        return false;
+    }
+    lv_label_set_text(label, texto);
+    return true;
+}
+
+/* Mostrar um objeto ja visivel tambem o invalidaria */
+static void obj_definir_oculto(lv_obj_t *obj, bool oculto)
+{
+    if (!obj || lv_obj_has_flag(obj, LV_OBJ_FLAG_HIDDEN) == oculto) {
+        return;
+    }
+    if (oculto) {
+        lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        lv_obj_clear_flag(obj, LV_OBJ_FLAG_HIDDEN);
+    }
+}
+
+static void ao_invalidar_area(lv_event_t *evento)
+{
+    const lv_area_t *area = lv_event_get_param(evento);
+    const uint32_t pixels = lv_area_get_size(area);
+    s_pixels_pendentes += pixels;
+    s_pixels_total += pixels;
+}
+
+/* Render de cada quadro (estilos, desenho e flush das areas invalidas), na tarefa do LVGL */
+static void ao_renderizar(lv_event_t *evento)
+{
+    const int64_t agora_us = esp_timer_get_time();
+    if (lv_event_get_code(evento) == LV_EVENT_RENDER_START) {
+        s_inicio_render_us = agora_us;
+        return;
+    }
+    if (s_inicio_render_us == 0) {
+        return;
+    }
+    const uint32_t tempo_us = (uint32_t)(agora_us - s_inicio_render_us);
+    s_inicio_render_us = 0;
+    s_diagnostico.quadros++;
+    s_diagnostico.quadro_ultimo_us = tempo_us;
+    s_diagnostico.quadro_total_us += tempo_us;
+    if (tempo_us > s_diagnostico.quadro_maximo_us) {
+        s_diagnostico.quadro_maximo_us = tempo_us;
     }
 }
 
@@ -1007,30 +1377,19 @@ static uint32_t calcular_limite_distancia_cm(float distancia_m)
     return limites_cm[total_limites - 1];
 }
 
-static void update_scope_wave(uint32_t freq_hz)
+static void update_scope_wave(void)
 {
-    if (!s_full_scope_chart || !s_full_scope_series) {
+    if (!s_full_scope_chart || !s_full_scope_series_max || !s_full_scope_series_min) {
         return;
     }
 
-    uint16_t point_cnt = lv_chart_get_point_count(s_full_scope_chart);
-    if (point_cnt == 0) {
-        point_cnt = SCOPE_POINT_COUNT;
-        lv_chart_set_point_count(s_full_scope_chart, point_cnt);
-    }
-
-    if (freq_hz > 220) {
-        freq_hz = 220;
-    }
-
-    float cycles = 1.0f + ((float)freq_hz / 220.0f) * 4.0f;
-    for (uint16_t i = 0; i < point_cnt; i++) {
-        float phase = ((float)i / (float)(point_cnt - 1)) * cycles;
-        float frac = phase - floorf(phase);
-        float value = frac < 0.5f ? 90.0f : -90.0f;
-        lv_chart_set_value_by_id(s_full_scope_chart, s_full_scope_series, i, (int32_t)value);
+    /* So as colunas novas; se a tela ficou parada, chegam apenas as mais recentes */
+    coluna_escopo_t colunas[SCOPE_POINT_COUNT];
+    const size_t quantidade = metricas_ler_colunas_escopo(0, &s_scope_cursor, colunas, SCOPE_POINT_COUNT);
+    for (size_t i = 0; i < quantidade; i++) {
+        lv_chart_set_next_value(s_full_scope_chart, s_full_scope_series_max, colunas[i].maximo);
+        lv_chart_set_next_value(s_full_scope_chart, s_full_scope_series_min, colunas[i].minimo);
     }
-    lv_chart_refresh(s_full_scope_chart);
 }
 
 static void limitar_curso(void)
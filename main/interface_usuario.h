@@ -7,6 +7,62 @@ typedef struct {
     void (*ao_solicitar_salvar_curso)(float novo_valor_cm);
 } ui_callbacks_t;
 
+/*
+ * Retorna logo: display, splash e widgets sobem numa tarefa propria. `config`
+ * so e lido quando PARTIDA_CONFIGURACAO for marcada (ver partida.h), entao
+ * deve continuar valido; a splash some sozinha quando a partida fica pronta.
+ *
+ * A UI puxa o canal 0 do barramento de metricas (metricas_ler) num timer do
+ * LVGL, uma vez por quadro; quem publica nunca toma o lock do LVGL.
+ */
 esp_err_t interface_usuario_inicializar(const configuracao_curso_t *config, const ui_callbacks_t *callbacks);
-void interface_usuario_atualizar(const dados_medidos_t *dados);
 void interface_usuario_configurar_curso(float curso_cm);
+/*
+ * Modo de economia: suspender para o LVGL (timers e tick) e apaga o
+ * backlight; retomar ressincroniza o painel e religa tudo. O toque que
+ * acordou a tela nao vira clique.
+ */
+esp_err_t interface_usuario_suspender(void);
+esp_err_t interface_usuario_retomar(bool acordou_por_toque);
+/* Tempo desde o ultimo toque, pelo LVGL */
+uint32_t interface_usuario_inativo_ms(void);
+/*
+ * Custo das atualizacoes de medicao. Pixels: soma das areas que o LVGL
+ * recebeu para invalidar (antes de fundi-las, entao e um teto); em regime
+ * sem mudanca de valor `pixels_ultima` fica em zero e `pixels_total` inclui
+ * qualquer origem (toque, escopo, timers). Tempo: aplicacao nos widgets mais
+ * o layout pendente, com o lock ja tomado. Heap: o do sistema, onde o LVGL
+ * aloca; `heap_livre_minimo` e a marca d'agua desde o boot. Subarvores: os
+ * widgets proprios de cada modo da tela cheia, montados na primeira abertura
+ * e liberados pelo orcamento; `objetos` conta a arvore da tela ativa.
+ * Quadros: do inicio ao fim do render (LV_EVENT_RENDER_START/READY), onde
+ * entram a resolucao de estilos e o desenho. `heap_ui_bytes`: heap gasto
+ * montando a UI no boot. Toma o lock do LVGL.
+ */
+typedef struct {
+    uint32_t atualizacoes;
+    uint32_t atualizacoes_sem_redesenho;
+    uint32_t publicacoes_agrupadas;    /* substituidas antes do quadro seguinte */
+    uint32_t pixels_ultima;
+    uint32_t pixels_maximo;
+    uint64_t pixels_atualizacoes;
+    uint64_t pixels_total;
+    uint32_t tempo_ultima_us;
+    uint32_t tempo_maximo_us;
+    uint64_t tempo_total_us;
+    uint32_t heap_livre;
+    uint32_t heap_livre_minimo;
+    uint32_t heap_maior_bloco;
+    uint32_t heap_ui_bytes;
+    uint32_t quadros;
+    uint32_t quadro_ultimo_us;
+    uint32_t quadro_maximo_us;
+    uint64_t quadro_total_us;
+    uint32_t objetos;
+    uint32_t subarvores_montadas;
+    uint32_t subarvores_bytes;
+    uint32_t subarvores_construidas;
+    uint32_t subarvores_liberadas;
+} interface_usuario_diagnostico_t;
+
+void interface_usuario_obter_diagnostico(interface_usuario_diagnostico_t *diagnostico);
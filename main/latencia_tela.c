@@ -0,0 +1,167 @@
+#include "latencia_tela.h"
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_lvgl_port.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "histograma_latencia.h"
+
+#define POR_MIL_P50              500U
+#define POR_MIL_P99              990U
+#define INTERVALO_OVERLAY_MS     1000U
+
+static const char *TAG = "latencia_tela";
+
+static const char *s_nomes_etapas[LATENCIA_ETAPAS] = {
+    [LATENCIA_BORDA_PUBLICACAO] = "borda>publicacao",
+    [LATENCIA_PUBLICACAO_APLICACAO] = "publicacao>aplicacao",
+    [LATENCIA_APLICACAO_TELA] = "aplicacao>tela",
+    [LATENCIA_BORDA_TELA] = "borda>tela",
+};
+
+/* Tudo abaixo so e acessado com o lock do LVGL */
+static histograma_latencia_t s_histogramas[LATENCIA_ETAPAS];
+static carimbo_medicao_t s_pendente;
+static int64_t s_aplicacao_us;
+static bool s_tem_pendente;
+static uint32_t s_substituidas;
+static uint32_t s_ultima_sequencia;
+#if CONFIG_CONTADOR_LATENCIA_OVERLAY
+static lv_obj_t *s_overlay;
+#endif
+
+static uint32_t intervalo_us(int64_t inicio_us, int64_t fim_us)
+{
+    const int64_t intervalo = fim_us - inicio_us;
+    if (intervalo <= 0) {
+        return 0;
+    }
+    return intervalo > (int64_t)UINT32_MAX ? UINT32_MAX : (uint32_t)intervalo;
+}
+
+static void resumir(latencia_tela_relatorio_t *relatorio)
+{
+    for (size_t i = 0; i < LATENCIA_ETAPAS; i++) {
+        const histograma_latencia_t *histograma = &s_histogramas[i];
+        relatorio->etapas[i] = (latencia_resumo_t){
+            .amostras = histograma->amostras,
+            .p50_us = histograma_latencia_percentil(histograma, POR_MIL_P50),
+            .p99_us = histograma_latencia_percentil(histograma, POR_MIL_P99),
+            .maximo_us = histograma->maximo_us,
+        };
+    }
+    relatorio->substituidas = s_substituidas;
+    relatorio->ultima_sequencia = s_ultima_sequencia;
+}
+
+static void zerar_locked(void)
+{
+    for (size_t i = 0; i < LATENCIA_ETAPAS; i++) {
+        histograma_latencia_zerar(&s_histogramas[i]);
+    }
+    s_tem_pendente = false;
+    s_substituidas = 0;
+    s_ultima_sequencia = 0;
+}
+
+/* Fim de cada passada do refresh: o que foi aplicado antes ja esta no framebuffer exibido */
+static void ao_terminar_refresh(lv_event_t *evento)
+{
+    (void)evento;
+    if (!s_tem_pendente) {
+        return;
+    }
+    const int64_t tela_us = esp_timer_get_time();
+    histograma_latencia_registrar(&s_histogramas[LATENCIA_BORDA_PUBLICACAO],
+                                  intervalo_us(s_pendente.borda_us, s_pendente.publicacao_us));
+    histograma_latencia_registrar(&s_histogramas[LATENCIA_PUBLICACAO_APLICACAO],
+                                  intervalo_us(s_pendente.publicacao_us, s_aplicacao_us));
+    histograma_latencia_registrar(&s_histogramas[LATENCIA_APLICACAO_TELA], intervalo_us(s_aplicacao_us, tela_us));
+    histograma_latencia_registrar(&s_histogramas[LATENCIA_BORDA_TELA], intervalo_us(s_pendente.borda_us, tela_us));
+    s_ultima_sequencia = s_pendente.sequencia;
+    s_tem_pendente = false;
+}
+
+#if CONFIG_CONTADOR_LATENCIA_OVERLAY
+static void atualizar_overlay(lv_timer_t *timer)
+{
+    (void)timer;
+    latencia_tela_relatorio_t relatorio;
+    resumir(&relatorio);
+    const latencia_resumo_t *total = &relatorio.etapas[LATENCIA_BORDA_TELA];
+    lv_label_set_text_fmt(s_overlay, "borda>tela p50 %.1f p99 %.1f max %.1f ms (%" PRIu32 ")",
+                          total->p50_us / 1000.0f, total->p99_us / 1000.0f, total->maximo_us / 1000.0f,
+                          total->amostras);
+}
+
+static void criar_overlay(void)
+{
+    /* Camada superior: fica visivel em qualquer layout e nao entra na arvore dos cards */
+    s_overlay = lv_label_create(lv_layer_top());
+    lv_obj_set_style_text_color(s_overlay, lv_color_hex(0xFFEB3B), 0);
+    lv_obj_set_style_bg_color(s_overlay, lv_color_hex(0x000000), 0);
+    lv_obj_set_style_bg_opa(s_overlay, LV_OPA_70, 0);
+    lv_obj_set_style_pad_all(s_overlay, 4, 0);
+    lv_obj_align(s_overlay, LV_ALIGN_TOP_RIGHT, -4, 4);
+    lv_label_set_text(s_overlay, "borda>tela: sem amostras");
+    lv_timer_create(atualizar_overlay, INTERVALO_OVERLAY_MS, NULL);
+}
+#endif
+
+void latencia_tela_inicializar(lv_display_t *display)
+{
+    zerar_locked();
+    if (!display) {
+        ESP_LOGW(TAG, "Sem display: latencia nao sera medida");
+        return;
+    }
+    lv_display_add_event_cb(display, ao_terminar_refresh, LV_EVENT_REFR_READY, NULL);
+#if CONFIG_CONTADOR_LATENCIA_OVERLAY
+    criar_overlay();
+#endif
+}
+
+void latencia_tela_aplicada(const carimbo_medicao_t *carimbo)
+{
+    if (!carimbo || carimbo->borda_us == 0) {
+        /* Batimento sem borda nova: nada a correlacionar */
+        return;
+    }
+    if (s_tem_pendente) {
+        s_substituidas++;
+    }
+    s_pendente = *carimbo;
+    s_aplicacao_us = esp_timer_get_time();
+    s_tem_pendente = true;
+}
+
+void latencia_tela_obter(latencia_tela_relatorio_t *relatorio)
+{
+    if (!relatorio) {
+        return;
+    }
+    memset(relatorio, 0, sizeof(*relatorio));
+    if (!lvgl_port_lock(portMAX_DELAY)) {
+        return;
+    }
+    resumir(relatorio);
+    lvgl_port_unlock();
+}
+
+void latencia_tela_zerar(void)
+{
+    if (!lvgl_port_lock(portMAX_DELAY)) {
+        return;
+    }
+    zerar_locked();
+    lvgl_port_unlock();
+}
+
+const char *latencia_tela_nome_etapa(latencia_etapa_t etapa)
+{
+    return etapa < LATENCIA_ETAPAS ? s_nomes_etapas[etapa] : "?";
+}
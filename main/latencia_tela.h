@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "app_types.h"
+#include "lvgl.h"
+
+/*
+ * Latencia pulso-tela do canal exibido, por etapa: borda (timestamp da ISR),
+ * publicacao no barramento, aplicacao nos widgets e fim do refresh do LVGL
+ * (LV_EVENT_REFR_READY, depois da espera de vsync do flush). As etapas se
+ * correlacionam pelo carimbo da medicao; so publicacoes com borda nova
+ * entram. Uma medicao aplicada e substituida antes de ir para a tela conta
+ * em `substituidas`.
+ */
+typedef enum {
+    LATENCIA_BORDA_PUBLICACAO = 0,
+    LATENCIA_PUBLICACAO_APLICACAO,
+    LATENCIA_APLICACAO_TELA,
+    LATENCIA_BORDA_TELA,
+    LATENCIA_ETAPAS,
+} latencia_etapa_t;
+
+typedef struct {
+    uint32_t amostras;
+    uint32_t p50_us;
+    uint32_t p99_us;
+    uint32_t maximo_us;
+} latencia_resumo_t;
+
+typedef struct {
+    latencia_resumo_t etapas[LATENCIA_ETAPAS];
+    uint32_t substituidas;
+    uint32_t ultima_sequencia;    /* carimbo da ultima medicao que chegou a tela */
+} latencia_tela_relatorio_t;
+
+/* Chamar com o lock do LVGL; registra o evento de refresh (e o overlay, se habilitado). */
+void latencia_tela_inicializar(lv_display_t *display);
+/* Chamar com o lock do LVGL logo depois de aplicar a medicao nos widgets. */
+void latencia_tela_aplicada(const carimbo_medicao_t *carimbo);
+/* API de depuracao: qualquer tarefa (toma o lock do LVGL). */
+void latencia_tela_obter(latencia_tela_relatorio_t *relatorio);
+void latencia_tela_zerar(void);
+const char *latencia_tela_nome_etapa(latencia_etapa_t etapa);
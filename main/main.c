@@ -6,14 +6,24 @@
 
 #include "app_types.h"
 #include "armazenamento.h"
+#include "gravador_sessao.h"
+#include "historico_sessoes.h"
 #include "interface_usuario.h"
 #include "metricas.h"
+#include "modo_economia.h"
+#include "partida.h"
+#include "telemetria.h"
+#include "tendencia.h"
 
 static const char *TAG = "app_main";
 
 static configuracao_curso_t s_configuracao = {
     .curso_cm = CURSO_MAX_CM * 0.7f,
 };
+static configuracao_sessao_t s_sessao = {
+    .tempo_pausa_ms = SESSAO_PAUSA_PADRAO_MS,
+    .tempo_encerrar_ms = SESSAO_ENCERRAR_PADRAO_MS,
+};
 
 static void salvar_curso_callback(float novo_curso_cm)
 {
@@ -25,11 +35,6 @@ static void salvar_curso_callback(float novo_curso_cm)
     metricas_atualizar_curso(novo_curso_cm);
 }
 
-static void metricas_callback(const dados_medidos_t *dados)
-{
-    interface_usuario_atualizar(dados);
-}
-
 static void inicializar_nvs(void)
 {
     esp_err_t err = nvs_flash_init();
@@ -40,12 +45,14 @@ static void inicializar_nvs(void)
     ESP_ERROR_CHECK(err);
 }
 
+/*
+ * Sem esperas fixas: display, splash e widgets sobem numa tarefa da UI
+ * enquanto esta carrega a NVS e liga os subsistemas. A contagem de pulsos
+ * comeca assim que as metricas sobem, com a splash ainda na tela.
+ */
 void app_main(void)
 {
-    inicializar_nvs();
-
-    ESP_LOGI(TAG, "Carregando configuracoes persistentes...");
-    ESP_ERROR_CHECK(armazenamento_inicializar(&s_configuracao));
+    partida_inicializar();
 
     ui_callbacks_t callbacks = {
         .ao_solicitar_salvar_curso = salvar_curso_callback,
@@ -54,8 +61,49 @@ void app_main(void)
     ESP_LOGI(TAG, "Inicializando interface grafica...");
     ESP_ERROR_CHECK(interface_usuario_inicializar(&s_configuracao, &callbacks));
 
+    inicializar_nvs();
+
+    ESP_LOGI(TAG, "Carregando configuracoes persistentes...");
+    ESP_ERROR_CHECK(armazenamento_inicializar(&s_configuracao));
+    armazenamento_carregar_sessao(&s_sessao);
+    partida_marcar(PARTIDA_CONFIGURACAO);
+
+#if CONFIG_CONTADOR_GRAVADOR
+    ESP_LOGI(TAG, "Inicializando gravador de sessao...");
+    esp_err_t err = gravador_sessao_inicializar();
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Gravador indisponivel (0x%x), seguindo sem gravar", err);
+    }
+#endif
+
+#if CONFIG_CONTADOR_TELEMETRIA
+    ESP_LOGI(TAG, "Inicializando telemetria...");
+    esp_err_t err_telemetria = telemetria_inicializar();
+    if (err_telemetria != ESP_OK) {
+        ESP_LOGW(TAG, "Telemetria indisponivel (0x%x), seguindo sem transmitir", err_telemetria);
+    }
+#endif
+
+    esp_err_t err_historico = historico_sessoes_inicializar();
+    if (err_historico != ESP_OK) {
+        ESP_LOGW(TAG, "Historico de sessoes indisponivel (0x%x)", err_historico);
+    }
+    esp_err_t err_tendencia = tendencia_inicializar();
+    if (err_tendencia != ESP_OK) {
+        ESP_LOGW(TAG, "Historico de tendencia indisponivel (0x%x)", err_tendencia);
+    }
+
     ESP_LOGI(TAG, "Inicializando modulo de metricas...");
-    ESP_ERROR_CHECK(metricas_inicializar(&s_configuracao, metricas_callback));
+    metricas_configurar_sessao(&s_sessao);
+    ESP_ERROR_CHECK(metricas_inicializar(&s_configuracao));
+    partida_marcar(PARTIDA_METRICAS);
+
+#if CONFIG_CONTADOR_ECONOMIA
+    esp_err_t err_economia = modo_economia_inicializar();
+    if (err_economia != ESP_OK) {
+        ESP_LOGW(TAG, "Modo de economia indisponivel (0x%x)", err_economia);
+    }
+#endif
 
-    ESP_LOGI(TAG, "Sistema pronto. Toque na tela para navegar entre os cards.");
+    ESP_LOGI(TAG, "Medicao em andamento. Toque na tela para navegar entre os cards.");
 }
@@ -1,46 +1,147 @@
 #include "metricas.h"
 
+#include "barramento_metricas.h"
+#include "decimador_escopo.h"
+#include "despertador_bordas.h"
+#include "fila_bordas.h"
+#include "fonte_pulsos_hw.h"
+#include "fonte_pulsos_sim.h"
+#include "governador_publicacao.h"
+#include "gravador_sessao.h"
+#include "historico_sessoes.h"
+#include "nucleo_medicao.h"
+#include "telemetria.h"
+#include "tendencia.h"
+
+#include <stdatomic.h>
+
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "driver/gpio.h"
+#include "esp_check.h"
 #include "esp_timer.h"
 #include "esp_log.h"
 
-#define GPIO_SINAL               GPIO_NUM_16
-#define TEMPO_DEBOUNCE_US        1000
-#define TEMPO_IDLE_MS            1000
-#define TEMPO_RESET_MS           30000
+#define PERIODO_MAXIMO_US        1000000   /* abaixo de 1 Hz nao ha periodo, so bordas isoladas */
 #define PILHA_TAREFA_METRICAS    4096
 #define PRIORIDADE_TAREFA        4
-#define INTERVALO_METRICAS_MS    100
-
-static metricas_callback_t s_callback = NULL;
-static float s_curso_cm = CURSO_MAX_CM * 0.7f;
-
-static portMUX_TYPE s_spinlock_pulso = portMUX_INITIALIZER_UNLOCKED;
-static volatile uint32_t s_periodo_us = 0;
-static volatile uint32_t s_total_furos = 0;
-static volatile int64_t s_ultimo_pulso_us = 0;
-static volatile int64_t s_ultimo_interrupt_us = 0;
-static volatile int64_t s_ultima_atualizacao_ms = 0;
-static volatile bool s_sinal_ativo = false;
-static volatile int64_t s_inicio_sinal_ms = 0;
-static volatile uint64_t s_tempo_sinal_ms = 0;
-
-static void configurar_gpio(void);
-static void isr_pulso(void *arg);
+#define INTERVALO_AMOSTRAGEM_MS  100
+#define INTERVALO_RAPIDO_MS      33
+#define INTERVALO_BATIMENTO_MS   250
+#define PUBLICACOES_ESTAVEIS     5
+#define LIMIAR_MUDANCA_Q16       (Q16_UM / 4U)
+#define TOLERANCIA_DESPERTAR_SHIFT 5
+#define LOTE_BORDAS              64
+#define PERIODOS_MINIMOS_JANELA  4
+#define FILTRO_SUAVIZACAO_SHIFT  3
+#define ESCOPO_LARGURA_COLUNA_US 1000
+#define CANAL_GRAVADO            0
+
+static const char *TAG = "metricas";
+
+/*
+ * Um canal por maquina medida. Cada canal tem fila, filtro (na fonte),
+ * nucleo e despertador proprios: a ISR de um canal nunca toca o estado de
+ * outro, entao nao ha trava entre canais. Todas as fontes GPIO usam o mesmo
+ * servico de ISR, que despacha pelo pino.
+ */
+typedef struct {
+    /* Compartilhado entre a fonte de pulsos (produtor) e tarefa_metricas (consumidor) */
+    fila_bordas_t fila;
+    fonte_pulsos_t *fonte;
+    despertador_bordas_t despertador;
+    /* Estado de tarefa_metricas (exceto o curso, atomico dentro do nucleo) */
+    nucleo_medicao_t nucleo;
+    uint32_t frequencia_publicada_q16;
+    bool sinal_publicado;
+    uint32_t sequencia;
+    int64_t borda_nao_publicada_us;   /* ultima borda drenada desde a publicacao anterior */
+    /* Escrito por tarefa_metricas, lido pela UI via metricas_ler_colunas_escopo() */
+    decimador_escopo_t escopo;
+} canal_metricas_t;
+
+static const int s_gpio_canais[METRICAS_MAX_CANAIS] = {
+    CONFIG_CONTADOR_GPIO_SINAL,
+#if CONFIG_CONTADOR_CANAIS >= 2
+    CONFIG_CONTADOR_GPIO_SINAL_2,
+#endif
+#if CONFIG_CONTADOR_CANAIS >= 3
+    CONFIG_CONTADOR_GPIO_SINAL_3,
+#endif
+#if CONFIG_CONTADOR_CANAIS >= 4
+    CONFIG_CONTADOR_GPIO_SINAL_4,
+#endif
+};
+
+static barramento_metricas_t s_barramento;
+static configuracao_sessao_t s_sessao = {
+    .tempo_pausa_ms = SESSAO_PAUSA_PADRAO_MS,
+    .tempo_encerrar_ms = SESSAO_ENCERRAR_PADRAO_MS,
+};
+static canal_metricas_t s_canais[CONFIG_CONTADOR_CANAIS];
+static governador_publicacao_t s_governador;
+static TaskHandle_t s_tarefa = NULL;
+/* Estado exclusivo de tarefa_metricas: os lotes de processar_bordas ficam fora da pilha dela */
+static int64_t s_lote[LOTE_BORDAS];
+#if CONFIG_CONTADOR_GRAVADOR
+static uint32_t s_periodos[LOTE_BORDAS];
+#endif
+/* Escrito pela UI: com o osciloscopio na tela o decimador nao pode parar junto com o sinal */
+static _Atomic bool s_escopo_visivel;
+#if CONFIG_CONTADOR_FONTE_SIMULADA
+static fonte_pulsos_sim_t s_fontes_simuladas[CONFIG_CONTADOR_CANAIS];
+#endif
+
+static esp_err_t criar_fonte_pulsos(uint8_t canal, fonte_pulsos_t **fonte);
+static bool despertar_tarefa(void *contexto);
 static void tarefa_metricas(void *param);
+static void processar_bordas(uint8_t canal);
+static int64_t relogio_esp_timer(void *contexto);
 
-esp_err_t metricas_inicializar(const configuracao_curso_t *config, metricas_callback_t callback)
+_Static_assert(CONFIG_CONTADOR_CANAIS <= BARRAMENTO_METRICAS_MAX_CANAIS, "mais canais que slots no barramento");
+
+esp_err_t metricas_inicializar(const configuracao_curso_t *config)
 {
-    if (!config || !callback) {
+    if (!config) {
         return ESP_ERR_INVALID_ARG;
     }
-    s_callback = callback;
-    s_curso_cm = config->curso_cm;
-    configurar_gpio();
-    BaseType_t criada = xTaskCreate(tarefa_metricas, "metricas", PILHA_TAREFA_METRICAS, NULL, PRIORIDADE_TAREFA, NULL);
-    return criada == pdPASS ? ESP_OK : ESP_FAIL;
+    barramento_metricas_inicializar(&s_barramento, CONFIG_CONTADOR_CANAIS);
+    const nucleo_medicao_config_t nucleo_config = {
+        .sessao = s_sessao,
+        .periodo_maximo_us = PERIODO_MAXIMO_US,
+        .periodos_minimos = PERIODOS_MINIMOS_JANELA,
+        .relogio = relogio_esp_timer,
+        .contexto_relogio = NULL,
+    };
+    for (uint8_t i = 0; i < CONFIG_CONTADOR_CANAIS; i++) {
+        canal_metricas_t *canal = &s_canais[i];
+        fila_bordas_inicializar(&canal->fila);
+        nucleo_medicao_inicializar(&canal->nucleo, &nucleo_config);
+        decimador_escopo_inicializar(&canal->escopo, ESCOPO_LARGURA_COLUNA_US, PERIODO_MAXIMO_US);
+        canal->despertador.tolerancia_shift = TOLERANCIA_DESPERTAR_SHIFT;
+        canal->despertador.despertar = despertar_tarefa;
+    }
+    metricas_atualizar_curso(config->curso_cm);
+    const governador_config_t governador_config = {
+        .intervalo_rapido_ms = INTERVALO_RAPIDO_MS,
+        .intervalo_lento_ms = INTERVALO_BATIMENTO_MS,
+        .publicacoes_estaveis = PUBLICACOES_ESTAVEIS,
+    };
+    governador_publicacao_inicializar(&s_governador, &governador_config);
+
+    BaseType_t criada = xTaskCreate(tarefa_metricas, "metricas", PILHA_TAREFA_METRICAS, NULL, PRIORIDADE_TAREFA,
+                                    &s_tarefa);
+    ESP_RETURN_ON_FALSE(criada == pdPASS, ESP_FAIL, TAG, "Falha ao criar tarefa");
+    for (uint8_t i = 0; i < CONFIG_CONTADOR_CANAIS; i++) {
+        canal_metricas_t *canal = &s_canais[i];
+        canal->despertador.contexto = s_tarefa;
+        ESP_RETURN_ON_ERROR(criar_fonte_pulsos(i, &canal->fonte), TAG, "Falha ao criar fonte do canal %u", i);
+        canal->fonte->despertador = &canal->despertador;
+        ESP_RETURN_ON_ERROR(fonte_pulsos_iniciar(canal->fonte, &canal->fila), TAG, "Falha ao iniciar fonte %s (canal %u)",
+                            canal->fonte->nome, i);
+        ESP_LOGI(TAG, "Canal %u: fonte %s, GPIO %d", i, canal->fonte->nome, s_gpio_canais[i]);
+    }
+    xTaskNotifyGive(s_tarefa);
+    return ESP_OK;
 }
 
 void metricas_atualizar_curso(float novo_curso_cm)
@@ -50,123 +151,321 @@ void metricas_atualizar_curso(float novo_curso_cm)
     } else if (novo_curso_cm > CURSO_MAX_CM) {
         novo_curso_cm = CURSO_MAX_CM;
     }
-    s_curso_cm = novo_curso_cm;
+    /* Um curso para a bancada inteira: a UI so edita um valor */
+    const uint32_t curso_um = (uint32_t)(novo_curso_cm * UM_POR_CM + 0.5f);
+    for (uint8_t i = 0; i < CONFIG_CONTADOR_CANAIS; i++) {
+        nucleo_medicao_definir_curso_um(&s_canais[i].nucleo, curso_um);
+    }
+}
+
+void metricas_configurar_sessao(const configuracao_sessao_t *sessao)
+{
+    if (!sessao) {
+        return;
+    }
+    /* Antes de metricas_inicializar so guarda; depois vale na proxima publicacao */
+    s_sessao = *sessao;
+    for (uint8_t i = 0; i < CONFIG_CONTADOR_CANAIS; i++) {
+        nucleo_medicao_definir_sessao(&s_canais[i].nucleo, sessao);
+    }
+}
+
+uint8_t metricas_total_canais(void)
+{
+    return CONFIG_CONTADOR_CANAIS;
+}
+
+uint32_t metricas_versao(uint8_t canal)
+{
+    return barramento_metricas_versao(&s_barramento, canal);
+}
+
+bool metricas_ler(uint8_t canal, uint32_t *versao, dados_medidos_t *destino)
+{
+    if (!destino) {
+        return false;
+    }
+    return barramento_metricas_ler(&s_barramento, canal, versao, destino);
+}
+
+void metricas_obter_diagnostico(uint8_t canal, metricas_diagnostico_t *diagnostico)
+{
+    if (!diagnostico || canal >= CONFIG_CONTADOR_CANAIS) {
+        return;
+    }
+    const canal_metricas_t *estado = &s_canais[canal];
+    diagnostico->bordas_perdidas = fila_bordas_transbordos(&s_canais[canal].fila);
+    diagnostico->bordas_aceitas = 0;
+    diagnostico->glitches_rejeitados = 0;
+    diagnostico->pilha_livre_bytes = s_tarefa ? (uint32_t)uxTaskGetStackHighWaterMark(s_tarefa) : 0;
+    if (estado->fonte && estado->fonte->filtro) {
+        diagnostico->bordas_aceitas = filtro_glitch_aceitas(estado->fonte->filtro);
+        diagnostico->glitches_rejeitados = filtro_glitch_rejeitadas(estado->fonte->filtro);
+    }
+}
+
+size_t metricas_copiar_histograma(uint8_t canal, uint32_t *destino, size_t max)
+{
+    if (!destino || canal >= CONFIG_CONTADOR_CANAIS) {
+        return 0;
+    }
+    return estatisticas_curso_copiar_histograma(&s_canais[canal].nucleo.estatisticas, destino, max);
+}
+
+size_t metricas_ler_colunas_escopo(uint8_t canal, uint32_t *cursor, coluna_escopo_t *destino, size_t max)
+{
+    if (!cursor || !destino || canal >= CONFIG_CONTADOR_CANAIS) {
+        return 0;
+    }
+    return decimador_escopo_ler(&s_canais[canal].escopo, cursor, destino, max);
+}
+
+void metricas_definir_escopo_visivel(bool visivel)
+{
+    const bool anterior = atomic_exchange_explicit(&s_escopo_visivel, visivel, memory_order_relaxed);
+    if (visivel && !anterior && s_tarefa) {
+        /* Pode estar em espera infinita sem sinal: acorda para o traco voltar a andar */
+        xTaskNotifyGive(s_tarefa);
+    }
+}
+
+bool metricas_suporta_sono(void)
+{
+    for (uint8_t i = 0; i < CONFIG_CONTADOR_CANAIS; i++) {
+        if (!s_canais[i].fonte || !fonte_pulsos_suporta_sono(s_canais[i].fonte)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+esp_err_t metricas_preparar_sono(void)
+{
+    ESP_RETURN_ON_FALSE(metricas_suporta_sono(), ESP_ERR_NOT_SUPPORTED, TAG, "fonte sem light sleep");
+    for (uint8_t i = 0; i < CONFIG_CONTADOR_CANAIS; i++) {
+        fonte_pulsos_t *fonte = s_canais[i].fonte;
+        const int err = fonte->preparar_sono(fonte);
+        if (err != 0) {
+            /* Desfaz os canais ja armados e o que falhou; uma descida vista nesse meio-tempo entra como no despertar */
+            bool entregou = false;
+            for (uint8_t j = 0; j <= i; j++) {
+                entregou |= s_canais[j].fonte->retomar_sono(s_canais[j].fonte, esp_timer_get_time());
+            }
+            if (entregou) {
+                xTaskNotifyGive(s_tarefa);
+            }
+            return err;
+        }
+    }
+    return ESP_OK;
+}
+
+bool metricas_sono_interrompido(void)
+{
+    bool interrompido = false;
+    for (uint8_t i = 0; i < CONFIG_CONTADOR_CANAIS; i++) {
+        /* Pergunta a todos: cada fonte anota se nao vai dormir */
+        interrompido |= s_canais[i].fonte->sono_interrompido(s_canais[i].fonte);
+    }
+    return interrompido;
 }
 
-static void configurar_gpio(void)
+bool metricas_retomar_sono(int64_t despertar_us)
 {
-    gpio_config_t config = {
-        .pin_bit_mask = 1ULL << GPIO_SINAL,
-        .mode = GPIO_MODE_INPUT,
-        .pull_up_en = GPIO_PULLUP_ENABLE,
-        .pull_down_en = GPIO_PULLDOWN_DISABLE,
-        .intr_type = GPIO_INTR_NEGEDGE,
+    bool entregou = false;
+    for (uint8_t i = 0; i < CONFIG_CONTADOR_CANAIS; i++) {
+        fonte_pulsos_t *fonte = s_canais[i].fonte;
+        entregou |= fonte->retomar_sono(fonte, despertar_us);
+    }
+    if (entregou) {
+        /* A borda entrou pela fila sem passar pelo despertador da ISR */
+        xTaskNotifyGive(s_tarefa);
+    }
+    return entregou;
+}
+
+static esp_err_t criar_fonte_pulsos(uint8_t canal, fonte_pulsos_t **fonte)
+{
+    const fonte_pulsos_config_t config = {
+        .gpio_num = s_gpio_canais[canal],
+        .filtro = {
+            .bloqueio_minimo_us = CONFIG_CONTADOR_FILTRO_BLOQUEIO_MIN_US,
+            .fracao_q8 = (CONFIG_CONTADOR_FILTRO_FRACAO_PCT * 256U) / 100U,
+            .periodo_maximo_us = PERIODO_MAXIMO_US,
+            .suavizacao_shift = FILTRO_SUAVIZACAO_SHIFT,
+        },
+    };
+#if CONFIG_CONTADOR_FONTE_MCPWM
+    return fonte_pulsos_nova_mcpwm(&config, fonte);
+#elif CONFIG_CONTADOR_FONTE_PCNT
+    return fonte_pulsos_nova_pcnt(&config, fonte);
+#elif CONFIG_CONTADOR_FONTE_SIMULADA
+    /* Canais simulados em frequencias diferentes para distinguir na bancada */
+    const fonte_pulsos_sim_config_t sim_config = {
+        .frequencia_mhz = CONFIG_CONTADOR_SIM_FREQUENCIA_HZ * (4U + canal) * 250U,
+        .jitter_us = CONFIG_CONTADOR_SIM_JITTER_US,
+        .repiques = CONFIG_CONTADOR_SIM_REPIQUES,
+        .intervalo_repique_us = CONFIG_CONTADOR_SIM_INTERVALO_REPIQUE_US,
+        .filtro = config.filtro,
+        .semente = (uint32_t)esp_timer_get_time() + canal,
     };
-    ESP_ERROR_CHECK(gpio_config(&config));
-    esp_err_t err = gpio_install_isr_service(0);
-    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
-        ESP_ERROR_CHECK(err);
-    }
-    ESP_ERROR_CHECK(gpio_isr_handler_add(GPIO_SINAL, isr_pulso, NULL));
-}
-
-static void IRAM_ATTR isr_pulso(void *arg)
-{
-    const int64_t agora_us = esp_timer_get_time();
-    portENTER_CRITICAL_ISR(&s_spinlock_pulso);
-    if (agora_us - s_ultimo_interrupt_us > TEMPO_DEBOUNCE_US) {
-        s_periodo_us = (uint32_t)(agora_us - s_ultimo_pulso_us);
-        s_ultimo_pulso_us = agora_us;
-        s_ultima_atualizacao_ms = agora_us / 1000;
-        s_total_furos++;
-        if (!s_sinal_ativo) {
-            s_sinal_ativo = true;
-            s_inicio_sinal_ms = s_ultima_atualizacao_ms;
+    fonte_pulsos_sim_configurar(&s_fontes_simuladas[canal], &sim_config, esp_timer_get_time());
+    *fonte = &s_fontes_simuladas[canal].base;
+    return ESP_OK;
+#else
+    return fonte_pulsos_nova_gpio(&config, fonte);
+#endif
+}
+
+static void processar_bordas(uint8_t indice)
+{
+    canal_metricas_t *canal = &s_canais[indice];
+    size_t quantidade;
+    do {
+        quantidade = fila_bordas_drenar(&canal->fila, s_lote, LOTE_BORDAS);
+#if CONFIG_CONTADOR_GRAVADOR
+        size_t total_periodos = 0;
+#endif
+        for (size_t i = 0; i < quantidade; i++) {
+            const uint32_t periodo_us = nucleo_medicao_registrar_borda(&canal->nucleo, s_lote[i]);
+            decimador_escopo_registrar_borda(&canal->escopo, s_lote[i]);
+#if CONFIG_CONTADOR_GRAVADOR
+            if (periodo_us > 0) {
+                s_periodos[total_periodos++] = periodo_us;
+            }
+#else
+            (void)periodo_us;
+#endif
+        }
+#if CONFIG_CONTADOR_GRAVADOR
+        /* O formato do gravador nao identifica canal: grava so o principal */
+        if (indice == CANAL_GRAVADO) {
+            gravador_sessao_registrar(s_periodos, total_periodos);
+        }
+#endif
+#if CONFIG_CONTADOR_TELEMETRIA
+        telemetria_registrar_bordas(indice, s_lote, quantidade);
+#endif
+        if (quantidade > 0) {
+            canal->borda_nao_publicada_us = s_lote[quantidade - 1];
         }
+    } while (quantidade == LOTE_BORDAS);
+}
+
+static bool IRAM_ATTR despertar_tarefa(void *contexto)
+{
+    BaseType_t acordou = pdFALSE;
+    vTaskNotifyGiveFromISR((TaskHandle_t)contexto, &acordou);
+    return acordou == pdTRUE;
+}
+
+static int64_t relogio_esp_timer(void *contexto)
+{
+    (void)contexto;
+    return esp_timer_get_time();
+}
+
+/* Espera maxima antes de a fila do canal passar da metade na frequencia publicada */
+static uint32_t prazo_fila_ms(uint32_t frequencia_q16)
+{
+    if (frequencia_q16 == 0) {
+        return GOVERNADOR_ESPERA_INFINITA;
     }
-    s_ultimo_interrupt_us = agora_us;
-    portEXIT_CRITICAL_ISR(&s_spinlock_pulso);
+    const uint64_t prazo_ms = ((uint64_t)(FILA_BORDAS_CAPACIDADE / 2U) * 1000U << 16) / frequencia_q16;
+    return prazo_ms > 0 ? (uint32_t)prazo_ms : 1U;
 }
 
 static void tarefa_metricas(void *param)
 {
-    int64_t ultimo_ms = esp_timer_get_time() / 1000;
-    float distancia_m = 0.0f;
+    int64_t ultima_publicacao_ms = 0;
+    uint32_t espera_ms = GOVERNADOR_ESPERA_INFINITA;
+
+    /* Espera metricas_inicializar terminar de criar as fontes */
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    bool alguma_amostrada = false;
+    for (uint8_t i = 0; i < CONFIG_CONTADOR_CANAIS; i++) {
+        alguma_amostrada |= s_canais[i].fonte->amostrar != NULL;
+    }
 
     while (true) {
-        vTaskDelay(pdMS_TO_TICKS(INTERVALO_METRICAS_MS));
-        const int64_t agora_ms = esp_timer_get_time() / 1000;
-
-        uint32_t periodo_capturado;
-        uint32_t furos;
-        bool sinal_ativo;
-        int64_t ultima_atualizacao;
-        int64_t inicio_sinal_ms;
-        uint64_t tempo_ms;
-
-        portENTER_CRITICAL(&s_spinlock_pulso);
-        periodo_capturado = s_periodo_us;
-        furos = s_total_furos;
-        sinal_ativo = s_sinal_ativo;
-        ultima_atualizacao = s_ultima_atualizacao_ms;
-        inicio_sinal_ms = s_inicio_sinal_ms;
-        tempo_ms = s_tempo_sinal_ms;
-        portEXIT_CRITICAL(&s_spinlock_pulso);
-
-        uint32_t frequencia = 0;
-        uint32_t rpm = 0;
-        uint32_t velocidade_cm_s = 0;
-
-        if (periodo_capturado > 0) {
-            frequencia = 1000000UL / periodo_capturado;
-            rpm = frequencia * 60U;
-            velocidade_cm_s = (uint32_t)(frequencia * s_curso_cm);
-            if (ultimo_ms > 0) {
-                const float delta_s = (agora_ms - ultimo_ms) / 1000.0f;
-                distancia_m += (velocidade_cm_s / 100.0f) * delta_s;
+        if (alguma_amostrada && espera_ms > INTERVALO_AMOSTRAGEM_MS) {
+            /* Fontes sem interrupcao por borda precisam ser consultadas periodicamente */
+            espera_ms = INTERVALO_AMOSTRAGEM_MS;
+        }
+        if (espera_ms > INTERVALO_RAPIDO_MS && atomic_load_explicit(&s_escopo_visivel, memory_order_relaxed)) {
+            /* Osciloscopio na tela: as colunas fecham a cada quadro mesmo parado ou no batimento lento */
+            espera_ms = INTERVALO_RAPIDO_MS;
+        }
+        for (uint8_t i = 0; i < CONFIG_CONTADOR_CANAIS; i++) {
+            canal_metricas_t *canal = &s_canais[i];
+            const uint32_t periodo_publicado_us =
+                canal->frequencia_publicada_q16 ? (uint32_t)((1000000ULL << 16) / canal->frequencia_publicada_q16) : 0;
+            despertador_bordas_armar(&canal->despertador, periodo_publicado_us);
+            if (espera_ms == GOVERNADOR_ESPERA_INFINITA && !fila_bordas_vazia(&canal->fila)) {
+                /* Borda chegou entre a ultima drenagem e o rearme */
+                espera_ms = 0;
             }
-            ultimo_ms = agora_ms;
         }
-
-        if (sinal_ativo && ultima_atualizacao > 0 && (agora_ms - ultima_atualizacao) > TEMPO_IDLE_MS) {
-            portENTER_CRITICAL(&s_spinlock_pulso);
-            s_sinal_ativo = false;
-            s_tempo_sinal_ms += agora_ms - s_inicio_sinal_ms;
-            tempo_ms = s_tempo_sinal_ms;
-            portEXIT_CRITICAL(&s_spinlock_pulso);
-            sinal_ativo = false;
-            inicio_sinal_ms = 0;
-        } else if (!sinal_ativo && ultima_atualizacao > 0 && (agora_ms - ultima_atualizacao) > TEMPO_RESET_MS) {
-            portENTER_CRITICAL(&s_spinlock_pulso);
-            s_periodo_us = 0;
-            s_total_furos = 0;
-            s_ultimo_pulso_us = 0;
-            s_ultimo_interrupt_us = 0;
-            s_ultima_atualizacao_ms = 0;
-            s_sinal_ativo = false;
-            s_inicio_sinal_ms = 0;
-            s_tempo_sinal_ms = 0;
-            portEXIT_CRITICAL(&s_spinlock_pulso);
-            distancia_m = 0;
-            ultimo_ms = agora_ms;
-            continue;
+        const TickType_t espera = espera_ms == GOVERNADOR_ESPERA_INFINITA ? portMAX_DELAY : pdMS_TO_TICKS(espera_ms);
+        if (ulTaskNotifyTake(pdTRUE, espera) > 0) {
+            /* Despertado por uma fonte: respeita o intervalo minimo entre publicacoes */
+            const int64_t desde_ultima_ms = esp_timer_get_time() / 1000 - ultima_publicacao_ms;
+            if (desde_ultima_ms < INTERVALO_RAPIDO_MS) {
+                vTaskDelay(pdMS_TO_TICKS(INTERVALO_RAPIDO_MS - desde_ultima_ms));
+            }
         }
 
-        uint64_t tempo_total_ms = tempo_ms;
-        if (sinal_ativo && inicio_sinal_ms > 0 && agora_ms > inicio_sinal_ms) {
-            tempo_total_ms += (uint64_t)(agora_ms - inicio_sinal_ms);
-        }
+        const int64_t agora_us = esp_timer_get_time();
+        const int64_t agora_ms = agora_us / 1000;
+        bool mudou = false;
+        bool algum_ativo = false;
+        uint32_t prazo_ms = GOVERNADOR_ESPERA_INFINITA;
+
+        for (uint8_t i = 0; i < CONFIG_CONTADOR_CANAIS; i++) {
+            canal_metricas_t *canal = &s_canais[i];
+            despertador_bordas_desarmar(&canal->despertador);
+            fonte_pulsos_amostrar(canal->fonte, agora_us);
+            processar_bordas(i);
+            decimador_escopo_avancar(&canal->escopo, agora_us);
+
+            dados_medidos_t medicao;
+            const bool sinal_ativo = nucleo_medicao_publicar(&canal->nucleo, &medicao);
+            const uint32_t frequencia_q16 = medicao.frequencia_q16;
+            const uint32_t variacao_q16 = frequencia_q16 > canal->frequencia_publicada_q16
+                                              ? frequencia_q16 - canal->frequencia_publicada_q16
+                                              : canal->frequencia_publicada_q16 - frequencia_q16;
+            mudou |= variacao_q16 > LIMIAR_MUDANCA_Q16 || sinal_ativo != canal->sinal_publicado;
+            algum_ativo |= sinal_ativo;
 
-        if (s_callback) {
-            dados_medidos_t medicao = {
-                .frequencia_hz = frequencia,
-                .rpm = rpm,
-                .velocidade_cm_s = velocidade_cm_s,
-                .distancia_m = distancia_m,
-                .furos = furos,
-                .tempo_sinal_ms = tempo_total_ms,
+            medicao.carimbo = (carimbo_medicao_t){
+                .sequencia = ++canal->sequencia,
+                .borda_us = canal->borda_nao_publicada_us,
+                .publicacao_us = esp_timer_get_time(),
             };
-            s_callback(&medicao);
+            canal->borda_nao_publicada_us = 0;
+            barramento_metricas_publicar(&s_barramento, i, &medicao);
+            if (i == 0) {
+                tendencia_registrar(&medicao, agora_ms);
+            }
+            resumo_sessao_t resumo;
+            if (nucleo_medicao_retirar_resumo(&canal->nucleo, &resumo)) {
+                resumo.canal = i;
+                historico_sessoes_registrar(&resumo);
+            }
+            canal->frequencia_publicada_q16 = frequencia_q16;
+            canal->sinal_publicado = sinal_ativo;
+
+            uint32_t prazo_canal_ms = nucleo_medicao_prazo_ms(&canal->nucleo);
+            if (sinal_ativo && prazo_fila_ms(frequencia_q16) < prazo_canal_ms) {
+                /* O batimento lento nao pode deixar a fila transbordar em sinais rapidos */
+                prazo_canal_ms = prazo_fila_ms(frequencia_q16);
+            }
+            if (prazo_canal_ms < prazo_ms) {
+                prazo_ms = prazo_canal_ms;
+            }
         }
+        ultima_publicacao_ms = agora_ms;
+
+        espera_ms = governador_publicacao_avaliar(&s_governador, mudou, algum_ativo, prazo_ms);
     }
 }
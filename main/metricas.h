@@ -1,9 +1,46 @@
 #pragma once
 
 #include "app_types.h"
+#include "decimador_escopo.h"
+#include "estatisticas_curso.h"
 #include "esp_err.h"
 
-typedef void (*metricas_callback_t)(const dados_medidos_t *dados);
+#define METRICAS_MAX_CANAIS 4
 
-esp_err_t metricas_inicializar(const configuracao_curso_t *config, metricas_callback_t callback);
+typedef struct {
+    uint32_t bordas_perdidas;
+    uint32_t bordas_aceitas;
+    uint32_t glitches_rejeitados;
+    uint32_t pilha_livre_bytes;   /* menor folga ja vista na pilha da tarefa de metricas */
+} metricas_diagnostico_t;
+
+esp_err_t metricas_inicializar(const configuracao_curso_t *config);
 void metricas_atualizar_curso(float novo_curso_cm);
+/* Tempos de pausa/encerramento da sessao em todos os canais; pode vir de qualquer tarefa */
+void metricas_configurar_sessao(const configuracao_sessao_t *sessao);
+uint8_t metricas_total_canais(void);
+/*
+ * Ultima publicacao de cada canal, sem espera e para qualquer numero de
+ * leitores. metricas_versao() cresce a cada publicacao; metricas_ler() so
+ * copia se a versao mudou desde *versao (sempre, com NULL) e a atualiza.
+ */
+uint32_t metricas_versao(uint8_t canal);
+bool metricas_ler(uint8_t canal, uint32_t *versao, dados_medidos_t *destino);
+void metricas_obter_diagnostico(uint8_t canal, metricas_diagnostico_t *diagnostico);
+/* Histograma log2 dos periodos da sessao; limites via estatisticas_curso_inicio_faixa() */
+size_t metricas_copiar_histograma(uint8_t canal, uint32_t *destino, size_t max);
+/* Colunas min/max do osciloscopio (1 ms cada) chegadas desde *cursor; avanca o cursor */
+size_t metricas_ler_colunas_escopo(uint8_t canal, uint32_t *cursor, coluna_escopo_t *destino, size_t max);
+/* A UI avisa quando o osciloscopio aparece ou some: visivel, a publicacao nao espera mais que um quadro */
+void metricas_definir_escopo_visivel(bool visivel);
+/*
+ * Light sleep (ver modo_economia.h). preparar arma o pino de cada canal
+ * como fonte de despertar; sono_interrompido, logo antes de dormir, diz se
+ * algum pino ja saiu do repouso; retomar restaura as fontes, entrega a borda
+ * que acordou o chip (ou interrompeu o sono) e acorda a tarefa de metricas. Retorna true se algum canal
+ * recebeu borda. Chamar no nucleo de app_main, onde as ISRs foram instaladas.
+ */
+bool metricas_suporta_sono(void);
+esp_err_t metricas_preparar_sono(void);
+bool metricas_sono_interrompido(void);
+bool metricas_retomar_sono(int64_t despertar_us);
@@ -0,0 +1,168 @@
+#include "modo_economia.h"
+
+#include "display_driver.h"
+#include "gpio_despertar.h"
+#include "interface_usuario.h"
+#include "metricas.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+
+#include "driver/gpio.h"
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#define PILHA_TAREFA_ECONOMIA     3072
+#define PRIORIDADE_ECONOMIA       1
+#define INTERVALO_VERIFICACAO_MS  1000
+#define VIGILIA_US                (30LL * 1000 * 1000)
+#define TRABALHO_VIGILIA_MS       50
+#define GPIO_TOQUE                ((gpio_num_t)DISPLAY_TOUCH_INT_GPIO)
+
+static const char *TAG = "modo_economia";
+
+typedef enum {
+    DESPERTAR_VIGILIA = 0,     /* timer: volta a dormir */
+    DESPERTAR_BORDA,
+    DESPERTAR_TOQUE,
+    DESPERTAR_FALHA,           /* nao conseguiu armar os pinos */
+} despertar_t;
+
+static _Atomic uint32_t s_ciclos_sono = 0;
+static _Atomic uint32_t s_despertares_borda = 0;
+static _Atomic uint32_t s_despertares_toque = 0;
+static _Atomic uint32_t s_segundos_dormindo = 0;
+
+static void tarefa_economia(void *param);
+
+esp_err_t modo_economia_inicializar(void)
+{
+    ESP_RETURN_ON_FALSE(metricas_suporta_sono(), ESP_ERR_NOT_SUPPORTED, TAG,
+                        "Fonte de pulsos sem light sleep (use GPIO ou MCPWM)");
+    ESP_RETURN_ON_ERROR(esp_sleep_enable_gpio_wakeup(), TAG, "esp_sleep_enable_gpio_wakeup");
+    /* Mesmo nucleo de app_main: as ISRs das fontes e do toque foram instaladas nele */
+    BaseType_t criada = xTaskCreatePinnedToCore(tarefa_economia, "economia", PILHA_TAREFA_ECONOMIA, NULL,
+                                                PRIORIDADE_ECONOMIA, NULL, xPortGetCoreID());
+    ESP_RETURN_ON_FALSE(criada == pdPASS, ESP_FAIL, TAG, "Falha ao criar tarefa");
+    return ESP_OK;
+}
+
+void modo_economia_obter_diagnostico(modo_economia_diagnostico_t *diagnostico)
+{
+    if (!diagnostico) {
+        return;
+    }
+    diagnostico->ciclos_sono = atomic_load_explicit(&s_ciclos_sono, memory_order_relaxed);
+    diagnostico->despertares_borda = atomic_load_explicit(&s_despertares_borda, memory_order_relaxed);
+    diagnostico->despertares_toque = atomic_load_explicit(&s_despertares_toque, memory_order_relaxed);
+    diagnostico->segundos_dormindo = atomic_load_explicit(&s_segundos_dormindo, memory_order_relaxed);
+}
+
+static void incrementar(_Atomic uint32_t *contador, uint32_t valor)
+{
+    atomic_store_explicit(contador, atomic_load_explicit(contador, memory_order_relaxed) + valor,
+                          memory_order_relaxed);
+}
+
+/* Sinal ativo ou furos novos em qualquer canal desde a ultima verificacao */
+static bool houve_bordas(uint32_t *furos)
+{
+    bool atividade = false;
+    for (uint8_t canal = 0; canal < metricas_total_canais(); canal++) {
+        dados_medidos_t dados;
+        if (!metricas_ler(canal, NULL, &dados)) {
+            continue;
+        }
+        atividade |= dados.estado_sessao == SESSAO_ATIVA || dados.furos != furos[canal];
+        furos[canal] = dados.furos;
+    }
+    return atividade;
+}
+
+static despertar_t dormir_uma_vez(int64_t *dormindo_us)
+{
+    if (metricas_preparar_sono() != ESP_OK) {
+        return DESPERTAR_FALHA;
+    }
+    /* O GT911 baixa o INT a cada relatorio de toque; o status travado guarda o toque ate conferir */
+    gpio_intr_disable(GPIO_TOQUE);
+    gpio_wakeup_enable(GPIO_TOQUE, GPIO_INTR_LOW_LEVEL);
+    esp_sleep_enable_timer_wakeup(VIGILIA_US);
+
+    const int64_t inicio_us = esp_timer_get_time();
+    /* Ultima conferencia: um pulso inteiro desde que armou nao acordaria o chip, que so ve o nivel.
+     * Um pino ja no nivel de despertar faz o sono ser rejeitado: despertar imediato */
+    const bool interrompido = metricas_sono_interrompido();
+    if (!interrompido && !gpio_despertar_travado(GPIO_TOQUE)) {
+        esp_light_sleep_start();
+    }
+    const int64_t despertar_us = esp_timer_get_time();
+    *dormindo_us += despertar_us - inicio_us;
+
+    /* Toque so se foi o INT do GT911 que disparou, nao qualquer despertar por GPIO */
+    const bool toque = gpio_despertar_travado(GPIO_TOQUE);
+    gpio_wakeup_disable(GPIO_TOQUE);
+    gpio_set_intr_type(GPIO_TOQUE, GPIO_INTR_NEGEDGE);
+    gpio_intr_enable(GPIO_TOQUE);
+    const bool borda = metricas_retomar_sono(despertar_us);
+    incrementar(&s_ciclos_sono, 1U);
+    /* Sono interrompido sem borda entregue: a captura MCPWM ja contou o pulso */
+    if (borda || interrompido) {
+        incrementar(&s_despertares_borda, 1U);
+        return DESPERTAR_BORDA;
+    }
+    if (toque) {
+        incrementar(&s_despertares_toque, 1U);
+        return DESPERTAR_TOQUE;
+    }
+    /* Timer, ou subida do sinal em repouso baixo: volta a dormir armado para a descida */
+    return DESPERTAR_VIGILIA;
+}
+
+static void economizar(void)
+{
+    ESP_LOGI(TAG, "Sem atividade por %d s: tela suspensa, entrando em light sleep", CONFIG_CONTADOR_ECONOMIA_OCIOSO_S);
+    esp_err_t err = interface_usuario_suspender();
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Nao foi possivel suspender a tela (0x%x)", err);
+        return;
+    }
+    int64_t dormindo_us = 0;
+    despertar_t despertar;
+    while ((despertar = dormir_uma_vez(&dormindo_us)) == DESPERTAR_VIGILIA) {
+        /* Tarefas com prazo vencido (sessoes, historico) rodam antes de voltar a dormir */
+        vTaskDelay(pdMS_TO_TICKS(TRABALHO_VIGILIA_MS));
+    }
+    err = interface_usuario_retomar(despertar == DESPERTAR_TOQUE);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Falha ao retomar a tela (0x%x)", err);
+    }
+    incrementar(&s_segundos_dormindo, (uint32_t)(dormindo_us / 1000000));
+    ESP_LOGI(TAG, "Acordado apos %lld ms em sono", (long long)(dormindo_us / 1000));
+}
+
+static void tarefa_economia(void *param)
+{
+    (void)param;
+    const int64_t ocioso_us = (int64_t)CONFIG_CONTADOR_ECONOMIA_OCIOSO_S * 1000000;
+    uint32_t furos[METRICAS_MAX_CANAIS] = {0};
+    int64_t ultima_borda_us = esp_timer_get_time();
+
+    while (true) {
+        vTaskDelay(pdMS_TO_TICKS(INTERVALO_VERIFICACAO_MS));
+        const int64_t agora_us = esp_timer_get_time();
+        if (houve_bordas(furos)) {
+            ultima_borda_us = agora_us;
+        }
+        if (agora_us - ultima_borda_us < ocioso_us ||
+            interface_usuario_inativo_ms() < (uint32_t)CONFIG_CONTADOR_ECONOMIA_OCIOSO_S * 1000U) {
+            continue;
+        }
+        economizar();
+        ultima_borda_us = esp_timer_get_time();
+    }
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+
+/*
+ * Modo de economia: sem bordas em nenhum canal e sem toque por
+ * CONFIG_CONTADOR_ECONOMIA_OCIOSO_S, para o LVGL, apaga o backlight e dorme
+ * em light sleep. Acorda pelo pino de qualquer canal ou pelo INT do GT911;
+ * a borda que acordou o chip e entregue pela propria fonte (ver
+ * fonte_pulsos.h), entao nenhuma se perde. Despertares periodicos deixam
+ * prazos de sessao e gravacoes andarem sem religar a tela.
+ */
+typedef struct {
+    uint32_t ciclos_sono;
+    uint32_t despertares_borda;
+    uint32_t despertares_toque;
+    uint32_t segundos_dormindo;
+} modo_economia_diagnostico_t;
+
+esp_err_t modo_economia_inicializar(void);
+void modo_economia_obter_diagnostico(modo_economia_diagnostico_t *diagnostico);
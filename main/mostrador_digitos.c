@@ -0,0 +1,205 @@
+#include "mostrador_digitos.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+#define TOTAL_GLIFOS     (sizeof(MOSTRADOR_GLIFOS) - 1U)
+#define SEM_GLIFO        UINT8_MAX
+
+static const char *TAG = "mostrador";
+
+typedef struct {
+    const lv_font_t *fonte;
+    lv_color_t cor_texto;
+    lv_color_t cor_fundo;
+    uint8_t *atlas;                          /* um glifo apos o outro, cada um contiguo */
+    lv_image_dsc_t glifos[TOTAL_GLIFOS];
+    lv_obj_t *celulas[MOSTRADOR_MAX_CELULAS];
+    uint8_t glifo_celula[MOSTRADOR_MAX_CELULAS];
+} mostrador_t;
+
+/* Digitos com a largura do mais largo: o valor nao se desloca quando um 1 vira 8 */
+static int32_t largura_glifo(const lv_font_t *fonte, char caractere)
+{
+    if (caractere < '0' || caractere > '9') {
+        return lv_font_get_glyph_width(fonte, (uint32_t)caractere, 0);
+    }
+    int32_t maior = 0;
+    for (char digito = '0'; digito <= '9'; digito++) {
+        const int32_t largura = lv_font_get_glyph_width(fonte, (uint32_t)digito, 0);
+        if (largura > maior) {
+            maior = largura;
+        }
+    }
+    return maior;
+}
+
+static void desenhar_atlas(mostrador_t *mostrador)
+{
+    lv_obj_t *canvas = lv_canvas_create(lv_layer_top());
+    lv_obj_add_flag(canvas, LV_OBJ_FLAG_HIDDEN);
+    char texto[2] = {0};
+    for (size_t i = 0; i < TOTAL_GLIFOS; i++) {
+        lv_image_dsc_t *glifo = &mostrador->glifos[i];
+        lv_canvas_set_buffer(canvas, (void *)glifo->data, glifo->header.w, glifo->header.h, LV_COLOR_FORMAT_RGB565);
+        lv_canvas_fill_bg(canvas, mostrador->cor_fundo, LV_OPA_COVER);
+
+        lv_layer_t camada;
+        lv_canvas_init_layer(canvas, &camada);
+        lv_draw_label_dsc_t estilo;
+        lv_draw_label_dsc_init(&estilo);
+        estilo.font = mostrador->fonte;
+        estilo.color = mostrador->cor_texto;
+        estilo.align = LV_TEXT_ALIGN_CENTER;
+        texto[0] = MOSTRADOR_GLIFOS[i];
+        estilo.text = texto;
+        const lv_area_t area = {0, 0, glifo->header.w - 1, glifo->header.h - 1};
+        lv_draw_label(&camada, &estilo, &area);
+        lv_canvas_finish_layer(canvas, &camada);
+    }
+    lv_obj_delete(canvas);
+}
+
+static bool alocar_atlas(mostrador_t *mostrador)
+{
+    const int32_t altura = lv_font_get_line_height(mostrador->fonte);
+    size_t tamanho = 0;
+    for (size_t i = 0; i < TOTAL_GLIFOS; i++) {
+        const uint32_t largura = (uint32_t)largura_glifo(mostrador->fonte, MOSTRADOR_GLIFOS[i]);
+        tamanho += lv_draw_buf_width_to_stride(largura, LV_COLOR_FORMAT_RGB565) * (uint32_t)altura;
+    }
+    /* Interna copia mais rapido; PSRAM se nao couber */
+    mostrador->atlas = heap_caps_malloc(tamanho, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!mostrador->atlas) {
+        mostrador->atlas = heap_caps_malloc(tamanho, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    }
+    if (!mostrador->atlas) {
+        ESP_LOGW(TAG, "Sem memoria para o atlas (%u bytes)", (unsigned)tamanho);
+        return false;
+    }
+
+    size_t deslocamento = 0;
+    for (size_t i = 0; i < TOTAL_GLIFOS; i++) {
+        const uint32_t largura = (uint32_t)largura_glifo(mostrador->fonte, MOSTRADOR_GLIFOS[i]);
+        const uint32_t passo = lv_draw_buf_width_to_stride(largura, LV_COLOR_FORMAT_RGB565);
+        mostrador->glifos[i] = (lv_image_dsc_t){
+            .header = {
+                .magic = LV_IMAGE_HEADER_MAGIC,
+                .cf = LV_COLOR_FORMAT_RGB565,
+                .w = largura,
+                .h = (uint32_t)altura,
+                .stride = passo,
+            },
+            .data_size = passo * (uint32_t)altura,
+            .data = mostrador->atlas + deslocamento,
+        };
+        deslocamento += passo * (uint32_t)altura;
+    }
+    ESP_LOGI(TAG, "Atlas de %u glifos, %u bytes", (unsigned)TOTAL_GLIFOS, (unsigned)tamanho);
+    return true;
+}
+
+static void ao_excluir(lv_event_t *evento)
+{
+    mostrador_t *mostrador = lv_event_get_user_data(evento);
+    heap_caps_free(mostrador->atlas);
+    heap_caps_free(mostrador);
+}
+
+static lv_obj_t *criar_reserva(lv_obj_t *pai, const lv_font_t *fonte, lv_color_t cor_texto)
+{
+    lv_obj_t *label = lv_label_create(pai);
+    lv_obj_set_style_text_font(label, fonte, 0);
+    lv_obj_set_style_text_color(label, cor_texto, 0);
+    lv_obj_set_style_text_align(label, LV_TEXT_ALIGN_CENTER, 0);
+    lv_label_set_text(label, "");
+    return label;
+}
+
+lv_obj_t *mostrador_digitos_criar(lv_obj_t *pai, const lv_font_t *fonte, lv_color_t cor_texto, lv_color_t cor_fundo)
+{
+    mostrador_t *mostrador = heap_caps_calloc(1, sizeof(*mostrador), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!mostrador) {
+        return criar_reserva(pai, fonte, cor_texto);
+    }
+    mostrador->fonte = fonte;
+    mostrador->cor_texto = cor_texto;
+    mostrador->cor_fundo = cor_fundo;
+    if (!alocar_atlas(mostrador)) {
+        heap_caps_free(mostrador);
+        return criar_reserva(pai, fonte, cor_texto);
+    }
+    desenhar_atlas(mostrador);
+
+    lv_obj_t *obj = lv_obj_create(pai);
+    lv_obj_remove_style_all(obj);
+    /* Toques seguem para o container, como no label que isto substitui */
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_size(obj, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
+    lv_obj_set_flex_flow(obj, LV_FLEX_FLOW_ROW);
+    for (size_t i = 0; i < MOSTRADOR_MAX_CELULAS; i++) {
+        lv_obj_t *celula = lv_image_create(obj);
+        lv_obj_add_flag(celula, LV_OBJ_FLAG_HIDDEN);
+        mostrador->celulas[i] = celula;
+        mostrador->glifo_celula[i] = SEM_GLIFO;
+    }
+    lv_obj_set_user_data(obj, mostrador);
+    lv_obj_add_event_cb(obj, ao_excluir, LV_EVENT_DELETE, mostrador);
+    return obj;
+}
+
+void mostrador_digitos_definir_fundo(lv_obj_t *obj, lv_color_t cor_fundo)
+{
+    if (lv_obj_check_type(obj, &lv_label_class)) {
+        return;
+    }
+    mostrador_t *mostrador = lv_obj_get_user_data(obj);
+    if (lv_color_eq(mostrador->cor_fundo, cor_fundo)) {
+        return;
+    }
+    mostrador->cor_fundo = cor_fundo;
+    desenhar_atlas(mostrador);
+    /* As celulas apontam para os mesmos glifos: o LVGL nao ve a troca sozinho */
+    lv_obj_invalidate(obj);
+}
+
+bool mostrador_digitos_definir_texto(lv_obj_t *obj, const char *texto)
+{
+    if (lv_obj_check_type(obj, &lv_label_class)) {
+        if (strcmp(lv_label_get_text(obj), texto) == 0) {
+            return false;
+        }
+        lv_label_set_text(obj, texto);
+        return true;
+    }
+
+    mostrador_t *mostrador = lv_obj_get_user_data(obj);
+    const uint8_t espaco = (uint8_t)(strchr(MOSTRADOR_GLIFOS, ' ') - MOSTRADOR_GLIFOS);
+    bool mudou = false;
+    size_t i = 0;
+    for (; texto[i] != '\0' && i < MOSTRADOR_MAX_CELULAS; i++) {
+        const char *posicao = strchr(MOSTRADOR_GLIFOS, texto[i]);
+        const uint8_t glifo = posicao ? (uint8_t)(posicao - MOSTRADOR_GLIFOS) : espaco;
+        lv_obj_t *celula = mostrador->celulas[i];
+        if (mostrador->glifo_celula[i] != glifo) {
+            /* Invalida so a celula (e as seguintes, se a largura mudar) */
+            lv_image_set_src(celula, &mostrador->glifos[glifo]);
+            mostrador->glifo_celula[i] = glifo;
+            mudou = true;
+        }
+        if (lv_obj_has_flag(celula, LV_OBJ_FLAG_HIDDEN)) {
+            lv_obj_clear_flag(celula, LV_OBJ_FLAG_HIDDEN);
+            mudou = true;
+        }
+    }
+    for (; i < MOSTRADOR_MAX_CELULAS; i++) {
+        if (!lv_obj_has_flag(mostrador->celulas[i], LV_OBJ_FLAG_HIDDEN)) {
+            lv_obj_add_flag(mostrador->celulas[i], LV_OBJ_FLAG_HIDDEN);
+            mudou = true;
+        }
+    }
+    return mudou;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "lvgl.h"
+
+/*
+ * Mostrador numerico para os valores grandes: os glifos de MOSTRADOR_GLIFOS
+ * sao desenhados uma vez num atlas RGB565 opaco (cor do texto sobre a cor
+ * de fundo) e cada caractere e uma celula lv_image que aponta para o seu
+ * glifo. Trocar o texto so mexe nas celulas cujo caractere mudou; o resto
+ * nao e invalidado. Digitos tem largura fixa, entao a posicao deles nao
+ * danca quando o valor muda. Caracteres fora do conjunto viram espaco.
+ *
+ * Tudo com o lock do LVGL. Sem memoria para o atlas, cai para um label.
+ */
+#define MOSTRADOR_GLIFOS         "0123456789.- km"
+#define MOSTRADOR_MAX_CELULAS    (12)
+
+lv_obj_t *mostrador_digitos_criar(lv_obj_t *pai, const lv_font_t *fonte, lv_color_t cor_texto, lv_color_t cor_fundo);
+/* Redesenha o atlas; a cor deve ser a do que estiver atras do mostrador */
+void mostrador_digitos_definir_fundo(lv_obj_t *mostrador, lv_color_t cor_fundo);
+/* Devolve true se alguma celula mudou */
+bool mostrador_digitos_definir_texto(lv_obj_t *mostrador, const char *texto);
@@ -0,0 +1,80 @@
+#include "partida.h"
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+
+#define BIT_FASE(fase)   ((EventBits_t)1U << (fase))
+#define BITS_PRONTO      (BIT_FASE(PARTIDA_CONFIGURACAO) | BIT_FASE(PARTIDA_DISPLAY) | \
+                          BIT_FASE(PARTIDA_UI) | BIT_FASE(PARTIDA_METRICAS))
+
+static const char *TAG = "partida";
+
+static const char *const s_nomes[PARTIDA_FASES] = {
+    [PARTIDA_CONFIGURACAO] = "configuracao",
+    [PARTIDA_DISPLAY] = "display",
+    [PARTIDA_UI] = "ui",
+    [PARTIDA_METRICAS] = "metricas",
+    [PARTIDA_SPLASH_FECHADA] = "splash fechada",
+    [PARTIDA_PRIMEIRA_MEDICAO] = "primeira medicao",
+};
+
+static StaticEventGroup_t s_grupo_buffer;
+static EventGroupHandle_t s_grupo;
+static portMUX_TYPE s_trava = portMUX_INITIALIZER_UNLOCKED;
+/* Escrito uma vez antes do bit da fase; so e lido depois do bit */
+static int64_t s_instantes_us[PARTIDA_FASES];
+
+void partida_inicializar(void)
+{
+    s_grupo = xEventGroupCreateStatic(&s_grupo_buffer);
+}
+
+void partida_marcar(partida_fase_t fase)
+{
+    if (fase >= PARTIDA_FASES) {
+        return;
+    }
+    const int64_t agora_us = esp_timer_get_time();
+    bool primeira = false;
+    portENTER_CRITICAL(&s_trava);
+    if (s_instantes_us[fase] == 0) {
+        s_instantes_us[fase] = agora_us;
+        primeira = true;
+    }
+    portEXIT_CRITICAL(&s_trava);
+    if (!primeira) {
+        return;
+    }
+    xEventGroupSetBits(s_grupo, BIT_FASE(fase));
+    ESP_LOGI(TAG, "%s em %lld ms", s_nomes[fase], (long long)(agora_us / 1000));
+}
+
+bool partida_concluida(partida_fase_t fase)
+{
+    return fase < PARTIDA_FASES && (xEventGroupGetBits(s_grupo) & BIT_FASE(fase)) != 0;
+}
+
+bool partida_pronta(void)
+{
+    return (xEventGroupGetBits(s_grupo) & BITS_PRONTO) == BITS_PRONTO;
+}
+
+void partida_aguardar(partida_fase_t fase)
+{
+    if (fase < PARTIDA_FASES) {
+        xEventGroupWaitBits(s_grupo, BIT_FASE(fase), pdFALSE, pdTRUE, portMAX_DELAY);
+    }
+}
+
+void partida_obter_diagnostico(partida_diagnostico_t *diagnostico)
+{
+    if (!diagnostico) {
+        return;
+    }
+    const EventBits_t bits = xEventGroupGetBits(s_grupo);
+    for (int fase = 0; fase < PARTIDA_FASES; fase++) {
+        diagnostico->instante_us[fase] = (bits & BIT_FASE(fase)) ? s_instantes_us[fase] : -1;
+    }
+}
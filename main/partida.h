@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Fases do boot. Cada subsistema marca a sua quando fica pronto, de qualquer
+ * tarefa; o instante (esp_timer, desde o boot) vai para o log e para o
+ * diagnostico. Quem depende de uma fase espera por ela sem polling, e a
+ * splash some assim que partida_pronta() fica verdadeira.
+ */
+typedef enum {
+    PARTIDA_CONFIGURACAO = 0,   /* NVS aberta e configuracao carregada */
+    PARTIDA_DISPLAY,            /* painel e LVGL no ar, splash na tela */
+    PARTIDA_UI,                 /* widgets criados */
+    PARTIDA_METRICAS,           /* fontes armadas: os pulsos ja contam */
+    PARTIDA_SPLASH_FECHADA,
+    PARTIDA_PRIMEIRA_MEDICAO,   /* primeira medicao aplicada na tela */
+    PARTIDA_FASES,
+} partida_fase_t;
+
+typedef struct {
+    int64_t instante_us[PARTIDA_FASES];   /* -1 enquanto a fase nao chegou */
+} partida_diagnostico_t;
+
+/* Antes de qualquer outra chamada, no inicio de app_main */
+void partida_inicializar(void);
+/* So a primeira marcacao de cada fase conta */
+void partida_marcar(partida_fase_t fase);
+bool partida_concluida(partida_fase_t fase);
+/* Configuracao, display, UI e metricas prontas */
+bool partida_pronta(void);
+void partida_aguardar(partida_fase_t fase);
+void partida_obter_diagnostico(partida_diagnostico_t *diagnostico);
@@ -0,0 +1,209 @@
+#include "tela_tendencia.h"
+
+#include <stdio.h>
+
+#include "tema_ui.h"
+#include "tendencia.h"
+
+#define INTERVALO_ATUALIZACAO_MS  (1000)
+#define ZOOM_COUNT                (4)
+
+typedef struct {
+    const char *titulo;
+    const char *unidade;
+    uint32_t escala;            /* unidades do grafico por unidade da metrica */
+    uint32_t divisor;           /* para voltar ao valor exibido */
+} metrica_tendencia_t;
+
+static const metrica_tendencia_t s_metricas[] = {
+    [TENDENCIA_FREQUENCIA] = {"Frequencia", "Hz", 10, 10},
+    [TENDENCIA_RPM] = {"RPM", "rpm", 60, 1},
+    [TENDENCIA_VELOCIDADE] = {"Velocidade", "cm/s", 1, 1},
+};
+
+static const uint32_t s_zooms_s[ZOOM_COUNT] = {
+    60U,
+    600U,
+    3600U,
+    (uint32_t)CONFIG_CONTADOR_TENDENCIA_HORAS * 3600U,
+};
+
+static lv_obj_t *s_container;
+static lv_obj_t *s_titulo;
+static lv_obj_t *s_grafico;
+static lv_obj_t *s_rodape;
+static lv_chart_series_t *s_serie_maximo;
+static lv_chart_series_t *s_serie_media;
+static lv_chart_series_t *s_serie_minimo;
+static lv_timer_t *s_timer;
+static void (*s_ao_sair)(void);
+
+static tendencia_metrica_t s_metrica = TENDENCIA_FREQUENCIA;
+static uint8_t s_zoom = 0;
+
+static ponto_tendencia_t s_pontos[TELA_TENDENCIA_MAX_PONTOS];
+static int32_t s_maximos[TELA_TENDENCIA_MAX_PONTOS];
+static int32_t s_medias[TELA_TENDENCIA_MAX_PONTOS];
+static int32_t s_minimos[TELA_TENDENCIA_MAX_PONTOS];
+
+static void atualizar(lv_timer_t *timer);
+static void ao_evento(lv_event_t *evento);
+
+static int32_t escalar(uint32_t valor_q16)
+{
+    return (int32_t)(((uint64_t)valor_q16 * s_metricas[s_metrica].escala) >> 16);
+}
+
+static void formatar_valor(char *buffer, size_t len, int32_t valor)
+{
+    const uint32_t divisor = s_metricas[s_metrica].divisor;
+    if (divisor == 1U) {
+        snprintf(buffer, len, "%ld", (long)valor);
+    } else {
+        snprintf(buffer, len, "%ld.%ld", (long)(valor / (int32_t)divisor), (long)(valor % (int32_t)divisor));
+    }
+}
+
+static void formatar_janela(char *buffer, size_t len, uint32_t segundos)
+{
+    if (segundos >= 3600U) {
+        snprintf(buffer, len, "%lu h", (unsigned long)(segundos / 3600U));
+    } else {
+        snprintf(buffer, len, "%lu min", (unsigned long)(segundos / 60U));
+    }
+}
+
+void tela_tendencia_criar(lv_obj_t *tela, void (*ao_sair)(void))
+{
+    s_ao_sair = ao_sair;
+
+    s_container = lv_obj_create(tela);
+    lv_obj_remove_style_all(s_container);
+    lv_obj_set_size(s_container, LV_PCT(100), LV_PCT(100));
+    lv_obj_set_style_bg_color(s_container, lv_color_hex(0x111111), 0);
+    lv_obj_set_style_bg_opa(s_container, LV_OPA_COVER, 0);
+    lv_obj_add_flag(s_container, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_add_flag(s_container, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(s_container, ao_evento, LV_EVENT_ALL, NULL);
+
+    s_titulo = lv_label_create(s_container);
+    tema_ui_aplicar(s_titulo, TEMA_TITULO);
+    lv_obj_align(s_titulo, LV_ALIGN_TOP_MID, 0, 8);
+
+    s_grafico = lv_chart_create(s_container);
+    lv_obj_set_size(s_grafico, LV_PCT(90), LV_PCT(65));
+    lv_obj_align(s_grafico, LV_ALIGN_CENTER, 0, 0);
+    lv_obj_clear_flag(s_grafico, LV_OBJ_FLAG_CLICKABLE);
+    lv_chart_set_type(s_grafico, LV_CHART_TYPE_LINE);
+    lv_chart_set_div_line_count(s_grafico, 5, 6);
+    /* Pontos desligados: com ate 240 pontos so a linha e legivel */
+    lv_obj_set_style_size(s_grafico, 0, 0, LV_PART_INDICATOR);
+    s_serie_maximo = lv_chart_add_series(s_grafico, lv_color_hex(0xFF7043), LV_CHART_AXIS_PRIMARY_Y);
+    s_serie_media = lv_chart_add_series(s_grafico, lv_color_hex(0x00FFC0), LV_CHART_AXIS_PRIMARY_Y);
+    s_serie_minimo = lv_chart_add_series(s_grafico, lv_color_hex(0x42A5F5), LV_CHART_AXIS_PRIMARY_Y);
+    /* Buffers estaticos: trocar o numero de pontos por zoom nao realoca */
+    lv_chart_set_series_ext_y_array(s_grafico, s_serie_maximo, s_maximos);
+    lv_chart_set_series_ext_y_array(s_grafico, s_serie_media, s_medias);
+    lv_chart_set_series_ext_y_array(s_grafico, s_serie_minimo, s_minimos);
+
+    s_rodape = lv_label_create(s_container);
+    tema_ui_aplicar(s_rodape, TEMA_TEXTO_AUXILIAR);
+    lv_obj_align(s_rodape, LV_ALIGN_BOTTOM_MID, 0, -12);
+
+    s_timer = lv_timer_create(atualizar, INTERVALO_ATUALIZACAO_MS, NULL);
+    lv_timer_pause(s_timer);
+}
+
+void tela_tendencia_mostrar(tendencia_metrica_t metrica)
+{
+    if (!s_container) {
+        return;
+    }
+    s_metrica = metrica;
+    s_zoom = 0;
+    lv_obj_clear_flag(s_container, LV_OBJ_FLAG_HIDDEN);
+    atualizar(s_timer);
+    lv_timer_resume(s_timer);
+}
+
+void tela_tendencia_ocultar(void)
+{
+    if (!s_container) {
+        return;
+    }
+    lv_timer_pause(s_timer);
+    lv_obj_add_flag(s_container, LV_OBJ_FLAG_HIDDEN);
+}
+
+static void ao_evento(lv_event_t *evento)
+{
+    const lv_event_code_t code = lv_event_get_code(evento);
+    if (code == LV_EVENT_DOUBLE_CLICKED) {
+        tela_tendencia_ocultar();
+        if (s_ao_sair) {
+            s_ao_sair();
+        }
+    } else if (code == LV_EVENT_SINGLE_CLICKED) {
+        s_zoom = (uint8_t)((s_zoom + 1U) % ZOOM_COUNT);
+        atualizar(s_timer);
+    }
+}
+
+static void atualizar(lv_timer_t *timer)
+{
+    (void)timer;
+    uint32_t periodo_s = 0;
+    const size_t pontos = tendencia_ler(s_zooms_s[s_zoom], TELA_TENDENCIA_MAX_PONTOS, s_pontos, &periodo_s);
+
+    int32_t menor = INT32_MAX;
+    int32_t maior = INT32_MIN;
+    int64_t soma = 0;
+    uint32_t validos = 0;
+    for (size_t i = 0; i < pontos; i++) {
+        if (ponto_tendencia_lacuna(&s_pontos[i])) {
+            s_maximos[i] = s_medias[i] = s_minimos[i] = LV_CHART_POINT_NONE;
+            continue;
+        }
+        const faixa_tendencia_t *faixa = s_metrica == TENDENCIA_VELOCIDADE ? &s_pontos[i].velocidade
+                                                                            : &s_pontos[i].frequencia;
+        s_maximos[i] = escalar(faixa->maximo_q16);
+        s_medias[i] = escalar(faixa->media_q16);
+        s_minimos[i] = escalar(faixa->minimo_q16);
+        if (s_minimos[i] < menor) {
+            menor = s_minimos[i];
+        }
+        if (s_maximos[i] > maior) {
+            maior = s_maximos[i];
+        }
+        soma += s_medias[i];
+        validos++;
+    }
+
+    const metrica_tendencia_t *metrica = &s_metricas[s_metrica];
+    char janela[16];
+    formatar_janela(janela, sizeof(janela), s_zooms_s[s_zoom]);
+    lv_label_set_text_fmt(s_titulo, "%s - %s", metrica->titulo, janela);
+
+    if (validos == 0) {
+        lv_chart_set_point_count(s_grafico, 1);
+        s_maximos[0] = s_medias[0] = s_minimos[0] = LV_CHART_POINT_NONE;
+        lv_chart_refresh(s_grafico);
+        lv_label_set_text(s_rodape, "Sem dados nesta janela");
+        return;
+    }
+
+    /* Folga de 10% para a linha nao encostar na borda */
+    const int32_t folga = (maior - menor) / 10 + 1;
+    lv_chart_set_range(s_grafico, LV_CHART_AXIS_PRIMARY_Y, menor > folga ? menor - folga : 0, maior + folga);
+    lv_chart_set_point_count(s_grafico, (uint32_t)pontos);
+    lv_chart_refresh(s_grafico);
+
+    char minimo[24];
+    char media[24];
+    char maximo[24];
+    formatar_valor(minimo, sizeof(minimo), menor);
+    formatar_valor(media, sizeof(media), (int32_t)(soma / validos));
+    formatar_valor(maximo, sizeof(maximo), maior);
+    lv_label_set_text_fmt(s_rodape, "min %s  media %s  max %s %s  (%lu s/ponto)", minimo, media, maximo,
+                          metrica->unidade, (unsigned long)periodo_s);
+}
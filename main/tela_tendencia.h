@@ -0,0 +1,24 @@
+#pragma once
+
+#include "lvgl.h"
+
+/*
+ * Tela cheia de tendencia do canal principal: minimo, media e maximo por
+ * periodo num lv_chart. Cada toque troca o zoom (1 min, 10 min, 1 h e o
+ * historico inteiro); toque duplo volta. Cada zoom le o nivel da piramide
+ * que cabe nele (ver tendencia.h), entao o grafico nunca passa de
+ * TELA_TENDENCIA_MAX_PONTOS e um dia custa o mesmo que um minuto.
+ *
+ * Tudo com o lock do LVGL.
+ */
+#define TELA_TENDENCIA_MAX_PONTOS (240)
+
+typedef enum {
+    TENDENCIA_FREQUENCIA = 0,
+    TENDENCIA_RPM,
+    TENDENCIA_VELOCIDADE,
+} tendencia_metrica_t;
+
+void tela_tendencia_criar(lv_obj_t *tela, void (*ao_sair)(void));
+void tela_tendencia_mostrar(tendencia_metrica_t metrica);
+void tela_tendencia_ocultar(void);
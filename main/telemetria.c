@@ -0,0 +1,188 @@
+#include "telemetria.h"
+
+#include "codec_telemetria.h"
+#include "metricas.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/message_buffer.h"
+#include "freertos/task.h"
+#if CONFIG_CONTADOR_TELEMETRIA_USB_SERIAL_JTAG
+#include "driver/usb_serial_jtag.h"
+#else
+#include "driver/uart.h"
+#endif
+
+#define BUFFER_LOTES_BYTES       16384
+#define BUFFER_TX_BYTES          8192
+#define BUFFER_RX_BYTES          256
+#define PILHA_TAREFA_TELEMETRIA  4096
+#define PRIORIDADE_TELEMETRIA    2
+
+static const char *TAG = "telemetria";
+
+/* Mensagem do buffer: so os bytes das bordas usadas vao para a fila */
+typedef struct {
+    uint32_t canal;
+    int64_t bordas_us[CODEC_TELEMETRIA_BORDAS_MAX];
+} lote_telemetria_t;
+
+static MessageBufferHandle_t s_buffer = NULL;
+static _Atomic uint32_t s_bordas_descartadas = 0;
+static _Atomic uint32_t s_pacotes_enviados = 0;
+static _Atomic uint32_t s_bytes_enviados = 0;
+
+/* Estado exclusivo de tarefa_telemetria */
+static uint16_t s_sequencia = 0;
+static uint8_t s_quadro[CODEC_TELEMETRIA_QUADRO_MAX];
+static lote_telemetria_t s_lote;
+static uint32_t s_versoes[METRICAS_MAX_CANAIS];
+
+/* Estado exclusivo da tarefa de metricas: montagem do lote fora da pilha dela */
+static lote_telemetria_t s_lote_envio;
+
+static esp_err_t iniciar_transporte(void);
+static void transmitir(size_t tamanho);
+static void tarefa_telemetria(void *param);
+
+esp_err_t telemetria_inicializar(void)
+{
+    ESP_RETURN_ON_ERROR(iniciar_transporte(), TAG, "Falha ao iniciar transporte");
+    s_buffer = xMessageBufferCreate(BUFFER_LOTES_BYTES);
+    ESP_RETURN_ON_FALSE(s_buffer, ESP_ERR_NO_MEM, TAG, "Sem memoria para o buffer");
+    BaseType_t criada = xTaskCreate(tarefa_telemetria, "telemetria", PILHA_TAREFA_TELEMETRIA, NULL,
+                                    PRIORIDADE_TELEMETRIA, NULL);
+    ESP_RETURN_ON_FALSE(criada == pdPASS, ESP_FAIL, TAG, "Falha ao criar tarefa");
+    return ESP_OK;
+}
+
+void telemetria_registrar_bordas(uint8_t canal, const int64_t *bordas_us, size_t quantidade)
+{
+    if (!s_buffer || quantidade == 0) {
+        return;
+    }
+    /* Chamado so pela tarefa de metricas: escritor unico do message buffer */
+    while (quantidade > 0) {
+        const size_t parte = quantidade > CODEC_TELEMETRIA_BORDAS_MAX ? CODEC_TELEMETRIA_BORDAS_MAX : quantidade;
+        /* So o cabecalho e as bordas usadas sao escritos: o resto nao vai para a fila */
+        s_lote_envio.canal = canal;
+        memcpy(s_lote_envio.bordas_us, bordas_us, parte * sizeof(int64_t));
+        const size_t bytes = offsetof(lote_telemetria_t, bordas_us) + parte * sizeof(int64_t);
+        if (xMessageBufferSend(s_buffer, &s_lote_envio, bytes, 0) != bytes) {
+            const uint32_t descartadas = atomic_load_explicit(&s_bordas_descartadas, memory_order_relaxed);
+            atomic_store_explicit(&s_bordas_descartadas, descartadas + (uint32_t)parte, memory_order_relaxed);
+        }
+        bordas_us += parte;
+        quantidade -= parte;
+    }
+}
+
+void telemetria_obter_diagnostico(telemetria_diagnostico_t *diagnostico)
+{
+    if (!diagnostico) {
+        return;
+    }
+    diagnostico->pacotes_enviados = atomic_load_explicit(&s_pacotes_enviados, memory_order_relaxed);
+    diagnostico->bytes_enviados = atomic_load_explicit(&s_bytes_enviados, memory_order_relaxed);
+    diagnostico->bordas_descartadas = atomic_load_explicit(&s_bordas_descartadas, memory_order_relaxed);
+}
+
+/*
+ * O driver copia o quadro para o anel de TX e a ISR do periferico o esvazia;
+ * a escrita so espera quando o anel enche, e ai quem espera e esta tarefa.
+ */
+#if CONFIG_CONTADOR_TELEMETRIA_USB_SERIAL_JTAG
+static esp_err_t iniciar_transporte(void)
+{
+    usb_serial_jtag_driver_config_t config = {
+        .tx_buffer_size = BUFFER_TX_BYTES,
+        .rx_buffer_size = BUFFER_RX_BYTES,
+    };
+    return usb_serial_jtag_driver_install(&config);
+}
+
+static void transmitir(size_t tamanho)
+{
+    usb_serial_jtag_write_bytes(s_quadro, tamanho, portMAX_DELAY);
+}
+#else
+static esp_err_t iniciar_transporte(void)
+{
+    const uart_config_t config = {
+        .baud_rate = CONFIG_CONTADOR_TELEMETRIA_BAUD,
+        .data_bits = UART_DATA_8_BITS,
+        .parity = UART_PARITY_DISABLE,
+        .stop_bits = UART_STOP_BITS_1,
+        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
+        .source_clk = UART_SCLK_DEFAULT,
+    };
+    ESP_RETURN_ON_ERROR(uart_driver_install(CONFIG_CONTADOR_TELEMETRIA_UART_NUM, BUFFER_RX_BYTES, BUFFER_TX_BYTES, 0,
+                                            NULL, 0),
+                        TAG, "uart_driver_install");
+    ESP_RETURN_ON_ERROR(uart_param_config(CONFIG_CONTADOR_TELEMETRIA_UART_NUM, &config), TAG, "uart_param_config");
+    return uart_set_pin(CONFIG_CONTADOR_TELEMETRIA_UART_NUM, CONFIG_CONTADOR_TELEMETRIA_GPIO_TX, UART_PIN_NO_CHANGE,
+                        UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+}
+
+static void transmitir(size_t tamanho)
+{
+    uart_write_bytes(CONFIG_CONTADOR_TELEMETRIA_UART_NUM, s_quadro, tamanho);
+}
+#endif
+
+static void enviar(size_t tamanho)
+{
+    if (tamanho == 0) {
+        return;
+    }
+    transmitir(tamanho);
+    s_sequencia++;
+    atomic_store_explicit(&s_pacotes_enviados, atomic_load_explicit(&s_pacotes_enviados, memory_order_relaxed) + 1U,
+                          memory_order_relaxed);
+    atomic_store_explicit(&s_bytes_enviados,
+                          atomic_load_explicit(&s_bytes_enviados, memory_order_relaxed) + (uint32_t)tamanho,
+                          memory_order_relaxed);
+}
+
+static void enviar_medicoes(void)
+{
+    for (uint8_t canal = 0; canal < metricas_total_canais(); canal++) {
+        telemetria_medicao_t medicao;
+        if (!metricas_ler(canal, &s_versoes[canal], &medicao.dados)) {
+            continue;
+        }
+        medicao.versao = s_versoes[canal];
+        medicao.bordas_descartadas = atomic_load_explicit(&s_bordas_descartadas, memory_order_relaxed);
+        enviar(codec_telemetria_medicao(canal, s_sequencia, &medicao, s_quadro));
+    }
+}
+
+static void tarefa_telemetria(void *param)
+{
+    (void)param;
+    const int64_t intervalo_us = (int64_t)CONFIG_CONTADOR_TELEMETRIA_INTERVALO_MS * 1000;
+    int64_t proxima_medicao_us = esp_timer_get_time();
+    ESP_LOGI(TAG, "Transmitindo a cada %d ms", CONFIG_CONTADOR_TELEMETRIA_INTERVALO_MS);
+
+    while (true) {
+        const int64_t agora_us = esp_timer_get_time();
+        if (agora_us >= proxima_medicao_us) {
+            enviar_medicoes();
+            proxima_medicao_us = agora_us + intervalo_us;
+        }
+        const TickType_t espera = pdMS_TO_TICKS((proxima_medicao_us - agora_us + 999) / 1000);
+        const size_t bytes = xMessageBufferReceive(s_buffer, &s_lote, sizeof(s_lote), espera > 0 ? espera : 1);
+        if (bytes > offsetof(lote_telemetria_t, bordas_us)) {
+            const size_t quantidade = (bytes - offsetof(lote_telemetria_t, bordas_us)) / sizeof(int64_t);
+            enviar(codec_telemetria_bordas((uint8_t)s_lote.canal, s_sequencia, s_lote.bordas_us, quantidade,
+                                           s_quadro));
+        }
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+/*
+ * Telemetria binaria serial (ver codec_telemetria.h): lotes de bordas brutas
+ * entregues pela tarefa de metricas e medicoes lidas do barramento de
+ * metricas. A entrega nunca bloqueia; o que nao cabe no buffer e descartado
+ * e contado. Quem espera pelo enlace e so a tarefa de telemetria.
+ */
+typedef struct {
+    uint32_t pacotes_enviados;
+    uint32_t bytes_enviados;
+    uint32_t bordas_descartadas;   /* lotes que nao couberam no buffer */
+} telemetria_diagnostico_t;
+
+esp_err_t telemetria_inicializar(void);
+void telemetria_registrar_bordas(uint8_t canal, const int64_t *bordas_us, size_t quantidade);
+void telemetria_obter_diagnostico(telemetria_diagnostico_t *diagnostico);
@@ -0,0 +1,129 @@
+#include "tema_ui.h"
+
+#include <stdbool.h>
+
+static lv_style_t s_estilos[TEMA_ESTILOS];
+/* Parte INDICATOR dos estilos de arco e barra; vazio nos demais */
+static lv_style_t s_indicadores[TEMA_ESTILOS];
+static lv_style_t s_cores_metricas[TEMA_UI_MAX_METRICAS];
+static size_t s_total_metricas;
+static bool s_iniciado;
+
+static void texto(lv_style_t *estilo, uint32_t cor, const lv_font_t *fonte)
+{
+    lv_style_set_text_color(estilo, lv_color_hex(cor));
+    lv_style_set_text_font(estilo, fonte);
+}
+
+void tema_ui_inicializar(const uint32_t *cores, size_t quantidade)
+{
+    if (s_iniciado) {
+        return;
+    }
+    for (size_t i = 0; i < TEMA_ESTILOS; i++) {
+        lv_style_init(&s_estilos[i]);
+        lv_style_init(&s_indicadores[i]);
+    }
+
+    lv_style_t *grid = &s_estilos[TEMA_GRID];
+    lv_style_set_pad_all(grid, 16);
+    lv_style_set_pad_row(grid, 12);
+    lv_style_set_pad_column(grid, 16);
+    lv_style_set_bg_opa(grid, LV_OPA_TRANSP);
+
+    lv_style_t *card = &s_estilos[TEMA_CARD];
+    lv_style_set_radius(card, 14);
+    lv_style_set_pad_all(card, 16);
+    lv_style_set_bg_opa(card, LV_OPA_40);
+    lv_style_set_border_width(card, 0);
+
+    texto(&s_estilos[TEMA_CARD_TITULO], 0xF5F5F5, &lv_font_montserrat_20);
+    texto(&s_estilos[TEMA_CARD_VALOR], 0xFFFFFF, &lv_font_montserrat_28);
+    lv_style_set_text_align(&s_estilos[TEMA_CARD_VALOR], LV_TEXT_ALIGN_LEFT);
+    texto(&s_estilos[TEMA_CARD_UNIDADE], 0xFFECB3, &lv_font_montserrat_20);
+    texto(&s_estilos[TEMA_DICA], 0xCCCCCC, &lv_font_montserrat_14);
+
+    lv_style_t *tela_cheia = &s_estilos[TEMA_TELA_CHEIA];
+    lv_style_set_bg_color(tela_cheia, lv_color_hex(0x111111));
+    lv_style_set_bg_opa(tela_cheia, LV_OPA_COVER);
+    lv_style_set_pad_all(tela_cheia, 32);
+
+    texto(&s_estilos[TEMA_TITULO], 0xFFFFFF, &lv_font_montserrat_28);
+    lv_style_set_text_align(&s_estilos[TEMA_TITULO], LV_TEXT_ALIGN_CENTER);
+    texto(&s_estilos[TEMA_UNIDADE], 0xF5F5F5, &lv_font_montserrat_28);
+    lv_style_set_text_align(&s_estilos[TEMA_UNIDADE], LV_TEXT_ALIGN_CENTER);
+    texto(&s_estilos[TEMA_TEXTO_AUXILIAR], 0xE0E0E0, &lv_font_montserrat_20);
+    lv_style_set_text_align(&s_estilos[TEMA_TEXTO_AUXILIAR], LV_TEXT_ALIGN_CENTER);
+    texto(&s_estilos[TEMA_LEGENDA_VELOCIDADE], 0xB0BEC5, &lv_font_montserrat_20);
+    lv_style_set_text_align(&s_estilos[TEMA_LEGENDA_VELOCIDADE], LV_TEXT_ALIGN_CENTER);
+    lv_style_set_text_font(&s_estilos[TEMA_TEXTO_STATUS], &lv_font_montserrat_20);
+    texto(&s_estilos[TEMA_SEPARADOR], 0xB0BEC5, &lv_font_montserrat_20);
+    lv_style_set_pad_left(&s_estilos[TEMA_SEPARADOR], 8);
+    lv_style_set_pad_right(&s_estilos[TEMA_SEPARADOR], 8);
+
+    lv_style_t *circulo = &s_estilos[TEMA_CIRCULO_FUROS];
+    lv_style_set_arc_width(circulo, 6);
+    lv_style_set_arc_opa(circulo, LV_OPA_COVER);
+    lv_style_set_arc_color(circulo, lv_color_hex(0xFFE0B2));
+    lv_style_set_arc_width(&s_indicadores[TEMA_CIRCULO_FUROS], 6);
+    lv_style_set_arc_color(&s_indicadores[TEMA_CIRCULO_FUROS], lv_color_hex(0xFF7043));
+
+    lv_style_set_arc_width(&s_estilos[TEMA_ARCO_RPM], 14);
+    lv_style_set_arc_width(&s_indicadores[TEMA_ARCO_RPM], 14);
+    lv_style_set_arc_width(&s_estilos[TEMA_ARCO_CURSO], 12);
+    lv_style_set_arc_width(&s_indicadores[TEMA_ARCO_CURSO], 12);
+
+    lv_style_t *velocidade = &s_estilos[TEMA_BARRA_VELOCIDADE];
+    lv_style_set_bg_color(velocidade, lv_color_hex(0x0E111B));
+    lv_style_set_bg_grad_color(velocidade, lv_color_hex(0x05070D));
+    lv_style_set_bg_grad_dir(velocidade, LV_GRAD_DIR_HOR);
+    lv_style_set_bg_opa(velocidade, LV_OPA_COVER);
+    lv_style_set_radius(velocidade, 12);
+    lv_style_t *velocidade_indicador = &s_indicadores[TEMA_BARRA_VELOCIDADE];
+    lv_style_set_bg_color(velocidade_indicador, lv_color_hex(0x00C9FF));
+    lv_style_set_bg_grad_color(velocidade_indicador, lv_color_hex(0x6A1B9A));
+    lv_style_set_bg_grad_dir(velocidade_indicador, LV_GRAD_DIR_HOR);
+    lv_style_set_bg_opa(velocidade_indicador, LV_OPA_COVER);
+    lv_style_set_radius(velocidade_indicador, 12);
+
+    lv_style_t *distancia = &s_estilos[TEMA_BARRA_DISTANCIA];
+    lv_style_set_bg_color(distancia, lv_color_hex(0x1E1E1E));
+    lv_style_set_bg_opa(distancia, LV_OPA_40);
+    lv_style_set_radius(distancia, 8);
+    lv_style_t *distancia_indicador = &s_indicadores[TEMA_BARRA_DISTANCIA];
+    lv_style_set_bg_color(distancia_indicador, lv_color_hex(0x00E676));
+    lv_style_set_bg_opa(distancia_indicador, LV_OPA_COVER);
+    lv_style_set_radius(distancia_indicador, 8);
+
+    s_total_metricas = quantidade < TEMA_UI_MAX_METRICAS ? quantidade : TEMA_UI_MAX_METRICAS;
+    for (size_t i = 0; i < s_total_metricas; i++) {
+        lv_style_init(&s_cores_metricas[i]);
+        lv_style_set_bg_color(&s_cores_metricas[i], lv_color_hex(cores[i]));
+    }
+    s_iniciado = true;
+}
+
+void tema_ui_aplicar(lv_obj_t *obj, tema_estilo_t estilo)
+{
+    if (!obj || estilo >= TEMA_ESTILOS) {
+        return;
+    }
+    lv_obj_add_style(obj, &s_estilos[estilo], LV_PART_MAIN);
+    if (!lv_style_is_empty(&s_indicadores[estilo])) {
+        lv_obj_add_style(obj, &s_indicadores[estilo], LV_PART_INDICATOR);
+    }
+}
+
+void tema_ui_aplicar_cor_metrica(lv_obj_t *obj, size_t metrica)
+{
+    if (!obj || metrica >= s_total_metricas) {
+        return;
+    }
+    for (size_t i = 0; i < s_total_metricas; i++) {
+        if (i != metrica) {
+            lv_obj_remove_style(obj, &s_cores_metricas[i], LV_PART_MAIN);
+        }
+    }
+    /* Adicionado por ultimo: tem precedencia sobre o estilo base */
+    lv_obj_add_style(obj, &s_cores_metricas[metrica], LV_PART_MAIN);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "lvgl.h"
+
+/*
+ * Estilos compartilhados da UI: cada lv_style_t e montado uma vez em
+ * tema_ui_inicializar e ligado aos objetos com lv_obj_add_style. Com
+ * propriedades locais (lv_obj_set_style_*) cada objeto aloca a propria
+ * lista e o LVGL a percorre a cada consulta; aqui todos os cards, labels e
+ * circulos do mesmo tipo apontam para o mesmo estilo. Cores por metrica sao
+ * variantes so com bg_color, empilhadas sobre o estilo base.
+ *
+ * Tudo com o lock do LVGL.
+ */
+#define TEMA_UI_MAX_METRICAS (8)
+
+typedef enum {
+    TEMA_GRID = 0,              /* container dos cards */
+    TEMA_CARD,
+    TEMA_CARD_TITULO,
+    TEMA_CARD_VALOR,
+    TEMA_CARD_UNIDADE,
+    TEMA_DICA,                  /* texto de ajuda do grid */
+    TEMA_TELA_CHEIA,            /* container da tela cheia */
+    TEMA_TITULO,                /* titulo da tela cheia e da tendencia */
+    TEMA_UNIDADE,               /* unidade do valor da tela cheia */
+    TEMA_TEXTO_AUXILIAR,        /* tempo, legendas de arco e barras, rodapes */
+    TEMA_TEXTO_STATUS,          /* segmentos da barra de status (cor local) */
+    TEMA_SEPARADOR,
+    TEMA_CIRCULO_FUROS,         /* partes MAIN e INDICATOR */
+    TEMA_ARCO_RPM,              /* espessura do fundo e do indicador; a cor do indicador e local */
+    TEMA_ARCO_CURSO,
+    TEMA_BARRA_VELOCIDADE,      /* partes MAIN e INDICATOR, gradientes */
+    TEMA_LEGENDA_VELOCIDADE,    /* texto auxiliar em cinza azulado */
+    TEMA_BARRA_DISTANCIA,       /* partes MAIN e INDICATOR */
+    TEMA_ESTILOS,
+} tema_estilo_t;
+
+/* `cores` em 0xRRGGBB, uma por metrica; chamadas repetidas nao fazem nada */
+void tema_ui_inicializar(const uint32_t *cores, size_t quantidade);
+void tema_ui_aplicar(lv_obj_t *obj, tema_estilo_t estilo);
+/* Troca a variante de cor de `obj` (card ou tela cheia) pela da metrica */
+void tema_ui_aplicar_cor_metrica(lv_obj_t *obj, size_t metrica);
@@ -0,0 +1,92 @@
+#include "tendencia.h"
+
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#define DURACAO_S ((uint32_t)CONFIG_CONTADOR_TENDENCIA_HORAS * 3600U)
+#define AMOSTRAS_ADIADAS 8   /* publicacoes guardadas enquanto a UI le; a 33 ms cobre ~250 ms */
+
+typedef struct {
+    int64_t agora_ms;
+    uint32_t frequencia_q16;
+    uint32_t velocidade_q16;
+} amostra_adiada_t;
+
+static const char *TAG = "tendencia";
+
+static piramide_tendencia_t s_piramide;
+static SemaphoreHandle_t s_trava = NULL;
+/* So a tarefa de metricas mexe: amostras que chegaram com a trava na mao da UI */
+static amostra_adiada_t s_adiadas[AMOSTRAS_ADIADAS];
+static uint32_t s_total_adiadas;
+
+esp_err_t tendencia_inicializar(void)
+{
+    ESP_RETURN_ON_FALSE(s_trava == NULL, ESP_ERR_INVALID_STATE, TAG, "Ja inicializada");
+    registro_tendencia_t *memoria[PIRAMIDE_TENDENCIA_NIVEIS] = {0};
+    size_t bytes = 0;
+    esp_err_t err = ESP_OK;
+    for (uint8_t i = 0; i < PIRAMIDE_TENDENCIA_NIVEIS && err == ESP_OK; i++) {
+        const size_t tamanho = piramide_tendencia_capacidade(i, DURACAO_S) * sizeof(registro_tendencia_t);
+        memoria[i] = heap_caps_malloc(tamanho, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        bytes += tamanho;
+        err = memoria[i] ? ESP_OK : ESP_ERR_NO_MEM;
+    }
+    if (err == ESP_OK) {
+        s_trava = xSemaphoreCreateMutex();
+        err = s_trava ? ESP_OK : ESP_ERR_NO_MEM;
+    }
+    if (err != ESP_OK) {
+        for (uint8_t i = 0; i < PIRAMIDE_TENDENCIA_NIVEIS; i++) {
+            heap_caps_free(memoria[i]);
+        }
+        ESP_LOGE(TAG, "Sem memoria para %u bytes de historico", (unsigned)bytes);
+        return err;
+    }
+    piramide_tendencia_inicializar(&s_piramide, memoria, DURACAO_S);
+    ESP_LOGI(TAG, "Historico de %d h em %u bytes de PSRAM", CONFIG_CONTADOR_TENDENCIA_HORAS, (unsigned)bytes);
+    return ESP_OK;
+}
+
+void tendencia_registrar(const dados_medidos_t *medicao, int64_t agora_ms)
+{
+    if (!s_trava || !medicao) {
+        return;
+    }
+    const amostra_adiada_t amostra = {
+        .agora_ms = agora_ms,
+        .frequencia_q16 = medicao->frequencia_q16,
+        .velocidade_q16 = medicao->velocidade_q16,
+    };
+    if (xSemaphoreTake(s_trava, 0) != pdTRUE) {
+        /* A UI esta lendo: a tarefa de metricas nao espera, guarda para a proxima publicacao */
+        if (s_total_adiadas < AMOSTRAS_ADIADAS) {
+            s_total_adiadas++;
+        }
+        s_adiadas[s_total_adiadas - 1U] = amostra;
+        return;
+    }
+    for (uint32_t i = 0; i < s_total_adiadas; i++) {
+        piramide_tendencia_registrar(&s_piramide, s_adiadas[i].agora_ms, s_adiadas[i].frequencia_q16,
+                                     s_adiadas[i].velocidade_q16);
+    }
+    s_total_adiadas = 0;
+    piramide_tendencia_registrar(&s_piramide, amostra.agora_ms, amostra.frequencia_q16, amostra.velocidade_q16);
+    xSemaphoreGive(s_trava);
+}
+
+size_t tendencia_ler(uint32_t janela_s, uint32_t maximo_pontos, ponto_tendencia_t *destino, uint32_t *periodo_s)
+{
+    if (!s_trava || !destino) {
+        return 0;
+    }
+    xSemaphoreTake(s_trava, portMAX_DELAY);
+    piramide_tendencia_avancar(&s_piramide, esp_timer_get_time() / 1000);
+    const size_t pontos = piramide_tendencia_ler(&s_piramide, janela_s, maximo_pontos, destino, periodo_s);
+    xSemaphoreGive(s_trava);
+    return pontos;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "app_types.h"
+#include "esp_err.h"
+#include "piramide_tendencia.h"
+
+/*
+ * Historico de tendencia do canal principal (ver piramide_tendencia.h) com
+ * os aneis na PSRAM, cobrindo CONFIG_CONTADOR_TENDENCIA_HORAS. A tarefa de
+ * metricas registra cada publicacao; qualquer tarefa le. Um mutex protege a
+ * piramide, mas so o leitor espera por ele: com a trava ocupada o registro
+ * guarda a amostra (com o instante dela) e a entrega na publicacao seguinte.
+ * O registro e O(1) mesmo depois de uma pausa longa; a leitura copia no
+ * maximo `maximo_pontos`.
+ */
+esp_err_t tendencia_inicializar(void);
+/* Tarefa de metricas; sem inicializar nao faz nada */
+void tendencia_registrar(const dados_medidos_t *medicao, int64_t agora_ms);
+/* Fecha os periodos ate agora e le os ultimos `janela_s` segundos */
+size_t tendencia_ler(uint32_t janela_s, uint32_t maximo_pontos, ponto_tendencia_t *destino, uint32_t *periodo_s);
@@ -0,0 +1,51 @@
+/*
+ * Bancada de host para estatisticas_curso: mede ns por borda do caminho
+ * quente (Welford + deques + histograma) com periodos pseudo-aleatorios.
+ *
+ *   cmake -S tools -B build-host && cmake --build build-host
+ *   ./build-host/bancada_estatisticas [bordas]
+ */
+#include "estatisticas_curso.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BORDAS_PADRAO 10000000U
+#define PERIODO_BASE_US 5555U   /* ~180 Hz */
+#define JITTER_US 200U
+
+static uint64_t agora_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+int main(int argc, char **argv)
+{
+    const uint32_t bordas = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : BORDAS_PADRAO;
+    static estatisticas_curso_t estatisticas;
+    estatisticas_curso_inicializar(&estatisticas, 1000000U);
+
+    uint32_t estado = 0x12345678U;
+    int64_t borda_us = 1;
+    const uint64_t inicio_ns = agora_ns();
+    for (uint32_t i = 0; i < bordas; i++) {
+        estado ^= estado << 13;
+        estado ^= estado >> 17;
+        estado ^= estado << 5;
+        borda_us += PERIODO_BASE_US - JITTER_US + (estado % (2U * JITTER_US + 1U));
+        estatisticas_curso_registrar_borda(&estatisticas, borda_us);
+    }
+    const uint64_t total_ns = agora_ns() - inicio_ns;
+
+    resumo_periodos_t resumo;
+    estatisticas_curso_resumir(&estatisticas, &resumo);
+    printf("bordas: %" PRIu32 "\n", bordas);
+    printf("ns/borda: %.2f\n", bordas ? (double)total_ns / bordas : 0.0);
+    printf("media: %" PRIu32 " us  desvio: %" PRIu32 " us  janela: %" PRIu32 "..%" PRIu32 " us\n",
+           resumo.periodo_medio_us, resumo.desvio_padrao_us, resumo.minimo_janela_us, resumo.maximo_janela_us);
+    return 0;
+}
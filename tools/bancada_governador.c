@@ -0,0 +1,326 @@
+/*
+ * Bancada de host para governador_publicacao: despertares de tarefa_metricas
+ * por minuto simulado, comparados com a amostragem fixa de 100 ms que o
+ * governador substituiu. Cada cenario roda um minuto de bordas pelo filtro,
+ * fila, despertador_bordas e nucleo reais, com o mesmo laco da tarefa
+ * (despertar pela ISR limitado ao intervalo rapido, espera pedida ao
+ * governador, prazo da fila em sinais rapidos).
+ *
+ *   cmake -S tools -B build-host && cmake --build build-host
+ *   ./build-host/bancada_governador [minutos_por_cenario] [jitter_us]
+ *
+ * Por cenario sai o total de despertares por minuto (por tempo e por borda),
+ * o pico de ocupacao da fila e as bordas perdidas, para o governador e para
+ * a amostragem fixa.
+ */
+#include "despertador_bordas.h"
+#include "fila_bordas.h"
+#include "filtro_glitch.h"
+#include "governador_publicacao.h"
+#include "nucleo_medicao.h"
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Mesmos parametros de main/metricas.c e dos defaults do Kconfig */
+#define PERIODO_MAXIMO_US        1000000
+#define PERIODOS_MINIMOS_JANELA  4
+#define INTERVALO_AMOSTRAGEM_MS  100       /* laco antigo, antes do governador */
+#define INTERVALO_RAPIDO_MS      33
+#define INTERVALO_BATIMENTO_MS   250
+#define PUBLICACOES_ESTAVEIS     5
+#define LIMIAR_MUDANCA_Q16       (Q16_UM / 4U)
+#define TOLERANCIA_DESPERTAR_SHIFT 5
+#define FILTRO_BLOQUEIO_MIN_US   150
+#define FILTRO_FRACAO_PCT        50
+#define FILTRO_SUAVIZACAO_SHIFT  3
+#define LOTE_BORDAS              64
+#define INICIO_US                1000000
+#define JITTER_PADRAO_US         20.0
+#define SEM_DESPERTAR            INT64_MAX
+
+typedef struct {
+    const char *nome;
+    double (*frequencia_hz)(double t_s);  /* 0 = sem sinal */
+} cenario_t;
+
+typedef struct {
+    uint64_t por_tempo;
+    uint64_t por_borda;
+    uint32_t fila_maxima;
+    uint32_t transbordos;
+} resultado_t;
+
+typedef struct {
+    filtro_glitch_t filtro;
+    fila_bordas_t fila;
+    despertador_bordas_t despertador;
+    nucleo_medicao_t nucleo;
+    governador_publicacao_t governador;
+    int64_t relogio_us;
+    int64_t notificado_us;          /* instante da notificacao pendente da ISR */
+    uint32_t frequencia_publicada_q16;
+    bool sinal_publicado;
+    resultado_t resultado;
+} tarefa_t;
+
+static double parado(double t_s)
+{
+    (void)t_s;
+    return 0.0;
+}
+
+static double estavel_180(double t_s)
+{
+    (void)t_s;
+    return 180.0;
+}
+
+static double estavel_1000(double t_s)
+{
+    (void)t_s;
+    return 1000.0;
+}
+
+static double rampa(double t_s)
+{
+    return 50.0 + 250.0 * fmod(t_s, 60.0) / 60.0;
+}
+
+static double degraus(double t_s)
+{
+    return ((int)(t_s / 10.0) & 1) ? 200.0 : 100.0;
+}
+
+static double intermitente(double t_s)
+{
+    return fmod(t_s, 10.0) < 5.0 ? 150.0 : 0.0;
+}
+
+static int64_t relogio_simulado(void *contexto)
+{
+    return *(const int64_t *)contexto;
+}
+
+static bool notificar(void *contexto)
+{
+    tarefa_t *tarefa = contexto;
+    if (tarefa->notificado_us == SEM_DESPERTAR) {
+        tarefa->notificado_us = tarefa->relogio_us;
+    }
+    return false;
+}
+
+static void inicializar(tarefa_t *tarefa)
+{
+    const filtro_glitch_config_t filtro_config = {
+        .bloqueio_minimo_us = FILTRO_BLOQUEIO_MIN_US,
+        .fracao_q8 = (FILTRO_FRACAO_PCT * 256U) / 100U,
+        .periodo_maximo_us = PERIODO_MAXIMO_US,
+        .suavizacao_shift = FILTRO_SUAVIZACAO_SHIFT,
+    };
+    const nucleo_medicao_config_t nucleo_config = {
+        .sessao = {.tempo_pausa_ms = SESSAO_PAUSA_PADRAO_MS, .tempo_encerrar_ms = SESSAO_ENCERRAR_PADRAO_MS},
+        .periodo_maximo_us = PERIODO_MAXIMO_US,
+        .periodos_minimos = PERIODOS_MINIMOS_JANELA,
+        .relogio = relogio_simulado,
+        .contexto_relogio = &tarefa->relogio_us,
+    };
+    const governador_config_t governador_config = {
+        .intervalo_rapido_ms = INTERVALO_RAPIDO_MS,
+        .intervalo_lento_ms = INTERVALO_BATIMENTO_MS,
+        .publicacoes_estaveis = PUBLICACOES_ESTAVEIS,
+    };
+    filtro_glitch_inicializar(&tarefa->filtro, &filtro_config);
+    fila_bordas_inicializar(&tarefa->fila);
+    nucleo_medicao_inicializar(&tarefa->nucleo, &nucleo_config);
+    nucleo_medicao_definir_curso_um(&tarefa->nucleo, (uint32_t)(CURSO_MAX_CM * 0.7f * UM_POR_CM));
+    governador_publicacao_inicializar(&tarefa->governador, &governador_config);
+    tarefa->despertador.tolerancia_shift = TOLERANCIA_DESPERTAR_SHIFT;
+    tarefa->despertador.despertar = notificar;
+    tarefa->despertador.contexto = tarefa;
+    tarefa->notificado_us = SEM_DESPERTAR;
+}
+
+static uint32_t prazo_fila_ms(uint32_t frequencia_q16)
+{
+    if (frequencia_q16 == 0) {
+        return GOVERNADOR_ESPERA_INFINITA;
+    }
+    const uint64_t prazo_ms = ((uint64_t)(FILA_BORDAS_CAPACIDADE / 2U) * 1000U << 16) / frequencia_q16;
+    return prazo_ms > 0 ? (uint32_t)prazo_ms : 1U;
+}
+
+/* Uma volta de tarefa_metricas; retorna a espera pedida (GOVERNADOR_ESPERA_INFINITA sem prazo) */
+static uint32_t publicar(tarefa_t *tarefa)
+{
+    despertador_bordas_desarmar(&tarefa->despertador);
+    tarefa->notificado_us = SEM_DESPERTAR;
+    const uint32_t ocupacao = atomic_load_explicit(&tarefa->fila.cabeca, memory_order_relaxed) -
+                              atomic_load_explicit(&tarefa->fila.cauda, memory_order_relaxed);
+    if (ocupacao > tarefa->resultado.fila_maxima) {
+        tarefa->resultado.fila_maxima = ocupacao;
+    }
+    int64_t lote[LOTE_BORDAS];
+    size_t quantidade;
+    do {
+        quantidade = fila_bordas_drenar(&tarefa->fila, lote, LOTE_BORDAS);
+        for (size_t i = 0; i < quantidade; i++) {
+            nucleo_medicao_registrar_borda(&tarefa->nucleo, lote[i]);
+        }
+    } while (quantidade == LOTE_BORDAS);
+
+    dados_medidos_t medicao;
+    const bool sinal_ativo = nucleo_medicao_publicar(&tarefa->nucleo, &medicao);
+    const uint32_t variacao_q16 = medicao.frequencia_q16 > tarefa->frequencia_publicada_q16
+                                      ? medicao.frequencia_q16 - tarefa->frequencia_publicada_q16
+                                      : tarefa->frequencia_publicada_q16 - medicao.frequencia_q16;
+    const bool mudou = variacao_q16 > LIMIAR_MUDANCA_Q16 || sinal_ativo != tarefa->sinal_publicado;
+    tarefa->frequencia_publicada_q16 = medicao.frequencia_q16;
+    tarefa->sinal_publicado = sinal_ativo;
+    resumo_sessao_t resumo;
+    nucleo_medicao_retirar_resumo(&tarefa->nucleo, &resumo);
+
+    uint32_t prazo_ms = nucleo_medicao_prazo_ms(&tarefa->nucleo);
+    if (sinal_ativo && prazo_fila_ms(medicao.frequencia_q16) < prazo_ms) {
+        prazo_ms = prazo_fila_ms(medicao.frequencia_q16);
+    }
+    const uint32_t espera_ms = governador_publicacao_avaliar(&tarefa->governador, mudou, sinal_ativo, prazo_ms);
+    const uint32_t periodo_publicado_us =
+        tarefa->frequencia_publicada_q16 ? (uint32_t)((1000000ULL << 16) / tarefa->frequencia_publicada_q16) : 0;
+    despertador_bordas_armar(&tarefa->despertador, periodo_publicado_us);
+    return espera_ms;
+}
+
+/* Proximo despertar: o prazo pedido ou a notificacao da ISR, nunca antes do intervalo rapido */
+static int64_t proximo_despertar(const tarefa_t *tarefa, int64_t prazo_us, int64_t ultima_us, bool *por_borda)
+{
+    *por_borda = false;
+    if (tarefa->notificado_us == SEM_DESPERTAR) {
+        return prazo_us;
+    }
+    int64_t notificado_us = tarefa->notificado_us;
+    if (notificado_us - ultima_us < INTERVALO_RAPIDO_MS * 1000) {
+        notificado_us = ultima_us + INTERVALO_RAPIDO_MS * 1000;
+    }
+    if (notificado_us < prazo_us) {
+        *por_borda = true;
+        return notificado_us;
+    }
+    return prazo_us;
+}
+
+static resultado_t rodar(const cenario_t *cenario, double minutos, double jitter_maximo_us, bool governado)
+{
+    static tarefa_t tarefa;
+    tarefa = (tarefa_t){0};
+    inicializar(&tarefa);
+    const int64_t fim_us = INICIO_US + (int64_t)(minutos * 60e6);
+    const int64_t passo_fixo_us = INTERVALO_AMOSTRAGEM_MS * 1000;
+
+    uint32_t estado = 0x2545F491U;
+    double fase = 0.0;               /* em ciclos; uma borda a cada ciclo inteiro */
+    const double passo_s = 1e-5;
+    /* Como a tarefa: governada comeca sem prazo e com o despertador armado sem referencia */
+    int64_t prazo_us = governado ? SEM_DESPERTAR : INICIO_US;
+    if (governado) {
+        despertador_bordas_armar(&tarefa.despertador, 0);
+    }
+    int64_t ultima_us = INICIO_US - INTERVALO_RAPIDO_MS * 1000;
+
+    for (int64_t t_us = INICIO_US; t_us < fim_us; t_us += (int64_t)(passo_s * 1e6)) {
+        /* Integra a frequencia: a proxima borda sai quando a fase cruza um inteiro */
+        const double t_s = (double)(t_us - INICIO_US) / 1e6;
+        const double frequencia_hz = cenario->frequencia_hz(t_s);
+        const double fase_anterior = fase;
+        fase += frequencia_hz * passo_s;
+        if (frequencia_hz > 0.0 && floor(fase) > floor(fase_anterior)) {
+            estado ^= estado << 13;
+            estado ^= estado >> 17;
+            estado ^= estado << 5;
+            const double fracao = (fase - floor(fase)) / (frequencia_hz * passo_s);
+            const double jitter_us = jitter_maximo_us * ((double)(estado % 2001U) / 1000.0 - 1.0);
+            const int64_t borda_us = t_us - (int64_t)(fracao * passo_s * 1e6) + (int64_t)jitter_us;
+
+            bool por_borda;
+            for (int64_t despertar_us = proximo_despertar(&tarefa, prazo_us, ultima_us, &por_borda);
+                 governado && despertar_us <= borda_us;
+                 despertar_us = proximo_despertar(&tarefa, prazo_us, ultima_us, &por_borda)) {
+                tarefa.relogio_us = despertar_us;
+                const uint32_t espera_ms = publicar(&tarefa);
+                prazo_us = espera_ms == GOVERNADOR_ESPERA_INFINITA ? SEM_DESPERTAR
+                                                                    : despertar_us + (int64_t)espera_ms * 1000;
+                ultima_us = despertar_us;
+                *(por_borda ? &tarefa.resultado.por_borda : &tarefa.resultado.por_tempo) += 1;
+            }
+            for (; !governado && prazo_us <= borda_us; prazo_us += passo_fixo_us) {
+                tarefa.relogio_us = prazo_us;
+                publicar(&tarefa);
+                tarefa.resultado.por_tempo++;
+            }
+
+            /* Lado da ISR */
+            tarefa.relogio_us = borda_us;
+            if (filtro_glitch_aceitar(&tarefa.filtro, borda_us)) {
+                fila_bordas_inserir(&tarefa.fila, borda_us);
+                if (governado) {
+                    despertador_bordas_avaliar(&tarefa.despertador, tarefa.filtro.periodo_estimado_us);
+                }
+            }
+        }
+    }
+    /* Resto do tempo sem bordas */
+    bool por_borda;
+    for (int64_t despertar_us = proximo_despertar(&tarefa, prazo_us, ultima_us, &por_borda);
+         governado && despertar_us < fim_us; despertar_us = proximo_despertar(&tarefa, prazo_us, ultima_us, &por_borda)) {
+        tarefa.relogio_us = despertar_us;
+        const uint32_t espera_ms = publicar(&tarefa);
+        prazo_us = espera_ms == GOVERNADOR_ESPERA_INFINITA ? SEM_DESPERTAR : despertar_us + (int64_t)espera_ms * 1000;
+        ultima_us = despertar_us;
+        *(por_borda ? &tarefa.resultado.por_borda : &tarefa.resultado.por_tempo) += 1;
+    }
+    for (; !governado && prazo_us < fim_us; prazo_us += passo_fixo_us) {
+        tarefa.relogio_us = prazo_us;
+        publicar(&tarefa);
+        tarefa.resultado.por_tempo++;
+    }
+    tarefa.resultado.transbordos = fila_bordas_transbordos(&tarefa.fila);
+    return tarefa.resultado;
+}
+
+int main(int argc, char **argv)
+{
+    const double minutos = argc > 1 ? atof(argv[1]) : 1.0;
+    const double jitter_us = argc > 2 ? atof(argv[2]) : JITTER_PADRAO_US;
+    if (minutos <= 0.0 || jitter_us < 0.0) {
+        fprintf(stderr, "uso: %s [minutos_por_cenario] [jitter_us]\n", argv[0]);
+        return 2;
+    }
+    static const cenario_t cenarios[] = {
+        {"parado", parado},
+        {"estavel 180 Hz", estavel_180},
+        {"estavel 1000 Hz", estavel_1000},
+        {"rampa 50 -> 300 Hz/min", rampa},
+        {"degraus 100/200 Hz 10 s", degraus},
+        {"5 s liga / 5 s para", intermitente},
+    };
+
+    printf("jitter: +-%.0f us por borda\n", jitter_us);
+    printf("%-26s %28s   %22s\n", "", "governador", "fixo 100 ms");
+    printf("%-26s %8s %8s %8s %4s   %8s %8s %4s\n", "cenario", "desp/min", "tempo", "borda", "fila", "desp/min",
+           "fila", "perd");
+    for (size_t i = 0; i < sizeof(cenarios) / sizeof(cenarios[0]); i++) {
+        const resultado_t governado = rodar(&cenarios[i], minutos, jitter_us, true);
+        const resultado_t fixo = rodar(&cenarios[i], minutos, jitter_us, false);
+        printf("%-26s %8.1f %8.1f %8.1f %4" PRIu32 "   %8.1f %8" PRIu32 " %4" PRIu32 "\n", cenarios[i].nome,
+               (governado.por_tempo + governado.por_borda) / minutos, governado.por_tempo / minutos,
+               governado.por_borda / minutos, governado.fila_maxima, fixo.por_tempo / minutos, fixo.fila_maxima,
+               fixo.transbordos);
+        if (governado.transbordos) {
+            printf("  governador perdeu %" PRIu32 " bordas na fila\n", governado.transbordos);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,218 @@
+/*
+ * Bancada de host para piramide_tendencia: um dia de publicacoes simuladas
+ * (com uma pausa no meio), ns por amostra inserida, custo de leitura por
+ * janela, custo da primeira amostra depois de uma pausa longa e conferencia
+ * dos niveis contra as amostras brutas ponderadas pelo tempo.
+ *
+ *   cmake -S tools -B build-host && cmake --build build-host
+ *   ./build-host/bancada_tendencia [horas] [publicacoes_por_s]
+ */
+#include "piramide_tendencia.h"
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define HORAS_PADRAO          12U
+#define TAXA_PADRAO           30U
+#define MAXIMO_PONTOS         240U
+#define REPETICOES_LEITURA    2000U
+#define PAUSA_INICIO_FRACAO   0.5
+#define PAUSA_S               (30U * 60U)
+#define PAUSA_LONGA_H         6
+#define SEGUNDOS_MAXIMOS      60U   /* maior periodo conferido */
+
+typedef struct {
+    int64_t ms;
+    uint32_t frequencia_q16;
+    uint32_t velocidade_q16;
+} amostra_t;
+
+static uint64_t agora_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t proximo_aleatorio(uint32_t *estado)
+{
+    *estado ^= *estado << 13;
+    *estado ^= *estado >> 17;
+    *estado ^= *estado << 5;
+    return *estado;
+}
+
+/*
+ * Minimo/maximo/media brutos de [inicio_s, fim_s), como a piramide: cada
+ * amostra vale ate a seguinte (no maximo PIRAMIDE_TENDENCIA_RETENCAO_MS),
+ * a media de um segundo e ponderada por esse tempo e a de periodos maiores e
+ * a media dos segundos que tiveram amostra.
+ */
+static bool conferir(const amostra_t *amostras, size_t total, int64_t inicio_s, int64_t fim_s, int64_t fim_ms,
+                     const ponto_tendencia_t *ponto)
+{
+    double soma_segundo[SEGUNDOS_MAXIMOS] = {0};
+    int64_t peso_segundo[SEGUNDOS_MAXIMOS] = {0};
+    uint32_t minimo = UINT32_MAX;
+    uint32_t maximo = 0;
+    for (size_t i = 0; i < total; i++) {
+        int64_t ate_ms = amostras[i].ms + PIRAMIDE_TENDENCIA_RETENCAO_MS;
+        const int64_t seguinte_ms = i + 1U < total ? amostras[i + 1U].ms : fim_ms;
+        ate_ms = seguinte_ms < ate_ms ? seguinte_ms : ate_ms;
+        for (int64_t desde_ms = amostras[i].ms; desde_ms < ate_ms;) {
+            const int64_t segundo = desde_ms / 1000;
+            const int64_t limite_ms = (segundo + 1) * 1000 < ate_ms ? (segundo + 1) * 1000 : ate_ms;
+            if (segundo >= inicio_s && segundo < fim_s) {
+                soma_segundo[segundo - inicio_s] += (double)amostras[i].frequencia_q16 * (double)(limite_ms - desde_ms);
+                peso_segundo[segundo - inicio_s] += limite_ms - desde_ms;
+                minimo = amostras[i].frequencia_q16 < minimo ? amostras[i].frequencia_q16 : minimo;
+                maximo = amostras[i].frequencia_q16 > maximo ? amostras[i].frequencia_q16 : maximo;
+            }
+            desde_ms = limite_ms;
+        }
+    }
+    double soma_medias = 0.0;
+    uint32_t segundos = 0;
+    for (int64_t s = 0; s < fim_s - inicio_s; s++) {
+        if (peso_segundo[s] > 0) {
+            soma_medias += soma_segundo[s] / (double)peso_segundo[s];
+            segundos++;
+        }
+    }
+    if (segundos == 0) {
+        return ponto_tendencia_lacuna(ponto);
+    }
+    const double media = soma_medias / segundos;
+    /* Medias inteiras por nivel: ate uma unidade Q16 truncada em cada um */
+    return ponto->frequencia.minimo_q16 == minimo && ponto->frequencia.maximo_q16 == maximo &&
+           fabs(ponto->frequencia.media_q16 - media) <= (double)PIRAMIDE_TENDENCIA_NIVEIS;
+}
+
+int main(int argc, char **argv)
+{
+    const uint32_t horas = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : HORAS_PADRAO;
+    const uint32_t taxa = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 10) : TAXA_PADRAO;
+    if (horas == 0 || taxa == 0 || taxa > 1000) {
+        fprintf(stderr, "uso: %s [horas] [publicacoes_por_s (1..1000)]\n", argv[0]);
+        return 1;
+    }
+    const uint32_t duracao_s = horas * 3600U;
+
+    registro_tendencia_t *memoria[PIRAMIDE_TENDENCIA_NIVEIS];
+    size_t bytes = 0;
+    for (uint8_t i = 0; i < PIRAMIDE_TENDENCIA_NIVEIS; i++) {
+        const uint32_t capacidade = piramide_tendencia_capacidade(i, duracao_s);
+        memoria[i] = calloc(capacidade, sizeof(registro_tendencia_t));
+        bytes += capacidade * sizeof(registro_tendencia_t);
+        if (!memoria[i]) {
+            fprintf(stderr, "sem memoria\n");
+            return 1;
+        }
+    }
+    static piramide_tendencia_t piramide;
+    piramide_tendencia_inicializar(&piramide, memoria, duracao_s);
+
+    /* Publicacoes com jitter; sinal parado por PAUSA_S no meio do dia */
+    const size_t maximo_amostras = (size_t)duracao_s * taxa;
+    amostra_t *amostras = malloc(maximo_amostras * sizeof(*amostras));
+    if (!amostras) {
+        fprintf(stderr, "sem memoria\n");
+        return 1;
+    }
+    const int64_t pausa_inicio_ms = (int64_t)(duracao_s * PAUSA_INICIO_FRACAO) * 1000;
+    const int64_t pausa_fim_ms = pausa_inicio_ms + (int64_t)PAUSA_S * 1000;
+    uint32_t estado = 0x2468ACE1U;
+    size_t total = 0;
+    const int64_t passo_ms = 1000 / taxa;
+    for (int64_t ms = 0; ms < (int64_t)duracao_s * 1000 && total < maximo_amostras; ms += passo_ms) {
+        const int64_t instante_ms = ms + (int64_t)(proximo_aleatorio(&estado) % (uint32_t)(passo_ms / 2 + 1));
+        if (instante_ms >= pausa_inicio_ms && instante_ms < pausa_fim_ms) {
+            continue;
+        }
+        const double hz = 180.0 + 60.0 * sin((double)ms / 600000.0) + (proximo_aleatorio(&estado) % 100U) / 50.0;
+        amostras[total++] = (amostra_t){
+            .ms = instante_ms,
+            .frequencia_q16 = (uint32_t)(hz * 65536.0),
+            .velocidade_q16 = (uint32_t)(hz * 0.7 * 65536.0),
+        };
+    }
+
+    const uint64_t inicio_ns = agora_ns();
+    for (size_t i = 0; i < total; i++) {
+        piramide_tendencia_registrar(&piramide, amostras[i].ms, amostras[i].frequencia_q16, amostras[i].velocidade_q16);
+    }
+    const uint64_t insercao_ns = agora_ns() - inicio_ns;
+    const int64_t fim_ms = (int64_t)duracao_s * 1000;
+    piramide_tendencia_avancar(&piramide, fim_ms);
+
+    printf("historico: %" PRIu32 " h, %zu bytes nos aneis\n", horas, bytes);
+    printf("amostras: %zu  ns/amostra: %.1f\n", total, total ? (double)insercao_ns / total : 0.0);
+
+    static const uint32_t janelas_s[] = {60U, 600U, 3600U, 4U * 3600U, 0U};
+    static ponto_tendencia_t destino[MAXIMO_PONTOS];
+    for (size_t j = 0; j < sizeof(janelas_s) / sizeof(janelas_s[0]); j++) {
+        const uint32_t janela_s = janelas_s[j] ? janelas_s[j] : duracao_s;
+        uint32_t periodo_s = 0;
+        size_t pontos = 0;
+        const uint64_t leitura_inicio_ns = agora_ns();
+        for (uint32_t r = 0; r < REPETICOES_LEITURA; r++) {
+            pontos = piramide_tendencia_ler(&piramide, janela_s, MAXIMO_PONTOS, destino, &periodo_s);
+        }
+        const uint64_t leitura_ns = (agora_ns() - leitura_inicio_ns) / REPETICOES_LEITURA;
+        uint32_t lacunas = 0;
+        for (size_t i = 0; i < pontos; i++) {
+            lacunas += ponto_tendencia_lacuna(&destino[i]) ? 1U : 0U;
+        }
+        printf("janela %6" PRIu32 " s: %3zu pontos de %4" PRIu32 " s, %3" PRIu32 " lacunas, %6" PRIu64 " ns/leitura\n",
+               janela_s, pontos, periodo_s, lacunas, leitura_ns);
+    }
+
+    /* Conferencia: ultimos 3 periodos de cada nivel contra as amostras brutas */
+    uint32_t divergencias = 0;
+    for (uint8_t n = 0; n < PIRAMIDE_TENDENCIA_NIVEIS; n++) {
+        const uint32_t periodo_s = piramide_tendencia_periodo_s(n);
+        uint32_t lido_s = 0;
+        const size_t pontos = piramide_tendencia_ler(&piramide, periodo_s * 3U, 3U, destino, &lido_s);
+        const int64_t fim_s = fim_ms / 1000;
+        for (size_t i = 0; i < pontos; i++) {
+            const int64_t inicio_s = fim_s - (int64_t)(pontos - i) * periodo_s;
+            if (!conferir(amostras, total, inicio_s, inicio_s + periodo_s, fim_ms, &destino[i])) {
+                divergencias++;
+            }
+        }
+    }
+    /* A pausa aparece como lacunas no dia inteiro em minutos */
+    const uint32_t minutos = piramide_tendencia_capacidade(PIRAMIDE_TENDENCIA_NIVEIS - 1U, duracao_s);
+    ponto_tendencia_t *dia = malloc(minutos * sizeof(*dia));
+    uint32_t lido_s = 0;
+    const size_t pontos_dia = dia ? piramide_tendencia_ler(&piramide, duracao_s, minutos, dia, &lido_s) : 0;
+    uint32_t lacunas_dia = 0;
+    for (size_t i = 0; i < pontos_dia; i++) {
+        lacunas_dia += ponto_tendencia_lacuna(&dia[i]) ? 1U : 0U;
+    }
+    free(dia);
+    /* Minutos cortados pela borda da pausa ainda tem amostras */
+    if (lacunas_dia + 1U < PAUSA_S / 60U || lacunas_dia > PAUSA_S / 60U) {
+        divergencias++;
+    }
+    printf("dia em minutos: %zu pontos, %" PRIu32 " lacunas (pausa de %u min)\n", pontos_dia, lacunas_dia,
+           PAUSA_S / 60U);
+    printf("conferencia: %s (%" PRIu32 " divergencias)\n", divergencias ? "FALHOU" : "ok", divergencias);
+
+    /* Lacunas nao ocupam o anel: a amostra depois de horas parado custa o mesmo que as outras */
+    const int64_t volta_ms = fim_ms + (int64_t)PAUSA_LONGA_H * 3600 * 1000;
+    const uint64_t pausa_inicio_ns = agora_ns();
+    piramide_tendencia_registrar(&piramide, volta_ms, amostras[total - 1U].frequencia_q16,
+                                 amostras[total - 1U].velocidade_q16);
+    piramide_tendencia_avancar(&piramide, volta_ms + 1000);
+    printf("primeira amostra depois de %d h parado: %" PRIu64 " ns\n", PAUSA_LONGA_H, agora_ns() - pausa_inicio_ns);
+
+    free(amostras);
+    for (uint8_t i = 0; i < PIRAMIDE_TENDENCIA_NIVEIS; i++) {
+        free(memoria[i]);
+    }
+    return divergencias ? 2 : 0;
+}
@@ -0,0 +1,157 @@
+/*
+ * Decodificador de host da particao "gravador" (ver main/codec_gravador.h).
+ *
+ *   parttool.py read_partition --partition-name gravador --output gravador.bin
+ *   cmake -S tools -B build-host && cmake --build build-host
+ *   ./build-host/decodificador_gravador gravador.bin      # periodos em us, um por linha, do mais antigo ao mais recente
+ *   ./build-host/decodificador_gravador -r gravador.bin   # so o resumo por bloco
+ *   ./build-host/decodificador_gravador --bancada [blocos] # vazao do decodificador com blocos sinteticos
+ */
+#include "codec_gravador.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define PERIODOS_POR_BLOCO_MAX  CODEC_GRAVADOR_DADOS_BYTES
+#define BLOCOS_BANCADA_PADRAO   20000U
+
+typedef struct {
+    uint32_t sequencia;
+    uint32_t setor;
+} bloco_valido_t;
+
+static uint64_t agora_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int comparar_sequencia(const void *a, const void *b)
+{
+    const int32_t diferenca = (int32_t)(((const bloco_valido_t *)a)->sequencia - ((const bloco_valido_t *)b)->sequencia);
+    return (diferenca > 0) - (diferenca < 0);
+}
+
+static int decodificar_imagem(const char *caminho, int so_resumo)
+{
+    FILE *arquivo = fopen(caminho, "rb");
+    if (!arquivo) {
+        perror(caminho);
+        return 1;
+    }
+    fseek(arquivo, 0, SEEK_END);
+    const long tamanho = ftell(arquivo);
+    fseek(arquivo, 0, SEEK_SET);
+    const uint32_t setores = (uint32_t)(tamanho / CODEC_GRAVADOR_BLOCO_BYTES);
+    uint8_t *imagem = malloc((size_t)setores * CODEC_GRAVADOR_BLOCO_BYTES);
+    bloco_valido_t *validos = malloc(sizeof(*validos) * (setores ? setores : 1U));
+    if (!imagem || !validos || fread(imagem, CODEC_GRAVADOR_BLOCO_BYTES, setores, arquivo) != setores) {
+        fprintf(stderr, "falha ao ler %s\n", caminho);
+        fclose(arquivo);
+        free(imagem);
+        free(validos);
+        return 1;
+    }
+    fclose(arquivo);
+
+    uint32_t total_validos = 0;
+    uint32_t corrompidos = 0;
+    for (uint32_t setor = 0; setor < setores; setor++) {
+        const uint8_t *bloco = imagem + (size_t)setor * CODEC_GRAVADOR_BLOCO_BYTES;
+        codec_gravador_cabecalho_t cabecalho;
+        if (codec_gravador_validar(bloco, &cabecalho)) {
+            validos[total_validos++] = (bloco_valido_t){ .sequencia = cabecalho.sequencia, .setor = setor };
+        } else if (memcmp(bloco, "\xFF\xFF\xFF\xFF", 4) != 0) {
+            corrompidos++;
+        }
+    }
+    qsort(validos, total_validos, sizeof(*validos), comparar_sequencia);
+
+    static uint32_t periodos[PERIODOS_POR_BLOCO_MAX];
+    uint64_t total_periodos = 0;
+    for (uint32_t i = 0; i < total_validos; i++) {
+        const uint8_t *bloco = imagem + (size_t)validos[i].setor * CODEC_GRAVADOR_BLOCO_BYTES;
+        const int quantidade = codec_gravador_decodificar(bloco, periodos, PERIODOS_POR_BLOCO_MAX);
+        if (so_resumo) {
+            printf("seq %" PRIu32 " setor %" PRIu32 ": %d periodos\n", validos[i].sequencia, validos[i].setor,
+                   quantidade);
+        } else {
+            for (int j = 0; j < quantidade; j++) {
+                printf("%" PRIu32 "\n", periodos[j]);
+            }
+        }
+        total_periodos += (uint64_t)quantidade;
+    }
+    fprintf(stderr, "%" PRIu32 " setores, %" PRIu32 " blocos validos, %" PRIu32 " corrompidos, %" PRIu64 " periodos\n",
+            setores, total_validos, corrompidos, total_periodos);
+    free(imagem);
+    free(validos);
+    return 0;
+}
+
+static int bancada(uint32_t blocos)
+{
+    uint8_t *imagem = malloc((size_t)blocos * CODEC_GRAVADOR_BLOCO_BYTES);
+    if (!imagem) {
+        return 1;
+    }
+    static codec_gravador_t codec;
+    uint32_t estado = 0x2545F491U;
+    uint64_t periodos_gerados = 0;
+    const uint64_t inicio_codificar = agora_ns();
+    for (uint32_t b = 0; b < blocos; b++) {
+        codec_gravador_iniciar_bloco(&codec);
+        while (true) {
+            estado ^= estado << 13;
+            estado ^= estado >> 17;
+            estado ^= estado << 5;
+            /* ~180 Hz com +/-200 us de jitter */
+            if (!codec_gravador_adicionar(&codec, 5355U + (estado % 401U))) {
+                break;
+            }
+            periodos_gerados++;
+        }
+        memcpy(imagem + (size_t)b * CODEC_GRAVADOR_BLOCO_BYTES, codec_gravador_fechar_bloco(&codec, b),
+               CODEC_GRAVADOR_BLOCO_BYTES);
+    }
+    const uint64_t ns_codificar = agora_ns() - inicio_codificar;
+
+    static uint32_t periodos[PERIODOS_POR_BLOCO_MAX];
+    uint64_t periodos_lidos = 0;
+    const uint64_t inicio_decodificar = agora_ns();
+    for (uint32_t b = 0; b < blocos; b++) {
+        const int quantidade = codec_gravador_decodificar(imagem + (size_t)b * CODEC_GRAVADOR_BLOCO_BYTES, periodos,
+                                                          PERIODOS_POR_BLOCO_MAX);
+        periodos_lidos += quantidade > 0 ? (uint64_t)quantidade : 0U;
+    }
+    const uint64_t ns_decodificar = agora_ns() - inicio_decodificar;
+    free(imagem);
+
+    const double mb = (double)blocos * CODEC_GRAVADOR_BLOCO_BYTES / 1e6;
+    printf("blocos: %" PRIu32 "  periodos: %" PRIu64 " (%.1f por bloco, %.2f bytes/periodo)\n", blocos,
+           periodos_gerados, (double)periodos_gerados / blocos, (double)blocos * CODEC_GRAVADOR_DADOS_BYTES / periodos_gerados);
+    printf("codificar:   %.1f MB/s  %.1f Mperiodos/s\n", mb / (ns_codificar / 1e9),
+           periodos_gerados / (ns_codificar / 1e3));
+    printf("decodificar: %.1f MB/s  %.1f Mperiodos/s\n", mb / (ns_decodificar / 1e9),
+           periodos_lidos / (ns_decodificar / 1e3));
+    return periodos_lidos == periodos_gerados ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc >= 2 && strcmp(argv[1], "--bancada") == 0) {
+        return bancada(argc >= 3 ? (uint32_t)strtoul(argv[2], NULL, 10) : BLOCOS_BANCADA_PADRAO);
+    }
+    if (argc == 3 && strcmp(argv[1], "-r") == 0) {
+        return decodificar_imagem(argv[2], 1);
+    }
+    if (argc == 2) {
+        return decodificar_imagem(argv[1], 0);
+    }
+    fprintf(stderr, "uso: %s [-r] imagem.bin | --bancada [blocos]\n", argv[0]);
+    return 2;
+}
@@ -0,0 +1,97 @@
+/*
+ * Decodifica o fluxo de telemetria (COBS + CRC-32, ver main/codec_telemetria.h)
+ * lido de um arquivo, de stdin ("-") ou de uma porta serial ja configurada.
+ *
+ *   stty -F /dev/ttyUSB0 921600 raw && ./build-host/decodificador_telemetria /dev/ttyUSB0
+ *   ./build-host/decodificador_telemetria --resumo captura.bin
+ *
+ * Saida: "b <canal> <borda_us>" por borda e "m <canal> ..." por medicao; o
+ * resumo (quadros, pacotes perdidos pela sequencia, descartes do firmware)
+ * vai para stderr ao fim do fluxo.
+ */
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "codec_telemetria.h"
+
+typedef struct {
+    bool resumo;
+    bool tem_sequencia;
+    uint16_t proxima_sequencia;
+    uint64_t pacotes_perdidos;
+    uint64_t bordas;
+    uint64_t medicoes;
+    uint32_t bordas_descartadas;
+} estado_t;
+
+static void ao_receber(const telemetria_pacote_t *pacote, void *contexto)
+{
+    estado_t *estado = contexto;
+    if (estado->tem_sequencia && pacote->sequencia != estado->proxima_sequencia) {
+        estado->pacotes_perdidos += (uint16_t)(pacote->sequencia - estado->proxima_sequencia);
+    }
+    estado->tem_sequencia = true;
+    estado->proxima_sequencia = (uint16_t)(pacote->sequencia + 1U);
+
+    if (pacote->tipo == TELEMETRIA_BORDAS) {
+        estado->bordas += pacote->bordas.quantidade;
+        if (!estado->resumo) {
+            for (uint32_t i = 0; i < pacote->bordas.quantidade; i++) {
+                printf("b %u %" PRId64 "\n", pacote->canal, pacote->bordas.bordas_us[i]);
+            }
+        }
+        return;
+    }
+    const telemetria_medicao_t *medicao = &pacote->medicao;
+    estado->medicoes++;
+    estado->bordas_descartadas = medicao->bordas_descartadas;
+    if (!estado->resumo) {
+        printf("m %u v=%" PRIu32 " hz=%.4f rpm=%.2f furos=%" PRIu32 " distancia_um=%" PRIu64 " descartadas=%" PRIu32
+               "\n",
+               pacote->canal, medicao->versao, q16_para_float(medicao->dados.frequencia_q16),
+               q16_para_float(medicao->dados.rpm_q16), medicao->dados.furos, medicao->dados.distancia_um,
+               medicao->bordas_descartadas);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    estado_t estado = {0};
+    int arg = 1;
+    if (argc > arg && strcmp(argv[arg], "--resumo") == 0) {
+        estado.resumo = true;
+        arg++;
+    }
+    if (argc != arg + 1) {
+        fprintf(stderr, "uso: %s [--resumo] <arquivo|porta|->\n", argv[0]);
+        return 2;
+    }
+    FILE *entrada = strcmp(argv[arg], "-") == 0 ? stdin : fopen(argv[arg], "rb");
+    if (!entrada) {
+        perror(argv[arg]);
+        return 1;
+    }
+
+    static codec_telemetria_leitor_t leitor;
+    codec_telemetria_leitor_inicializar(&leitor);
+    uint8_t bytes[4096];
+    uint64_t total_bytes = 0;
+    size_t lidos;
+    while ((lidos = fread(bytes, 1, sizeof(bytes), entrada)) > 0) {
+        total_bytes += lidos;
+        codec_telemetria_leitor_alimentar(&leitor, bytes, lidos, ao_receber, &estado);
+    }
+    if (entrada != stdin) {
+        fclose(entrada);
+    }
+
+    fprintf(stderr,
+            "%" PRIu64 " bytes, %" PRIu32 " quadros validos, %" PRIu32 " invalidos, %" PRIu64
+            " pacotes perdidos no enlace\n",
+            total_bytes, leitor.quadros_validos, leitor.quadros_invalidos, estado.pacotes_perdidos);
+    fprintf(stderr, "%" PRIu64 " bordas, %" PRIu64 " medicoes, %" PRIu32 " bordas descartadas no firmware\n",
+            estado.bordas, estado.medicoes, estado.bordas_descartadas);
+    return 0;
+}
@@ -0,0 +1,372 @@
+/*
+ * Bancada da telemetria sem hardware: um pty faz o papel da UART. Uma thread
+ * imita a tarefa de metricas (lotes de bordas sinteticas a cada 33 ms,
+ * entregues sem bloquear num buffer limitado do mesmo tamanho do firmware),
+ * outra imita a tarefa de telemetria (monta os quadros e escreve no lado
+ * mestre no ritmo do baud rate, com o anel de TX do driver) e a terceira le o
+ * lado escravo com o mesmo receptor do decodificador.
+ *
+ *   ./build-host/emulador_telemetria [--canais N] <hz> <segundos> [baud]
+ *
+ * Os canais seguem as frequencias da fonte simulada (x1, x1.25, x1.5, x1.75).
+ * No fim compara o que foi gerado, descartado no buffer e recebido, e confere
+ * cada borda recebida contra a grade de tempo do seu canal.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "codec_telemetria.h"
+
+#define MAX_CANAIS            4
+#define INTERVALO_LOTES_US    33000     /* INTERVALO_RAPIDO_MS das metricas */
+#define INTERVALO_MEDICAO_US  100000    /* CONFIG_CONTADOR_TELEMETRIA_INTERVALO_MS */
+#define BUFFER_LOTES_BYTES    16384     /* main/telemetria.c */
+#define BUFFER_TX_BYTES       8192
+#define CABECALHO_MENSAGEM    (sizeof(uint32_t) + sizeof(uint32_t))   /* tamanho + canal */
+#define FILA_LOTES            1024
+
+typedef struct {
+    uint8_t canal;
+    uint32_t quantidade;
+    int64_t bordas_us[CODEC_TELEMETRIA_BORDAS_MAX];
+} lote_t;
+
+typedef struct {
+    /* Buffer limitado entre "metricas" e "telemetria" */
+    pthread_mutex_t trava;
+    pthread_cond_t tem_lote;
+    lote_t lotes[FILA_LOTES];
+    size_t cabeca;
+    size_t cauda;
+    size_t bytes_usados;
+    bool fim_producao;
+    /* "Barramento": ultima medicao por canal */
+    telemetria_medicao_t medicoes[MAX_CANAIS];
+
+    uint8_t canais;
+    uint32_t periodo_us[MAX_CANAIS];
+    int64_t inicio_us;
+    int64_t duracao_us;
+    uint32_t baud;
+    int mestre;
+    int escravo;
+
+    uint64_t bordas_geradas[MAX_CANAIS];
+    uint64_t bordas_descartadas;
+    uint64_t pacotes_enviados;
+    uint64_t bytes_enviados;
+    uint64_t ns_codificando;
+    uint64_t bordas_codificadas;
+
+    /* Receptor */
+    codec_telemetria_leitor_t leitor;
+    bool tem_sequencia;
+    uint16_t proxima_sequencia;
+    uint64_t pacotes_perdidos;
+    uint64_t bordas_recebidas[MAX_CANAIS];
+    uint64_t bordas_fora_da_grade;
+    int64_t ultima_recebida_us[MAX_CANAIS];
+    uint64_t medicoes_recebidas;
+} bancada_t;
+
+static bancada_t s_bancada;
+
+static int64_t agora_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void dormir_ate(int64_t instante_us)
+{
+    const int64_t falta_us = instante_us - agora_us();
+    if (falta_us > 0) {
+        const struct timespec ts = {falta_us / 1000000, (falta_us % 1000000) * 1000};
+        nanosleep(&ts, NULL);
+    }
+}
+
+/* Mesmo contrato de telemetria_registrar_bordas(): lote inteiro ou descarte contado */
+static void registrar_lote(bancada_t *b, uint8_t canal, const int64_t *bordas_us, size_t quantidade)
+{
+    const size_t bytes = CABECALHO_MENSAGEM + quantidade * sizeof(int64_t);
+    pthread_mutex_lock(&b->trava);
+    if (b->bytes_usados + bytes > BUFFER_LOTES_BYTES || b->cabeca - b->cauda == FILA_LOTES) {
+        b->bordas_descartadas += quantidade;
+    } else {
+        lote_t *lote = &b->lotes[b->cabeca++ % FILA_LOTES];
+        lote->canal = canal;
+        lote->quantidade = (uint32_t)quantidade;
+        memcpy(lote->bordas_us, bordas_us, quantidade * sizeof(int64_t));
+        b->bytes_usados += bytes;
+        pthread_cond_signal(&b->tem_lote);
+    }
+    pthread_mutex_unlock(&b->trava);
+}
+
+/* Imita tarefa_metricas: a cada publicacao drena as bordas novas de cada canal em lotes de 64 */
+static void *thread_metricas(void *arg)
+{
+    bancada_t *b = arg;
+    int64_t proxima_borda_us[MAX_CANAIS];
+    for (uint8_t c = 0; c < b->canais; c++) {
+        proxima_borda_us[c] = b->inicio_us + c * 137;
+    }
+    uint32_t versao = 0;
+    for (int64_t tick_us = b->inicio_us + INTERVALO_LOTES_US; tick_us <= b->inicio_us + b->duracao_us;
+         tick_us += INTERVALO_LOTES_US) {
+        dormir_ate(tick_us);
+        versao++;
+        for (uint8_t c = 0; c < b->canais; c++) {
+            int64_t lote[CODEC_TELEMETRIA_BORDAS_MAX];
+            size_t quantidade = 0;
+            while (proxima_borda_us[c] <= tick_us) {
+                lote[quantidade++] = proxima_borda_us[c];
+                proxima_borda_us[c] += b->periodo_us[c];
+                b->bordas_geradas[c]++;
+                if (quantidade == CODEC_TELEMETRIA_BORDAS_MAX) {
+                    registrar_lote(b, c, lote, quantidade);
+                    quantidade = 0;
+                }
+            }
+            if (quantidade > 0) {
+                registrar_lote(b, c, lote, quantidade);
+            }
+            pthread_mutex_lock(&b->trava);
+            telemetria_medicao_t *medicao = &b->medicoes[c];
+            medicao->versao = versao;
+            medicao->dados.frequencia_q16 = (uint32_t)(((uint64_t)1000000U << 16) / b->periodo_us[c]);
+            medicao->dados.furos = (uint32_t)b->bordas_geradas[c];
+            medicao->dados.tempo_sinal_ms = (uint64_t)(tick_us - b->inicio_us) / 1000U;
+            medicao->bordas_descartadas = (uint32_t)b->bordas_descartadas;
+            pthread_mutex_unlock(&b->trava);
+        }
+    }
+    pthread_mutex_lock(&b->trava);
+    b->fim_producao = true;
+    pthread_cond_signal(&b->tem_lote);
+    pthread_mutex_unlock(&b->trava);
+    return NULL;
+}
+
+/* Anel de TX do driver: a escrita so espera quando o enlace ficou BUFFER_TX_BYTES para tras */
+static void transmitir(bancada_t *b, const uint8_t *quadro, size_t tamanho)
+{
+    const int64_t enviado_us = (int64_t)((b->bytes_enviados + tamanho) * 10U * 1000000U / b->baud);
+    const int64_t folga_us = (int64_t)((uint64_t)BUFFER_TX_BYTES * 10U * 1000000U / b->baud);
+    dormir_ate(b->inicio_us + enviado_us - folga_us);
+    size_t escrito = 0;
+    while (escrito < tamanho) {
+        const ssize_t n = write(b->mestre, quadro + escrito, tamanho - escrito);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("write");
+            return;
+        }
+        escrito += (size_t)n;
+    }
+    b->bytes_enviados += tamanho;
+    b->pacotes_enviados++;
+}
+
+/* Imita tarefa_telemetria: lotes assim que chegam, medicoes que mudaram a cada intervalo */
+static void *thread_telemetria(void *arg)
+{
+    bancada_t *b = arg;
+    uint8_t quadro[CODEC_TELEMETRIA_QUADRO_MAX];
+    uint16_t sequencia = 0;
+    uint32_t versoes[MAX_CANAIS] = {0};
+    int64_t proxima_medicao_us = b->inicio_us;
+    while (true) {
+        if (agora_us() >= proxima_medicao_us) {
+            for (uint8_t c = 0; c < b->canais; c++) {
+                pthread_mutex_lock(&b->trava);
+                const telemetria_medicao_t medicao = b->medicoes[c];
+                pthread_mutex_unlock(&b->trava);
+                if (medicao.versao != versoes[c]) {
+                    versoes[c] = medicao.versao;
+                    transmitir(b, quadro, codec_telemetria_medicao(c, sequencia++, &medicao, quadro));
+                }
+            }
+            proxima_medicao_us = agora_us() + INTERVALO_MEDICAO_US;
+        }
+
+        pthread_mutex_lock(&b->trava);
+        if (b->cabeca == b->cauda) {
+            if (b->fim_producao) {
+                pthread_mutex_unlock(&b->trava);
+                break;
+            }
+            const struct timespec limite = {proxima_medicao_us / 1000000, (proxima_medicao_us % 1000000) * 1000};
+            pthread_cond_timedwait(&b->tem_lote, &b->trava, &limite);
+            pthread_mutex_unlock(&b->trava);
+            continue;
+        }
+        const lote_t lote = b->lotes[b->cauda++ % FILA_LOTES];
+        b->bytes_usados -= CABECALHO_MENSAGEM + lote.quantidade * sizeof(int64_t);
+        pthread_mutex_unlock(&b->trava);
+
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        const size_t tamanho = codec_telemetria_bordas(lote.canal, sequencia++, lote.bordas_us, lote.quantidade, quadro);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        b->ns_codificando += (uint64_t)((t1.tv_sec - t0.tv_sec) * 1000000000LL + (t1.tv_nsec - t0.tv_nsec));
+        b->bordas_codificadas += lote.quantidade;
+        transmitir(b, quadro, tamanho);
+    }
+    return NULL;
+}
+
+static void ao_receber(const telemetria_pacote_t *pacote, void *contexto)
+{
+    bancada_t *b = contexto;
+    if (b->tem_sequencia && pacote->sequencia != b->proxima_sequencia) {
+        b->pacotes_perdidos += (uint16_t)(pacote->sequencia - b->proxima_sequencia);
+    }
+    b->tem_sequencia = true;
+    b->proxima_sequencia = (uint16_t)(pacote->sequencia + 1U);
+    if (pacote->canal >= b->canais) {
+        return;
+    }
+    if (pacote->tipo == TELEMETRIA_MEDICAO) {
+        b->medicoes_recebidas++;
+        return;
+    }
+    const uint8_t c = pacote->canal;
+    for (uint32_t i = 0; i < pacote->bordas.quantidade; i++) {
+        const int64_t borda_us = pacote->bordas.bordas_us[i];
+        const bool na_grade = (borda_us - (b->inicio_us + c * 137)) % b->periodo_us[c] == 0;
+        if (!na_grade || borda_us <= b->ultima_recebida_us[c]) {
+            b->bordas_fora_da_grade++;
+        }
+        b->ultima_recebida_us[c] = borda_us;
+        b->bordas_recebidas[c]++;
+    }
+}
+
+static void *thread_receptor(void *arg)
+{
+    bancada_t *b = arg;
+    uint8_t bytes[4096];
+    while (true) {
+        const ssize_t n = read(b->escravo, bytes, sizeof(bytes));
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            break;   /* EIO quando o mestre fecha */
+        }
+        codec_telemetria_leitor_alimentar(&b->leitor, bytes, (size_t)n, ao_receber, b);
+    }
+    return NULL;
+}
+
+static int abrir_pty(bancada_t *b)
+{
+    b->mestre = posix_openpt(O_RDWR | O_NOCTTY);
+    if (b->mestre < 0 || grantpt(b->mestre) != 0 || unlockpt(b->mestre) != 0) {
+        perror("posix_openpt");
+        return -1;
+    }
+    b->escravo = open(ptsname(b->mestre), O_RDWR | O_NOCTTY);
+    if (b->escravo < 0) {
+        perror("ptsname");
+        return -1;
+    }
+    /* Sem disciplina de linha: os bytes passam como numa UART */
+    struct termios modo;
+    tcgetattr(b->escravo, &modo);
+    cfmakeraw(&modo);
+    tcsetattr(b->escravo, TCSANOW, &modo);
+    tcgetattr(b->mestre, &modo);
+    cfmakeraw(&modo);
+    tcsetattr(b->mestre, TCSANOW, &modo);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    bancada_t *b = &s_bancada;
+    int arg = 1;
+    b->canais = 1;
+    if (argc > arg + 1 && strcmp(argv[arg], "--canais") == 0) {
+        const int pedido = atoi(argv[arg + 1]);
+        b->canais = (uint8_t)(pedido < 1 ? 1 : pedido > MAX_CANAIS ? MAX_CANAIS : pedido);
+        arg += 2;
+    }
+    if (argc < arg + 2) {
+        fprintf(stderr, "uso: %s [--canais N] <hz> <segundos> [baud]\n", argv[0]);
+        return 2;
+    }
+    const double frequencia_hz = atof(argv[arg]);
+    b->duracao_us = (int64_t)(atof(argv[arg + 1]) * 1e6);
+    b->baud = argc > arg + 2 ? (uint32_t)atoi(argv[arg + 2]) : 921600U;
+    if (frequencia_hz <= 0.0 || b->duracao_us <= 0 || b->baud == 0) {
+        fprintf(stderr, "parametros invalidos\n");
+        return 2;
+    }
+    for (uint8_t c = 0; c < b->canais; c++) {
+        b->periodo_us[c] = (uint32_t)(1e6 / (frequencia_hz * (4U + c) / 4.0) + 0.5);
+    }
+    if (abrir_pty(b) != 0) {
+        return 1;
+    }
+    pthread_mutex_init(&b->trava, NULL);
+    pthread_condattr_t atributos;
+    pthread_condattr_init(&atributos);
+    pthread_condattr_setclock(&atributos, CLOCK_MONOTONIC);
+    pthread_cond_init(&b->tem_lote, &atributos);
+    codec_telemetria_leitor_inicializar(&b->leitor);
+
+    b->inicio_us = agora_us();
+    pthread_t metricas, telemetria, receptor;
+    pthread_create(&receptor, NULL, thread_receptor, b);
+    pthread_create(&telemetria, NULL, thread_telemetria, b);
+    pthread_create(&metricas, NULL, thread_metricas, b);
+    pthread_join(metricas, NULL);
+    pthread_join(telemetria, NULL);
+    /* Espera o pty esvaziar antes de fechar o mestre */
+    tcdrain(b->mestre);
+    usleep(100000);
+    close(b->mestre);
+    pthread_join(receptor, NULL);
+    const double segundos = (agora_us() - b->inicio_us) / 1e6;
+
+    uint64_t geradas = 0;
+    uint64_t recebidas = 0;
+    printf("%u canais, %.0f Hz base, %.1f s, %" PRIu32 " baud\n", b->canais, frequencia_hz, segundos, b->baud);
+    for (uint8_t c = 0; c < b->canais; c++) {
+        printf("canal %u: %" PRIu64 " bordas geradas, %" PRIu64 " recebidas\n", c, b->bordas_geradas[c],
+               b->bordas_recebidas[c]);
+        geradas += b->bordas_geradas[c];
+        recebidas += b->bordas_recebidas[c];
+    }
+    printf("buffer: %" PRIu64 " bordas descartadas (%.2f%%)\n", b->bordas_descartadas,
+           geradas ? 100.0 * b->bordas_descartadas / geradas : 0.0);
+    printf("enlace: %" PRIu64 " pacotes, %" PRIu64 " bytes (%.1f kB/s, %.1f%% do baud), %.2f bytes/borda\n",
+           b->pacotes_enviados, b->bytes_enviados, b->bytes_enviados / segundos / 1e3,
+           100.0 * b->bytes_enviados * 10.0 / segundos / b->baud, recebidas ? (double)b->bytes_enviados / recebidas : 0.0);
+    printf("receptor: %" PRIu32 " quadros validos, %" PRIu32 " invalidos, %" PRIu64 " pacotes perdidos, %" PRIu64
+           " medicoes, %" PRIu64 " bordas fora da grade\n",
+           b->leitor.quadros_validos, b->leitor.quadros_invalidos, b->pacotes_perdidos, b->medicoes_recebidas,
+           b->bordas_fora_da_grade);
+    printf("codificacao: %.1f ns/borda; %.0f bordas/s entregues\n",
+           b->bordas_codificadas ? (double)b->ns_codificando / b->bordas_codificadas : 0.0, recebidas / segundos);
+    const bool consistente = recebidas + b->bordas_descartadas == geradas && b->pacotes_perdidos == 0 &&
+                             b->leitor.quadros_invalidos == 0 && b->bordas_fora_da_grade == 0;
+    printf("%s\n", consistente ? "OK: geradas = recebidas + descartadas" : "FALHA: contas nao fecham");
+    return consistente ? 0 : 1;
+}
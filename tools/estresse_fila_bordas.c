@@ -0,0 +1,159 @@
+/*
+ * Teste de estresse de host para fila_bordas: uma thread faz o papel da ISR
+ * (insere uma sequencia crescente com espacamento aleatorio curto) e outra
+ * o da tarefa de metricas (drena em lotes de tamanho variavel, com pausas que
+ * forcam a fila a encher). Os indices comecam perto de UINT32_MAX para o
+ * contador de cabeca/cauda dar a volta durante o teste.
+ *
+ *   cmake -S tools -B build-host && cmake --build build-host
+ *   ./build-host/estresse_fila_bordas [bordas]
+ *
+ * Confere que a ordem se mantem, que cada borda foi entregue ou contada como
+ * transbordo exatamente uma vez e que transbordos bate com as recusas vistas
+ * pelo produtor. Sai com 1 na primeira divergencia.
+ */
+#include "fila_bordas.h"
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BORDAS_PADRAO       10000000U
+#define INDICE_INICIAL      (UINT32_MAX - 4096U)
+#define LOTE_MAXIMO         64U
+#define DRENAGENS_POR_PAUSA 2048U
+#define PAUSA_NS            50000L
+#define ESPERA_MAXIMA       64U     /* voltas de espera entre insercoes */
+
+typedef struct {
+    fila_bordas_t fila;
+    uint32_t bordas;
+    uint8_t *recusadas;             /* indexado pelo valor inserido */
+    uint8_t *recebidas;
+    uint32_t total_recusadas;
+    uint32_t total_recebidas;
+    uint32_t fora_de_ordem;
+    _Atomic bool fim_producao;
+} estresse_t;
+
+static uint32_t proximo_aleatorio(uint32_t *estado)
+{
+    *estado ^= *estado << 13;
+    *estado ^= *estado >> 17;
+    *estado ^= *estado << 5;
+    return *estado;
+}
+
+static void *produtor(void *arg)
+{
+    estresse_t *estresse = arg;
+    uint32_t estado = 0x12345678U;
+    for (uint32_t valor = 1; valor <= estresse->bordas; valor++) {
+        for (volatile uint32_t espera = proximo_aleatorio(&estado) % ESPERA_MAXIMA; espera > 0; espera--) {
+        }
+        if (!fila_bordas_inserir(&estresse->fila, (int64_t)valor)) {
+            estresse->recusadas[valor] = 1;
+            estresse->total_recusadas++;
+        }
+    }
+    atomic_store_explicit(&estresse->fim_producao, true, memory_order_release);
+    return NULL;
+}
+
+static void *consumidor(void *arg)
+{
+    estresse_t *estresse = arg;
+    int64_t destino[LOTE_MAXIMO];
+    int64_t anterior = 0;
+    uint32_t estado = 0x9E3779B9U;
+    uint32_t drenagens = 0;
+    for (;;) {
+        /* Le o fim antes de drenar: o que sobrar depois dele ja esta visivel */
+        const bool fim = atomic_load_explicit(&estresse->fim_producao, memory_order_acquire);
+        const size_t max = 1U + proximo_aleatorio(&estado) % LOTE_MAXIMO;
+        const size_t lidas = fila_bordas_drenar(&estresse->fila, destino, max);
+        for (size_t i = 0; i < lidas; i++) {
+            const int64_t valor = destino[i];
+            if (valor <= anterior || valor > (int64_t)estresse->bordas) {
+                estresse->fora_de_ordem++;
+            } else {
+                estresse->recebidas[valor]++;
+                estresse->total_recebidas++;
+            }
+            anterior = valor;
+        }
+        if (fim && lidas == 0 && fila_bordas_vazia(&estresse->fila)) {
+            break;
+        }
+        if (++drenagens % DRENAGENS_POR_PAUSA == 0) {
+            const struct timespec pausa = {.tv_sec = 0, .tv_nsec = PAUSA_NS};
+            nanosleep(&pausa, NULL);
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char **argv)
+{
+    static estresse_t estresse;
+    estresse.bordas = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : BORDAS_PADRAO;
+    if (estresse.bordas == 0) {
+        fprintf(stderr, "uso: %s [bordas]\n", argv[0]);
+        return 2;
+    }
+    estresse.recusadas = calloc((size_t)estresse.bordas + 1U, 1);
+    estresse.recebidas = calloc((size_t)estresse.bordas + 1U, 1);
+    if (!estresse.recusadas || !estresse.recebidas) {
+        fprintf(stderr, "sem memoria para %" PRIu32 " bordas\n", estresse.bordas);
+        return 2;
+    }
+
+    fila_bordas_inicializar(&estresse.fila);
+    atomic_store_explicit(&estresse.fila.cabeca, INDICE_INICIAL, memory_order_relaxed);
+    atomic_store_explicit(&estresse.fila.cauda, INDICE_INICIAL, memory_order_relaxed);
+
+    pthread_t thread_produtor;
+    pthread_t thread_consumidor;
+    pthread_create(&thread_consumidor, NULL, consumidor, &estresse);
+    pthread_create(&thread_produtor, NULL, produtor, &estresse);
+    pthread_join(thread_produtor, NULL);
+    pthread_join(thread_consumidor, NULL);
+
+    uint32_t faltando = 0;
+    uint32_t duplicadas = 0;
+    for (uint32_t valor = 1; valor <= estresse.bordas; valor++) {
+        const unsigned vezes = estresse.recebidas[valor] + estresse.recusadas[valor];
+        faltando += vezes == 0;
+        duplicadas += vezes > 1;
+    }
+    const uint32_t transbordos = fila_bordas_transbordos(&estresse.fila);
+    const uint32_t cabeca = atomic_load_explicit(&estresse.fila.cabeca, memory_order_relaxed);
+    const uint32_t esperado_cabeca = INDICE_INICIAL + estresse.total_recebidas;
+    const bool deu_a_volta = estresse.total_recebidas > UINT32_MAX - INDICE_INICIAL;
+
+    printf("bordas: %" PRIu32 "  recebidas: %" PRIu32 "  transbordos: %" PRIu32 " (produtor viu %" PRIu32 ")\n",
+           estresse.bordas, estresse.total_recebidas, transbordos, estresse.total_recusadas);
+    printf("fora de ordem: %" PRIu32 "  faltando: %" PRIu32 "  duplicadas: %" PRIu32 "  indice deu a volta: %s\n",
+           estresse.fora_de_ordem, faltando, duplicadas, deu_a_volta ? "sim" : "nao");
+
+    bool ok = true;
+    if (estresse.fora_de_ordem || faltando || duplicadas) {
+        fprintf(stderr, "FALHA: sequencia entregue nao confere\n");
+        ok = false;
+    }
+    if (transbordos != estresse.total_recusadas ||
+        estresse.total_recebidas + transbordos != estresse.bordas) {
+        fprintf(stderr, "FALHA: contagem de transbordos nao confere\n");
+        ok = false;
+    }
+    if (cabeca != esperado_cabeca || !fila_bordas_vazia(&estresse.fila)) {
+        fprintf(stderr, "FALHA: indices da fila nao conferem depois da volta\n");
+        ok = false;
+    }
+    free(estresse.recusadas);
+    free(estresse.recebidas);
+    return ok ? 0 : 1;
+}
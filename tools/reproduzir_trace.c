@@ -0,0 +1,408 @@
+/*
+ * Reproduz um trace de bordas pelo nucleo de medicao (filtro de glitch,
+ * estimador, distancia, idle/reset e governador de publicacao) com relogio
+ * simulado, e mede vazao e exatidao sem hardware.
+ *
+ *   cmake -S tools -B build-host && cmake --build build-host
+ *   ./build-host/reproduzir_trace [--canais N] --sintetico <hz> <segundos> [jitter_us] [repiques]
+ *   ./build-host/reproduzir_trace --periodos periodos.txt   # saida do decodificador_gravador
+ *   ./build-host/reproduzir_trace bordas.txt                # timestamps absolutos em us, um por linha
+ */
+#include "fila_bordas.h"
+#include "filtro_glitch.h"
+#include "governador_publicacao.h"
+#include "nucleo_medicao.h"
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Mesmos parametros de main/metricas.c e dos defaults do Kconfig */
+#define PERIODO_MAXIMO_US        1000000
+#define PERIODOS_MINIMOS_JANELA  4
+#define INTERVALO_RAPIDO_MS      33
+#define INTERVALO_BATIMENTO_MS   250
+#define PUBLICACOES_ESTAVEIS     5
+#define LIMIAR_MUDANCA_Q16       (Q16_UM / 4U)
+#define FILTRO_BLOQUEIO_MIN_US   150
+#define FILTRO_FRACAO_PCT        50
+#define FILTRO_SUAVIZACAO_SHIFT  3
+#define INTERVALO_REPIQUE_US     40
+#define INICIO_TRACE_US          1000000
+#define MAX_CANAIS               4
+#define LOTE_BORDAS              64
+
+/* Trace ja intercalado por tempo; canais[i] diz de qual maquina veio cada borda */
+typedef struct {
+    int64_t *bordas;
+    uint8_t *canais;
+    size_t quantidade;
+    size_t capacidade;
+    uint8_t total_canais;
+    uint64_t bordas_reais[MAX_CANAIS];   /* so no sintetico: bordas sem repique */
+    double frequencia_hz[MAX_CANAIS];    /* so no sintetico: referencia de exatidao */
+} trace_t;
+
+typedef struct {
+    uint64_t publicacoes_ativas;
+    double soma_erro_ppm;
+    double erro_maximo_ppm;
+    uint32_t sessoes;
+    uint64_t furos_sessoes;          /* soma dos resumos das sessoes encerradas */
+    resumo_sessao_t ultimo_resumo;
+    uint32_t transbordos;
+} resultado_canal_t;
+
+/* Mesma divisao do firmware: fonte (filtro + fila) de um lado, tarefa (nucleo) do outro */
+typedef struct {
+    filtro_glitch_t filtro;
+    fila_bordas_t fila;
+    nucleo_medicao_t nucleo;
+    uint32_t frequencia_publicada_q16;
+    bool sinal_publicado;
+    resultado_canal_t resultado;
+} canal_replay_t;
+
+typedef struct {
+    canal_replay_t canais[MAX_CANAIS];
+    uint8_t total_canais;
+    governador_publicacao_t governador;
+    int64_t relogio_us;
+    uint64_t publicacoes;
+} replay_t;
+
+static uint64_t agora_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int64_t relogio_simulado(void *contexto)
+{
+    return *(const int64_t *)contexto;
+}
+
+static void trace_adicionar(trace_t *trace, int64_t borda_us, uint8_t canal)
+{
+    if (trace->quantidade == trace->capacidade) {
+        trace->capacidade = trace->capacidade ? trace->capacidade * 2U : 4096U;
+        trace->bordas = realloc(trace->bordas, trace->capacidade * sizeof(*trace->bordas));
+        trace->canais = realloc(trace->canais, trace->capacidade * sizeof(*trace->canais));
+        if (!trace->bordas || !trace->canais) {
+            fprintf(stderr, "sem memoria\n");
+            exit(1);
+        }
+    }
+    trace->bordas[trace->quantidade] = borda_us;
+    trace->canais[trace->quantidade] = canal;
+    trace->quantidade++;
+}
+
+static uint32_t prng_proximo(uint32_t *estado)
+{
+    uint32_t x = *estado;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *estado = x;
+    return x;
+}
+
+/* Canais em frequencias diferentes (x1, x1.25, x1.5, x1.75), como a fonte simulada do firmware */
+static void gerar_sintetico(trace_t *trace, uint8_t canais, double frequencia_hz, double segundos, uint32_t jitter_us,
+                            uint32_t repiques)
+{
+    const int64_t fim_us = INICIO_TRACE_US + (int64_t)(segundos * 1e6);
+    double proxima_us[MAX_CANAIS];
+    uint32_t estados[MAX_CANAIS];
+    trace->total_canais = canais;
+    for (uint8_t c = 0; c < canais; c++) {
+        trace->frequencia_hz[c] = frequencia_hz * (4U + c) / 4.0;
+        proxima_us[c] = INICIO_TRACE_US + c * 137.0;
+        estados[c] = 0x9E3779B9U + c;
+    }
+    while (true) {
+        uint8_t canal = 0;
+        for (uint8_t c = 1; c < canais; c++) {
+            if (proxima_us[c] < proxima_us[canal]) {
+                canal = c;
+            }
+        }
+        if (proxima_us[canal] >= fim_us) {
+            break;
+        }
+        const int64_t borda_us = (int64_t)llround(proxima_us[canal]);
+        trace_adicionar(trace, borda_us, canal);
+        trace->bordas_reais[canal]++;
+        /* Repiques de um canal podem se intercalar com bordas de outro; a ordem por canal e o que importa */
+        for (uint32_t r = 1; r <= repiques; r++) {
+            trace_adicionar(trace, borda_us + (int64_t)(r * INTERVALO_REPIQUE_US), canal);
+        }
+        const double jitter =
+            jitter_us ? (double)(prng_proximo(&estados[canal]) % (2U * jitter_us + 1U)) - jitter_us : 0.0;
+        proxima_us[canal] += 1e6 / trace->frequencia_hz[canal] + jitter;
+    }
+}
+
+static int carregar_arquivo(trace_t *trace, const char *caminho, int periodos)
+{
+    FILE *arquivo = fopen(caminho, "r");
+    if (!arquivo) {
+        perror(caminho);
+        return -1;
+    }
+    trace->total_canais = 1;
+    int64_t valor;
+    int64_t acumulado = INICIO_TRACE_US;
+    if (periodos) {
+        trace_adicionar(trace, acumulado, 0);
+    }
+    while (fscanf(arquivo, "%" SCNd64, &valor) == 1) {
+        if (periodos) {
+            acumulado += valor;
+            trace_adicionar(trace, acumulado, 0);
+        } else {
+            trace_adicionar(trace, valor, 0);
+        }
+    }
+    fclose(arquivo);
+    return trace->quantidade > 1 ? 0 : -1;
+}
+
+static void inicializar_replay(replay_t *replay, uint8_t canais)
+{
+    memset(replay, 0, sizeof(*replay));
+    replay->total_canais = canais;
+    const filtro_glitch_config_t filtro_config = {
+        .bloqueio_minimo_us = FILTRO_BLOQUEIO_MIN_US,
+        .fracao_q8 = (FILTRO_FRACAO_PCT * 256U) / 100U,
+        .periodo_maximo_us = PERIODO_MAXIMO_US,
+        .suavizacao_shift = FILTRO_SUAVIZACAO_SHIFT,
+    };
+    const nucleo_medicao_config_t nucleo_config = {
+        .sessao = {.tempo_pausa_ms = SESSAO_PAUSA_PADRAO_MS, .tempo_encerrar_ms = SESSAO_ENCERRAR_PADRAO_MS},
+        .periodo_maximo_us = PERIODO_MAXIMO_US,
+        .periodos_minimos = PERIODOS_MINIMOS_JANELA,
+        .relogio = relogio_simulado,
+        .contexto_relogio = &replay->relogio_us,
+    };
+    for (uint8_t c = 0; c < canais; c++) {
+        canal_replay_t *canal = &replay->canais[c];
+        filtro_glitch_inicializar(&canal->filtro, &filtro_config);
+        fila_bordas_inicializar(&canal->fila);
+        nucleo_medicao_inicializar(&canal->nucleo, &nucleo_config);
+        nucleo_medicao_definir_curso_um(&canal->nucleo, (uint32_t)(CURSO_MAX_CM * 0.7f * UM_POR_CM));
+    }
+    const governador_config_t governador_config = {
+        .intervalo_rapido_ms = INTERVALO_RAPIDO_MS,
+        .intervalo_lento_ms = INTERVALO_BATIMENTO_MS,
+        .publicacoes_estaveis = PUBLICACOES_ESTAVEIS,
+    };
+    governador_publicacao_inicializar(&replay->governador, &governador_config);
+}
+
+/* Lado da ISR: filtro e fila do canal; retorna se a borda foi aceita */
+static bool entregar_borda(canal_replay_t *canal, int64_t borda_us)
+{
+    if (!filtro_glitch_aceitar(&canal->filtro, borda_us)) {
+        return false;
+    }
+    fila_bordas_inserir(&canal->fila, borda_us);
+    return true;
+}
+
+static void drenar_fila(canal_replay_t *canal)
+{
+    int64_t lote[LOTE_BORDAS];
+    size_t quantidade;
+    do {
+        quantidade = fila_bordas_drenar(&canal->fila, lote, LOTE_BORDAS);
+        for (size_t i = 0; i < quantidade; i++) {
+            nucleo_medicao_registrar_borda(&canal->nucleo, lote[i]);
+        }
+    } while (quantidade == LOTE_BORDAS);
+}
+
+/* Espera maxima antes de a fila do canal passar da metade na frequencia publicada */
+static uint32_t prazo_fila_ms(uint32_t frequencia_q16)
+{
+    if (frequencia_q16 == 0) {
+        return GOVERNADOR_ESPERA_INFINITA;
+    }
+    const uint64_t prazo_ms = ((uint64_t)(FILA_BORDAS_CAPACIDADE / 2U) * 1000U << 16) / frequencia_q16;
+    return prazo_ms > 0 ? (uint32_t)prazo_ms : 1U;
+}
+
+/* Mesma sequencia de tarefa_metricas: drena e publica cada canal, depois pede a proxima espera */
+static int64_t publicar(replay_t *replay, const trace_t *trace)
+{
+    bool mudou = false;
+    bool algum_ativo = false;
+    uint32_t prazo_ms = GOVERNADOR_ESPERA_INFINITA;
+    for (uint8_t c = 0; c < replay->total_canais; c++) {
+        canal_replay_t *canal = &replay->canais[c];
+        drenar_fila(canal);
+        dados_medidos_t medicao;
+        const bool sinal_ativo = nucleo_medicao_publicar(&canal->nucleo, &medicao);
+        const uint32_t variacao_q16 = medicao.frequencia_q16 > canal->frequencia_publicada_q16
+                                          ? medicao.frequencia_q16 - canal->frequencia_publicada_q16
+                                          : canal->frequencia_publicada_q16 - medicao.frequencia_q16;
+        mudou |= variacao_q16 > LIMIAR_MUDANCA_Q16 || sinal_ativo != canal->sinal_publicado;
+        algum_ativo |= sinal_ativo;
+        canal->frequencia_publicada_q16 = medicao.frequencia_q16;
+        canal->sinal_publicado = sinal_ativo;
+
+        resultado_canal_t *resultado = &canal->resultado;
+        resumo_sessao_t resumo;
+        if (nucleo_medicao_retirar_resumo(&canal->nucleo, &resumo)) {
+            resultado->sessoes++;
+            resultado->furos_sessoes += resumo.furos;
+            resultado->ultimo_resumo = resumo;
+        }
+        if (sinal_ativo && medicao.frequencia_q16 > 0 && trace->frequencia_hz[c] > 0.0) {
+            const double erro_ppm = fabs(q16_para_float(medicao.frequencia_q16) - trace->frequencia_hz[c]) /
+                                    trace->frequencia_hz[c] * 1e6;
+            resultado->publicacoes_ativas++;
+            resultado->soma_erro_ppm += erro_ppm;
+            if (erro_ppm > resultado->erro_maximo_ppm) {
+                resultado->erro_maximo_ppm = erro_ppm;
+            }
+        }
+        uint32_t prazo_canal_ms = nucleo_medicao_prazo_ms(&canal->nucleo);
+        if (sinal_ativo && prazo_fila_ms(medicao.frequencia_q16) < prazo_canal_ms) {
+            prazo_canal_ms = prazo_fila_ms(medicao.frequencia_q16);
+        }
+        if (prazo_canal_ms < prazo_ms) {
+            prazo_ms = prazo_canal_ms;
+        }
+    }
+    replay->publicacoes++;
+    const uint32_t espera_ms = governador_publicacao_avaliar(&replay->governador, mudou, algum_ativo, prazo_ms);
+    return espera_ms == GOVERNADOR_ESPERA_INFINITA ? INT64_MAX : replay->relogio_us + (int64_t)espera_ms * 1000;
+}
+
+static void reproduzir(replay_t *replay, const trace_t *trace)
+{
+    inicializar_replay(replay, trace->total_canais);
+    int64_t proxima_publicacao_us = INT64_MAX;
+    for (size_t i = 0; i < trace->quantidade; i++) {
+        const int64_t borda_us = trace->bordas[i];
+        while (proxima_publicacao_us <= borda_us) {
+            replay->relogio_us = proxima_publicacao_us;
+            proxima_publicacao_us = publicar(replay, trace);
+        }
+        replay->relogio_us = borda_us;
+        canal_replay_t *canal = &replay->canais[trace->canais[i]];
+        const int64_t despertar_us = borda_us + INTERVALO_RAPIDO_MS * 1000;
+        if (entregar_borda(canal, borda_us) && canal->frequencia_publicada_q16 == 0 &&
+            despertar_us < proxima_publicacao_us) {
+            /* Canal parado ou em pausa: o despertador sem referencia acorda a tarefa na primeira borda */
+            proxima_publicacao_us = despertar_us;
+        }
+    }
+    /* Deixa o sinal parar e as sessoes encerrarem: conta a descida e colhe os resumos */
+    while (proxima_publicacao_us != INT64_MAX) {
+        replay->relogio_us = proxima_publicacao_us;
+        proxima_publicacao_us = publicar(replay, trace);
+    }
+    for (uint8_t c = 0; c < replay->total_canais; c++) {
+        replay->canais[c].resultado.transbordos = fila_bordas_transbordos(&replay->canais[c].fila);
+    }
+}
+
+/* So o caminho quente por borda: filtro, fila e nucleo, drenando em lotes como a tarefa */
+static double medir_ns_por_borda(const trace_t *trace)
+{
+    static replay_t replay;
+    inicializar_replay(&replay, trace->total_canais);
+    const uint64_t inicio_ns = agora_ns();
+    for (size_t i = 0; i < trace->quantidade; i++) {
+        canal_replay_t *canal = &replay.canais[trace->canais[i]];
+        entregar_borda(canal, trace->bordas[i]);
+        if ((i & (LOTE_BORDAS - 1U)) == LOTE_BORDAS - 1U) {
+            for (uint8_t c = 0; c < replay.total_canais; c++) {
+                drenar_fila(&replay.canais[c]);
+            }
+        }
+    }
+    for (uint8_t c = 0; c < replay.total_canais; c++) {
+        drenar_fila(&replay.canais[c]);
+    }
+    return (double)(agora_ns() - inicio_ns) / trace->quantidade;
+}
+
+int main(int argc, char **argv)
+{
+    trace_t trace = { 0 };
+    int arg = 1;
+    uint8_t canais = 1;
+    if (argc > arg + 1 && strcmp(argv[arg], "--canais") == 0) {
+        const int pedido = atoi(argv[arg + 1]);
+        canais = (uint8_t)(pedido < 1 ? 1 : pedido > MAX_CANAIS ? MAX_CANAIS : pedido);
+        arg += 2;
+    }
+    if (argc >= arg + 3 && strcmp(argv[arg], "--sintetico") == 0) {
+        gerar_sintetico(&trace, canais, atof(argv[arg + 1]), atof(argv[arg + 2]),
+                        argc > arg + 3 ? (uint32_t)atoi(argv[arg + 3]) : 0U,
+                        argc > arg + 4 ? (uint32_t)atoi(argv[arg + 4]) : 0U);
+    } else if (argc == arg + 2 && strcmp(argv[arg], "--periodos") == 0) {
+        if (carregar_arquivo(&trace, argv[arg + 1], 1) != 0) {
+            return 1;
+        }
+    } else if (argc == arg + 1) {
+        if (carregar_arquivo(&trace, argv[arg], 0) != 0) {
+            return 1;
+        }
+    } else {
+        fprintf(stderr,
+                "uso: %s [--canais N] --sintetico <hz> <segundos> [jitter_us] [repiques] | --periodos <arquivo> | "
+                "<arquivo>\n",
+                argv[0]);
+        return 2;
+    }
+    if (trace.quantidade < 2) {
+        fprintf(stderr, "trace vazio\n");
+        return 1;
+    }
+
+    static replay_t replay;
+    const uint64_t inicio_ns = agora_ns();
+    reproduzir(&replay, &trace);
+    const uint64_t total_ns = agora_ns() - inicio_ns;
+    const double ns_por_borda = medir_ns_por_borda(&trace);
+
+    const int64_t duracao_us = trace.bordas[trace.quantidade - 1] - trace.bordas[0];
+    const double minutos = duracao_us / 60e6;
+    printf("canais: %u  bordas: %zu em %.1f s de trace\n", trace.total_canais, trace.quantidade, duracao_us / 1e6);
+    printf("vazao: %.2f Mbordas/s com publicacoes, %.1f ns/borda so no caminho quente\n",
+           trace.quantidade / (total_ns / 1e3), ns_por_borda);
+    printf("publicacoes: %" PRIu64 " (%.1f por minuto de trace)\n", replay.publicacoes,
+           minutos > 0.0 ? replay.publicacoes / minutos : 0.0);
+    for (uint8_t c = 0; c < trace.total_canais; c++) {
+        const resultado_canal_t *resultado = &replay.canais[c].resultado;
+        printf("canal %u: %" PRIu32 " sessoes, furos %" PRIu64, c, resultado->sessoes, resultado->furos_sessoes);
+        if (trace.bordas_reais[c]) {
+            printf(" de %" PRIu64 " reais (%+" PRId64 ")", trace.bordas_reais[c],
+                   (int64_t)resultado->furos_sessoes - (int64_t)trace.bordas_reais[c]);
+        }
+        if (resultado->sessoes) {
+            printf(", RPM medio %.1f pico %.1f", q16_para_float(resultado->ultimo_resumo.rpm_medio_q16),
+                   q16_para_float(resultado->ultimo_resumo.rpm_pico_q16));
+        }
+        if (resultado->transbordos) {
+            printf(", %" PRIu32 " bordas perdidas na fila", resultado->transbordos);
+        }
+        if (resultado->publicacoes_ativas) {
+            printf(", erro medio %.1f ppm, maximo %.1f ppm", resultado->soma_erro_ppm / resultado->publicacoes_ativas,
+                   resultado->erro_maximo_ppm);
+        }
+        printf("\n");
+    }
+    free(trace.bordas);
+    free(trace.canais);
+    return 0;
+}
@@ -0,0 +1,22 @@
+/*
+ * No lugar de main/assets/liga_d_logo.c quando ele nao esta na arvore (e
+ * gerado a partir do PNG em main/assets): um quadrado cinza, so para a
+ * splash ter o que escalar.
+ */
+#include "lvgl.h"
+
+#define LADO 16
+
+static const uint16_t s_pixels[LADO * LADO] = {[0 ... LADO * LADO - 1] = 0x8410};
+
+const lv_image_dsc_t liga_d_logo = {
+    .header = {
+        .magic = LV_IMAGE_HEADER_MAGIC,
+        .cf = LV_COLOR_FORMAT_RGB565,
+        .w = LADO,
+        .h = LADO,
+        .stride = LADO * sizeof(uint16_t),
+    },
+    .data_size = sizeof(s_pixels),
+    .data = (const uint8_t *)s_pixels,
+};
@@ -0,0 +1,156 @@
+#include "metricas_simuladas.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "barramento_metricas.h"
+#include "esp_timer.h"
+#include "governador_publicacao.h"
+#include "metricas.h"
+#include "nucleo_medicao.h"
+#include "tendencia.h"
+
+/* Mesmos parametros de main/metricas.c */
+#define PERIODO_MAXIMO_US        1000000
+#define INTERVALO_RAPIDO_MS      33
+#define INTERVALO_BATIMENTO_MS   250
+#define PUBLICACOES_ESTAVEIS     5
+#define LIMIAR_MUDANCA_Q16       (Q16_UM / 4U)
+#define PERIODOS_MINIMOS_JANELA  4
+#define ESCOPO_LARGURA_COLUNA_US 1000
+
+static nucleo_medicao_t s_nucleo;
+static decimador_escopo_t s_escopo;
+static barramento_metricas_t s_barramento;
+static governador_publicacao_t s_governador;
+static int64_t s_relogio_us;
+static int64_t s_proxima_borda_us = INT64_MAX;
+static int64_t s_proxima_publicacao_us = INT64_MAX;
+static uint32_t s_frequencia_publicada_q16;
+static bool s_sinal_publicado;
+static uint32_t s_sequencia;
+static bool s_escopo_visivel;
+
+static int64_t relogio_simulado(void *contexto)
+{
+    return *(const int64_t *)contexto;
+}
+
+void metricas_simuladas_inicializar(float curso_cm)
+{
+    const nucleo_medicao_config_t nucleo_config = {
+        .sessao = {.tempo_pausa_ms = SESSAO_PAUSA_PADRAO_MS, .tempo_encerrar_ms = SESSAO_ENCERRAR_PADRAO_MS},
+        .periodo_maximo_us = PERIODO_MAXIMO_US,
+        .periodos_minimos = PERIODOS_MINIMOS_JANELA,
+        .relogio = relogio_simulado,
+        .contexto_relogio = &s_relogio_us,
+    };
+    nucleo_medicao_inicializar(&s_nucleo, &nucleo_config);
+    metricas_simuladas_definir_curso(curso_cm);
+    decimador_escopo_inicializar(&s_escopo, ESCOPO_LARGURA_COLUNA_US, PERIODO_MAXIMO_US);
+    barramento_metricas_inicializar(&s_barramento, 1);
+    const governador_config_t governador_config = {
+        .intervalo_rapido_ms = INTERVALO_RAPIDO_MS,
+        .intervalo_lento_ms = INTERVALO_BATIMENTO_MS,
+        .publicacoes_estaveis = PUBLICACOES_ESTAVEIS,
+    };
+    governador_publicacao_inicializar(&s_governador, &governador_config);
+}
+
+void metricas_simuladas_definir_curso(float curso_cm)
+{
+    nucleo_medicao_definir_curso_um(&s_nucleo, (uint32_t)lroundf(curso_cm * UM_POR_CM));
+}
+
+uint32_t metricas_simuladas_publicacoes(void)
+{
+    return s_sequencia;
+}
+
+/* Mesma sequencia de tarefa_metricas para um canal; devolve o instante da proxima */
+static int64_t publicar(void)
+{
+    decimador_escopo_avancar(&s_escopo, s_relogio_us);
+    dados_medidos_t medicao;
+    const bool sinal_ativo = nucleo_medicao_publicar(&s_nucleo, &medicao);
+    const uint32_t variacao_q16 = medicao.frequencia_q16 > s_frequencia_publicada_q16
+                                      ? medicao.frequencia_q16 - s_frequencia_publicada_q16
+                                      : s_frequencia_publicada_q16 - medicao.frequencia_q16;
+    const bool mudou = variacao_q16 > LIMIAR_MUDANCA_Q16 || sinal_ativo != s_sinal_publicado;
+    /* Sem borda_us: a latencia pulso-tela mistura relogios aqui (o da tela e o do host) */
+    medicao.carimbo = (carimbo_medicao_t){
+        .sequencia = ++s_sequencia,
+        .publicacao_us = esp_timer_get_time(),
+    };
+    barramento_metricas_publicar(&s_barramento, 0, &medicao);
+    tendencia_registrar(&medicao, esp_timer_get_time() / 1000);
+    resumo_sessao_t resumo;
+    nucleo_medicao_retirar_resumo(&s_nucleo, &resumo);
+    s_frequencia_publicada_q16 = medicao.frequencia_q16;
+    s_sinal_publicado = sinal_ativo;
+
+    uint32_t espera_ms = governador_publicacao_avaliar(&s_governador, mudou, sinal_ativo,
+                                                       nucleo_medicao_prazo_ms(&s_nucleo));
+    if (s_escopo_visivel && espera_ms > INTERVALO_RAPIDO_MS) {
+        espera_ms = INTERVALO_RAPIDO_MS;
+    }
+    return espera_ms == GOVERNADOR_ESPERA_INFINITA ? INT64_MAX : s_relogio_us + (int64_t)espera_ms * 1000;
+}
+
+void metricas_simuladas_avancar(int64_t agora_us, double frequencia_hz)
+{
+    if (frequencia_hz <= 0.0) {
+        s_proxima_borda_us = INT64_MAX;
+    } else if (s_proxima_borda_us == INT64_MAX) {
+        s_proxima_borda_us = agora_us;
+    }
+    while (s_proxima_borda_us <= agora_us || s_proxima_publicacao_us <= agora_us) {
+        if (s_proxima_publicacao_us <= s_proxima_borda_us) {
+            s_relogio_us = s_proxima_publicacao_us;
+            s_proxima_publicacao_us = publicar();
+            continue;
+        }
+        s_relogio_us = s_proxima_borda_us;
+        nucleo_medicao_registrar_borda(&s_nucleo, s_proxima_borda_us);
+        decimador_escopo_registrar_borda(&s_escopo, s_proxima_borda_us);
+        const int64_t despertar_us = s_proxima_borda_us + INTERVALO_RAPIDO_MS * 1000;
+        if (s_frequencia_publicada_q16 == 0 && despertar_us < s_proxima_publicacao_us) {
+            /* Canal parado: o despertador de bordas acorda a tarefa na primeira */
+            s_proxima_publicacao_us = despertar_us;
+        }
+        s_proxima_borda_us += (int64_t)llround(1e6 / frequencia_hz);
+    }
+    s_relogio_us = agora_us;
+}
+
+uint8_t metricas_total_canais(void)
+{
+    return 1;
+}
+
+uint32_t metricas_versao(uint8_t canal)
+{
+    return barramento_metricas_versao(&s_barramento, canal);
+}
+
+bool metricas_ler(uint8_t canal, uint32_t *versao, dados_medidos_t *destino)
+{
+    return canal == 0 && barramento_metricas_ler(&s_barramento, canal, versao, destino);
+}
+
+size_t metricas_ler_colunas_escopo(uint8_t canal, uint32_t *cursor, coluna_escopo_t *destino, size_t max)
+{
+    if (canal != 0) {
+        return 0;
+    }
+    return decimador_escopo_ler(&s_escopo, cursor, destino, max);
+}
+
+void metricas_definir_escopo_visivel(bool visivel)
+{
+    if (visivel && !s_escopo_visivel && s_proxima_publicacao_us > s_relogio_us) {
+        s_proxima_publicacao_us = s_relogio_us;
+    }
+    s_escopo_visivel = visivel;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Lado de metricas do simulador: implementa o que a UI usa de main/metricas.h
+ * (canal 0 so) com o nucleo de medicao real, o decimador do osciloscopio e o
+ * barramento, num relogio simulado. As bordas saem da frequencia pedida pelo
+ * roteiro; a publicacao segue o governador, como tarefa_metricas.
+ */
+void metricas_simuladas_inicializar(float curso_cm);
+void metricas_simuladas_definir_curso(float curso_cm);
+/* Gera as bordas ate agora_us na frequencia dada (0 = parado) e publica quando for a hora */
+void metricas_simuladas_avancar(int64_t agora_us, double frequencia_hz);
+uint32_t metricas_simuladas_publicacoes(void);
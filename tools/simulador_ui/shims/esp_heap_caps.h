@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MALLOC_CAP_8BIT      (1U << 2)
+#define MALLOC_CAP_SPIRAM    (1U << 10)
+#define MALLOC_CAP_INTERNAL  (1U << 11)
+#define MALLOC_CAP_DEFAULT   (1U << 12)
+
+/*
+ * Heap interno simulado: o pool do LVGL (lv_mem) mais as alocacoes internas
+ * de heap_caps, como no firmware, onde LVGL e heap_caps dividem o heap do
+ * sistema. Alocacoes so-PSRAM ficam de fora (malloc do host).
+ */
+void *heap_caps_malloc(size_t tamanho, uint32_t caps);
+void *heap_caps_calloc(size_t n, size_t tamanho, uint32_t caps);
+void heap_caps_free(void *ptr);
+size_t heap_caps_get_free_size(uint32_t caps);
+size_t heap_caps_get_minimum_free_size(uint32_t caps);
+size_t heap_caps_get_largest_free_block(uint32_t caps);
@@ -0,0 +1,3 @@
+#pragma once
+
+typedef struct esp_lcd_touch_s *esp_lcd_touch_handle_t;
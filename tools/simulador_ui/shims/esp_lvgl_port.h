@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "lvgl.h"
+
+/* Uma thread so no host: o lock sempre entra e o LVGL anda pelo laco do simulador */
+typedef enum {
+    LVGL_PORT_EVENT_DISPLAY = 0x01,
+    LVGL_PORT_EVENT_TOUCH = 0x02,
+    LVGL_PORT_EVENT_USER = 0x80,
+} lvgl_port_event_type_t;
+
+bool lvgl_port_lock(uint32_t timeout_ms);
+void lvgl_port_unlock(void);
+esp_err_t lvgl_port_stop(void);
+esp_err_t lvgl_port_resume(void);
+esp_err_t lvgl_port_task_wake(lvgl_port_event_type_t event, void *param);
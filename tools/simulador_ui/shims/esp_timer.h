@@ -0,0 +1,6 @@
+#pragma once
+
+#include <stdint.h>
+
+/* Relogio do roteiro mais o tempo real do passo (ver shims_host_definir_relogio) */
+int64_t esp_timer_get_time(void);
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "sdkconfig.h"
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE          0
+#define pdTRUE           1
+#define pdFAIL           0
+#define pdPASS           1
+#define portMAX_DELAY    UINT32_MAX
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+/* Secoes criticas viram nada: o simulador roda numa thread so */
+typedef struct {
+    int reservado;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {0}
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux)  ((void)(mux))
+
+BaseType_t xPortGetCoreID(void);
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+typedef uint32_t EventBits_t;
+typedef struct {
+    EventBits_t bits;
+} StaticEventGroup_t;
+typedef StaticEventGroup_t *EventGroupHandle_t;
+
+EventGroupHandle_t xEventGroupCreateStatic(StaticEventGroup_t *buffer);
+EventBits_t xEventGroupSetBits(EventGroupHandle_t grupo, EventBits_t bits);
+EventBits_t xEventGroupGetBits(EventGroupHandle_t grupo);
+/* Sem outra tarefa para marcar os bits: esperar por bits ausentes aborta */
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t grupo, EventBits_t bits, BaseType_t limpar, BaseType_t todos,
+                                TickType_t espera);
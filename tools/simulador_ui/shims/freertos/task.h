@@ -0,0 +1,11 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+typedef void (*TaskFunction_t)(void *param);
+typedef struct tarefa_host *TaskHandle_t;
+
+/* A tarefa roda ate o fim dentro da chamada; vTaskDelete(NULL) so retorna */
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t funcao, const char *nome, uint32_t pilha, void *param,
+                                   UBaseType_t prioridade, TaskHandle_t *tarefa, BaseType_t nucleo);
+void vTaskDelete(TaskHandle_t tarefa);
@@ -0,0 +1,14 @@
+#pragma once
+
+/*
+ * sdkconfig.h do host: as opcoes CONFIG_LV_* e CONFIG_CONTADOR_* vem do
+ * sdkconfig do firmware (sdkconfig_projeto.h, gerado pelo CMake), entao o
+ * LVGL do simulador tem as mesmas fontes, widgets e periodo de refresh. O
+ * CMake recusa um sdkconfig sem as opcoes do main/Kconfig.projbuild.
+ */
+#include "sdkconfig_projeto.h"
+
+/* Unica diferenca no LVGL: alocador proprio, para o heap poder ser medido */
+#undef CONFIG_LV_USE_CLIB_MALLOC
+#define CONFIG_LV_USE_BUILTIN_MALLOC 1
+#define CONFIG_LV_MEM_SIZE_KILOBYTES 2048
@@ -0,0 +1,308 @@
+/*
+ * Shims de host para o que a UI usa do ESP-IDF, do esp_lvgl_port e do
+ * FreeRTOS. Tudo roda numa thread so: o laco do simulador chama o
+ * lv_timer_handler, o lock do LVGL sempre entra e tarefas rodam ate o fim
+ * dentro de xTaskCreatePinnedToCore.
+ */
+#include "shims_host.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "display_driver.h"
+#include "esp_heap_caps.h"
+#include "esp_lvgl_port.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "lvgl.h"
+
+/* Cabecalho de cada alocacao de heap_caps: de onde veio, para liberar no lugar certo */
+typedef struct {
+    size_t tamanho;
+    bool interno;
+    max_align_t alinhamento;
+} bloco_heap_t;
+
+struct semaforo_host {
+    int reservado;
+};
+
+static uint16_t *s_quadro;
+static int32_t s_toque_x;
+static int32_t s_toque_y;
+static bool s_toque_pressionado;
+static size_t s_psram_bytes;
+static int64_t s_relogio_simulado_us;
+static int64_t s_relogio_real_us;
+static struct semaforo_host s_mutex;
+
+/* ---- display_driver ---- */
+
+/* Modo direto como no painel: o quadro fica inteiro no buffer e so as areas sujas sao redesenhadas */
+static void descartar_flush(lv_display_t *display, const lv_area_t *area, uint8_t *pixels)
+{
+    (void)area;
+    (void)pixels;
+    lv_display_flush_ready(display);
+}
+
+static void ler_toque(lv_indev_t *indev, lv_indev_data_t *dados)
+{
+    (void)indev;
+    dados->point.x = s_toque_x;
+    dados->point.y = s_toque_y;
+    dados->state = s_toque_pressionado ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+}
+
+esp_err_t display_driver_init(display_driver_t *driver)
+{
+    const size_t tamanho = (size_t)DISPLAY_H_RES * DISPLAY_V_RES * sizeof(uint16_t);
+    s_quadro = calloc(1, tamanho);
+    if (!s_quadro) {
+        return ESP_ERR_NO_MEM;
+    }
+    lv_display_t *display = lv_display_create(DISPLAY_H_RES, DISPLAY_V_RES);
+    lv_display_set_color_format(display, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_buffers(display, s_quadro, NULL, tamanho, LV_DISPLAY_RENDER_MODE_DIRECT);
+    lv_display_set_flush_cb(display, descartar_flush);
+
+    lv_indev_t *toque = lv_indev_create();
+    lv_indev_set_type(toque, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_read_cb(toque, ler_toque);
+    lv_indev_set_display(toque, display);
+
+    *driver = (display_driver_t){
+        .lvgl_display = display,
+        .touch_indev = toque,
+    };
+    return ESP_OK;
+}
+
+void display_driver_set_backlight(bool enabled)
+{
+    (void)enabled;
+}
+
+esp_err_t display_driver_restart_panel(display_driver_t *driver)
+{
+    (void)driver;
+    return ESP_OK;
+}
+
+void shims_host_tocar(int32_t x, int32_t y, bool pressionado)
+{
+    s_toque_x = x;
+    s_toque_y = y;
+    s_toque_pressionado = pressionado;
+}
+
+const uint16_t *shims_host_quadro(void)
+{
+    return s_quadro;
+}
+
+/* ---- esp_lvgl_port ---- */
+
+bool lvgl_port_lock(uint32_t timeout_ms)
+{
+    (void)timeout_ms;
+    return true;
+}
+
+void lvgl_port_unlock(void)
+{
+}
+
+esp_err_t lvgl_port_stop(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t lvgl_port_resume(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t lvgl_port_task_wake(lvgl_port_event_type_t event, void *param)
+{
+    (void)event;
+    (void)param;
+    return ESP_OK;
+}
+
+/* ---- esp_timer ---- */
+
+static int64_t relogio_real_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void shims_host_definir_relogio(int64_t simulado_us)
+{
+    s_relogio_simulado_us = simulado_us;
+    s_relogio_real_us = relogio_real_us();
+}
+
+/* Pode recuar se um passo levar mais que o passo simulado; diferencas dentro dele sao exatas */
+int64_t esp_timer_get_time(void)
+{
+    return s_relogio_simulado_us + (relogio_real_us() - s_relogio_real_us);
+}
+
+/* ---- esp_heap_caps ---- */
+
+void *heap_caps_malloc(size_t tamanho, uint32_t caps)
+{
+    const bool interno = (caps & MALLOC_CAP_SPIRAM) == 0;
+    const size_t total = offsetof(bloco_heap_t, alinhamento) + tamanho;
+    bloco_heap_t *bloco = interno ? lv_malloc(total) : malloc(total);
+    if (!bloco) {
+        return NULL;
+    }
+    bloco->tamanho = tamanho;
+    bloco->interno = interno;
+    if (!interno) {
+        s_psram_bytes += tamanho;
+    }
+    return &bloco->alinhamento;
+}
+
+void *heap_caps_calloc(size_t n, size_t tamanho, uint32_t caps)
+{
+    if (tamanho && n > SIZE_MAX / tamanho) {
+        return NULL;
+    }
+    void *ptr = heap_caps_malloc(n * tamanho, caps);
+    if (ptr) {
+        memset(ptr, 0, n * tamanho);
+    }
+    return ptr;
+}
+
+void heap_caps_free(void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+    bloco_heap_t *bloco = (bloco_heap_t *)((uint8_t *)ptr - offsetof(bloco_heap_t, alinhamento));
+    if (bloco->interno) {
+        lv_free(bloco);
+        return;
+    }
+    s_psram_bytes -= bloco->tamanho;
+    free(bloco);
+}
+
+size_t heap_caps_get_free_size(uint32_t caps)
+{
+    (void)caps;
+    lv_mem_monitor_t monitor;
+    lv_mem_monitor(&monitor);
+    return monitor.free_size;
+}
+
+size_t heap_caps_get_minimum_free_size(uint32_t caps)
+{
+    (void)caps;
+    lv_mem_monitor_t monitor;
+    lv_mem_monitor(&monitor);
+    return monitor.total_size - monitor.max_used;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+    (void)caps;
+    lv_mem_monitor_t monitor;
+    lv_mem_monitor(&monitor);
+    return monitor.free_biggest_size;
+}
+
+size_t shims_host_psram_bytes(void)
+{
+    return s_psram_bytes;
+}
+
+/* ---- FreeRTOS ---- */
+
+BaseType_t xPortGetCoreID(void)
+{
+    return 0;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t funcao, const char *nome, uint32_t pilha, void *param,
+                                   UBaseType_t prioridade, TaskHandle_t *tarefa, BaseType_t nucleo)
+{
+    (void)nome;
+    (void)pilha;
+    (void)prioridade;
+    (void)nucleo;
+    if (tarefa) {
+        *tarefa = NULL;
+    }
+    funcao(param);
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t tarefa)
+{
+    (void)tarefa;
+}
+
+EventGroupHandle_t xEventGroupCreateStatic(StaticEventGroup_t *buffer)
+{
+    buffer->bits = 0;
+    return buffer;
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t grupo, EventBits_t bits)
+{
+    grupo->bits |= bits;
+    return grupo->bits;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t grupo)
+{
+    return grupo->bits;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t grupo, EventBits_t bits, BaseType_t limpar, BaseType_t todos,
+                                TickType_t espera)
+{
+    (void)espera;
+    const EventBits_t presentes = grupo->bits & bits;
+    if (todos ? presentes != bits : presentes == 0) {
+        fprintf(stderr, "xEventGroupWaitBits: bits 0x%x nunca seriam marcados (so ha uma thread)\n",
+                (unsigned)bits);
+        abort();
+    }
+    const EventBits_t antes = grupo->bits;
+    if (limpar) {
+        grupo->bits &= ~bits;
+    }
+    return antes;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return &s_mutex;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaforo, TickType_t espera)
+{
+    (void)semaforo;
+    (void)espera;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaforo)
+{
+    (void)semaforo;
+    return pdTRUE;
+}
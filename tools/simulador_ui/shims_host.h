@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Controle dos shims pelo simulador: o toque que o indev do display le e o
+ * quadro RGB565 (DISPLAY_H_RES x DISPLAY_V_RES) que o LVGL desenha.
+ */
+void shims_host_tocar(int32_t x, int32_t y, bool pressionado);
+/*
+ * esp_timer_get_time() devolve o instante simulado dado aqui mais o tempo
+ * real gasto desde entao: duracoes medidas dentro de um passo (render,
+ * aplicacao) sao as do host e o resto do firmware ve o relogio do roteiro.
+ */
+void shims_host_definir_relogio(int64_t simulado_us);
+const uint16_t *shims_host_quadro(void);
+/* Alocacoes so-PSRAM vivas (fora do heap interno simulado) */
+size_t shims_host_psram_bytes(void);
@@ -0,0 +1,610 @@
+/*
+ * Simulador de host da UI: compila main/interface_usuario.c (e as telas que
+ * ela usa) contra o LVGL do projeto, com um display RGB565 em modo direto
+ * de 800x480 sem janela e shims no lugar do painel, do esp_lvgl_port e do
+ * FreeRTOS. Um roteiro com tempos em ms muda a frequencia do sinal (que passa
+ * pelo nucleo de medicao real) e toca a tela para navegar entre os modos.
+ * Sai um relatorio por vista com tempo de render por quadro, area
+ * invalidada e redesenhada e heap do LVGL.
+ *
+ *   cmake -S tools -B build-host && cmake --build build-host
+ *   ./build-host/simulador_ui/simulador_ui [roteiro.txt] [--csv quadros.csv] [--capturas dir]
+ *
+ * Roteiro, uma linha por comando (# comenta):
+ *   <ms> sinal <hz>               degrau de frequencia (0 = parado)
+ *   <ms> rampa <hz> <duracao_ms>  rampa linear ate hz
+ *   <ms> abrir <modo>             toca o card: frequencia rpm velocidade curso distancia furos
+ *   <ms> tendencia                toque longo na tela cheia: grafico de tendencia
+ *   <ms> toque                    toque curto na faixa do titulo (zoom da tendencia)
+ *   <ms> voltar                   toque duplo: tendencia -> tela cheia -> grid
+ *   <ms> fim
+ *
+ * O roteiro roda tao rapido quanto o host consegue; esp_timer segue o
+ * relogio do roteiro (ver shims_host.h). O tempo de render e o do host:
+ * serve para comparar mudancas, nao como numero do ESP32-S3. --capturas
+ * grava o ultimo quadro de cada vista em PPM.
+ */
+#include "interface_usuario.h"
+#include "metricas_simuladas.h"
+#include "partida.h"
+#include "shims_host.h"
+#include "tendencia.h"
+
+#include "display_driver.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "lvgl.h"
+#include "src/display/lv_display_private.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#define MAX_COMANDOS          256
+#define MAX_VISTAS            16
+#define MAX_TOQUES            4
+#define TOQUE_CURTO_MS        60
+#define INTERVALO_DUPLO_MS    100
+#define TOQUE_LONGO_MS        700
+#define FAIXA_TITULO_Y        24
+#define FOLGA_FINAL_MS        3000
+#define MODO_NENHUM           (-1)
+
+typedef enum {
+    COMANDO_SINAL = 0,
+    COMANDO_RAMPA,
+    COMANDO_ABRIR,
+    COMANDO_TENDENCIA,
+    COMANDO_TOQUE,
+    COMANDO_VOLTAR,
+    COMANDO_FIM,
+} comando_tipo_t;
+
+typedef struct {
+    uint32_t instante_ms;
+    comando_tipo_t tipo;
+    double hz;
+    uint32_t duracao_ms;
+    int modo;
+} comando_t;
+
+typedef struct {
+    uint32_t inicio_ms;
+    uint32_t fim_ms;
+    int32_t x;
+    int32_t y;
+} toque_t;
+
+typedef struct {
+    char nome[32];
+    uint32_t tempo_ms;
+    uint32_t quadros;
+    uint32_t *quadro_us;            /* um por quadro, para os percentis */
+    size_t capacidade;
+    uint32_t quadro_maximo_us;
+    uint64_t quadro_total_us;
+    uint64_t invalidado_total;
+    uint32_t invalidado_maximo;
+    uint64_t redesenhado_total;
+    uint32_t redesenhado_maximo;
+    size_t heap_maximo;
+    uint32_t objetos_maximo;
+    uint32_t aplicacoes;
+    uint64_t aplicacao_total_us;
+} vista_t;
+
+/* Mesma ordem de display_mode_t em main/interface_usuario.c */
+static const char *const s_modos[] = {"frequencia", "rpm", "velocidade", "curso", "distancia", "furos"};
+#define TOTAL_MODOS ((int)(sizeof(s_modos) / sizeof(s_modos[0])))
+
+static const char ROTEIRO_PADRAO[] =
+    "# Cada modo com o sinal em rampa, a tendencia e a volta ao grid parado\n"
+    "0      sinal 0\n"
+    "300    sinal 25\n"
+    "2000   rampa 140 3000\n"
+    "5000   abrir frequencia\n"
+    "6000   rampa 40 3000\n"
+    "10000  voltar\n"
+    "10500  abrir rpm\n"
+    "11000  rampa 90 2500\n"
+    "14000  voltar\n"
+    "14500  abrir velocidade\n"
+    "15000  rampa 30 2500\n"
+    "18000  voltar\n"
+    "18500  abrir curso\n"
+    "21500  voltar\n"
+    "22000  abrir distancia\n"
+    "22500  rampa 120 2500\n"
+    "25500  voltar\n"
+    "26000  abrir furos\n"
+    "26500  rampa 60 2500\n"
+    "29500  voltar\n"
+    "30000  abrir frequencia\n"
+    "31000  tendencia\n"
+    "33000  toque\n"
+    "35000  voltar\n"
+    "36000  voltar\n"
+    "36500  sinal 0\n"
+    "40000  fim\n";
+
+static comando_t s_comandos[MAX_COMANDOS];
+static size_t s_total_comandos;
+static vista_t s_vistas[MAX_VISTAS];
+static size_t s_total_vistas;
+static vista_t *s_vista;
+static toque_t s_toques[MAX_TOQUES];
+static size_t s_total_toques;
+
+static lv_display_t *s_display;
+static uint32_t s_agora_ms;
+static int s_modo_aberto = MODO_NENHUM;
+static bool s_tendencia_aberta;
+static uint32_t s_redesenhado_quadro;
+static uint64_t s_pixels_anterior;
+static uint32_t s_atualizacoes_anterior;
+static uint64_t s_aplicacao_anterior_us;
+static uint32_t s_capturas;
+static const char *s_dir_capturas;
+static FILE *s_csv;
+
+/* Frequencia do sinal: degrau ou rampa linear */
+static double s_hz_origem;
+static double s_hz_alvo;
+static uint32_t s_rampa_inicio_ms;
+static uint32_t s_rampa_duracao_ms;
+
+static int procurar_modo(const char *nome)
+{
+    for (int i = 0; i < TOTAL_MODOS; i++) {
+        if (strcmp(nome, s_modos[i]) == 0) {
+            return i;
+        }
+    }
+    return MODO_NENHUM;
+}
+
+static int carregar_roteiro(FILE *arquivo, const char *nome)
+{
+    char linha[160];
+    unsigned numero = 0;
+    uint32_t anterior_ms = 0;
+    while (fgets(linha, sizeof(linha), arquivo)) {
+        numero++;
+        char *comentario = strchr(linha, '#');
+        if (comentario) {
+            *comentario = '\0';
+        }
+        uint32_t instante_ms;
+        char verbo[16];
+        char argumento[32] = "";
+        double valor = 0.0;
+        uint32_t duracao_ms = 0;
+        const int campos = sscanf(linha, "%" SCNu32 " %15s %31s %" SCNu32, &instante_ms, verbo, argumento, &duracao_ms);
+        if (campos <= 0) {
+            continue;
+        }
+        if (campos < 2 || instante_ms < anterior_ms || s_total_comandos == MAX_COMANDOS) {
+            fprintf(stderr, "%s:%u: comando invalido ou fora de ordem\n", nome, numero);
+            return -1;
+        }
+        comando_t comando = {.instante_ms = instante_ms, .modo = MODO_NENHUM};
+        if (strcmp(verbo, "sinal") == 0 && campos >= 3 && sscanf(argumento, "%lf", &valor) == 1) {
+            comando.tipo = COMANDO_SINAL;
+            comando.hz = valor;
+        } else if (strcmp(verbo, "rampa") == 0 && campos == 4 && sscanf(argumento, "%lf", &valor) == 1) {
+            comando.tipo = COMANDO_RAMPA;
+            comando.hz = valor;
+            comando.duracao_ms = duracao_ms;
+        } else if (strcmp(verbo, "abrir") == 0 && campos >= 3 && procurar_modo(argumento) != MODO_NENHUM) {
+            comando.tipo = COMANDO_ABRIR;
+            comando.modo = procurar_modo(argumento);
+        } else if (strcmp(verbo, "tendencia") == 0) {
+            comando.tipo = COMANDO_TENDENCIA;
+        } else if (strcmp(verbo, "toque") == 0) {
+            comando.tipo = COMANDO_TOQUE;
+        } else if (strcmp(verbo, "voltar") == 0) {
+            comando.tipo = COMANDO_VOLTAR;
+        } else if (strcmp(verbo, "fim") == 0) {
+            comando.tipo = COMANDO_FIM;
+        } else {
+            fprintf(stderr, "%s:%u: comando desconhecido '%s'\n", nome, numero, verbo);
+            return -1;
+        }
+        if (comando.hz < 0.0) {
+            fprintf(stderr, "%s:%u: frequencia negativa\n", nome, numero);
+            return -1;
+        }
+        s_comandos[s_total_comandos++] = comando;
+        anterior_ms = instante_ms;
+    }
+    return s_total_comandos > 0 ? 0 : -1;
+}
+
+static double frequencia_atual(void)
+{
+    const uint32_t decorrido_ms = s_agora_ms - s_rampa_inicio_ms;
+    if (decorrido_ms >= s_rampa_duracao_ms) {
+        return s_hz_alvo;
+    }
+    return s_hz_origem + (s_hz_alvo - s_hz_origem) * decorrido_ms / s_rampa_duracao_ms;
+}
+
+static void definir_frequencia(double hz, uint32_t duracao_ms)
+{
+    s_hz_origem = frequencia_atual();
+    s_hz_alvo = hz;
+    s_rampa_inicio_ms = s_agora_ms;
+    s_rampa_duracao_ms = duracao_ms;
+}
+
+static void agendar_toque(int32_t x, int32_t y, uint32_t atraso_ms, uint32_t duracao_ms)
+{
+    if (s_total_toques == MAX_TOQUES) {
+        return;
+    }
+    s_toques[s_total_toques++] = (toque_t){
+        .inicio_ms = s_agora_ms + atraso_ms,
+        .fim_ms = s_agora_ms + atraso_ms + duracao_ms,
+        .x = x,
+        .y = y,
+    };
+}
+
+/* O indev le o estado no proprio periodo; o toque fica pressionado durante a janela */
+static void atualizar_toques(void)
+{
+    size_t ativos = 0;
+    const toque_t *pressionado = NULL;
+    for (size_t i = 0; i < s_total_toques; i++) {
+        if (s_toques[i].fim_ms <= s_agora_ms) {
+            shims_host_tocar(s_toques[i].x, s_toques[i].y, false);
+            continue;
+        }
+        s_toques[ativos++] = s_toques[i];
+    }
+    s_total_toques = ativos;
+    for (size_t i = 0; i < s_total_toques; i++) {
+        if (s_toques[i].inicio_ms <= s_agora_ms) {
+            pressionado = &s_toques[i];
+            break;
+        }
+    }
+    if (pressionado) {
+        shims_host_tocar(pressionado->x, pressionado->y, true);
+    }
+}
+
+static void escrever_ppm(const char *caminho)
+{
+    FILE *arquivo = fopen(caminho, "wb");
+    if (!arquivo) {
+        perror(caminho);
+        return;
+    }
+    fprintf(arquivo, "P6\n%d %d\n255\n", DISPLAY_H_RES, DISPLAY_V_RES);
+    const uint16_t *quadro = shims_host_quadro();
+    for (size_t i = 0; i < (size_t)DISPLAY_H_RES * DISPLAY_V_RES; i++) {
+        const uint16_t p = quadro[i];
+        const uint8_t rgb[3] = {
+            (uint8_t)(((p >> 11) & 0x1F) * 255 / 31),
+            (uint8_t)(((p >> 5) & 0x3F) * 255 / 63),
+            (uint8_t)((p & 0x1F) * 255 / 31),
+        };
+        fwrite(rgb, 1, sizeof(rgb), arquivo);
+    }
+    fclose(arquivo);
+}
+
+/* Ultimo quadro da vista que sai */
+static void capturar(void)
+{
+    if (!s_dir_capturas || !s_vista) {
+        return;
+    }
+    char caminho[512];
+    snprintf(caminho, sizeof(caminho), "%s/%02" PRIu32 "_%s.ppm", s_dir_capturas, s_capturas++, s_vista->nome);
+    escrever_ppm(caminho);
+}
+
+static void mudar_vista(const char *nome)
+{
+    capturar();
+    for (size_t i = 0; i < s_total_vistas; i++) {
+        if (strcmp(s_vistas[i].nome, nome) == 0) {
+            s_vista = &s_vistas[i];
+            return;
+        }
+    }
+    if (s_total_vistas == MAX_VISTAS) {
+        return;
+    }
+    s_vista = &s_vistas[s_total_vistas++];
+    snprintf(s_vista->nome, sizeof(s_vista->nome), "%s", nome);
+}
+
+static void executar(const comando_t *comando)
+{
+    const int32_t centro_x = DISPLAY_H_RES / 2;
+    char nome[32];
+    switch (comando->tipo) {
+    case COMANDO_SINAL:
+        definir_frequencia(comando->hz, 0);
+        break;
+    case COMANDO_RAMPA:
+        definir_frequencia(comando->hz, comando->duracao_ms);
+        break;
+    case COMANDO_ABRIR: {
+        if (s_modo_aberto != MODO_NENHUM) {
+            fprintf(stderr, "%" PRIu32 " ms: abrir fora do grid, ignorado\n", comando->instante_ms);
+            break;
+        }
+        /* O grid e o primeiro filho da tela e os cards estao na ordem dos modos */
+        lv_obj_t *grid = lv_obj_get_child(lv_screen_active(), 0);
+        lv_obj_t *card = grid ? lv_obj_get_child(grid, comando->modo) : NULL;
+        if (!card) {
+            break;
+        }
+        lv_area_t area;
+        lv_obj_get_coords(card, &area);
+        agendar_toque((area.x1 + area.x2) / 2, (area.y1 + area.y2) / 2, 0, TOQUE_CURTO_MS);
+        s_modo_aberto = comando->modo;
+        mudar_vista(s_modos[comando->modo]);
+        break;
+    }
+    case COMANDO_TENDENCIA:
+        if (s_modo_aberto == MODO_NENHUM || s_tendencia_aberta || strcmp(s_modos[s_modo_aberto], "curso") == 0) {
+            fprintf(stderr, "%" PRIu32 " ms: tendencia so a partir da tela cheia, ignorado\n", comando->instante_ms);
+            break;
+        }
+        agendar_toque(centro_x, FAIXA_TITULO_Y, 0, TOQUE_LONGO_MS);
+        s_tendencia_aberta = true;
+        snprintf(nome, sizeof(nome), "tendencia-%s", s_modos[s_modo_aberto]);
+        mudar_vista(nome);
+        break;
+    case COMANDO_TOQUE:
+        agendar_toque(centro_x, FAIXA_TITULO_Y, 0, TOQUE_CURTO_MS);
+        break;
+    case COMANDO_VOLTAR:
+        if (s_modo_aberto == MODO_NENHUM) {
+            break;
+        }
+        agendar_toque(centro_x, FAIXA_TITULO_Y, 0, TOQUE_CURTO_MS);
+        agendar_toque(centro_x, FAIXA_TITULO_Y, TOQUE_CURTO_MS + INTERVALO_DUPLO_MS, TOQUE_CURTO_MS);
+        if (s_tendencia_aberta) {
+            s_tendencia_aberta = false;
+            mudar_vista(s_modos[s_modo_aberto]);
+        } else {
+            s_modo_aberto = MODO_NENHUM;
+            mudar_vista("grid");
+        }
+        break;
+    case COMANDO_FIM:
+        break;
+    }
+}
+
+/* Area que o LVGL vai redesenhar de fato: as areas sujas depois de juntadas */
+static void ao_iniciar_render(lv_event_t *evento)
+{
+    (void)evento;
+    uint32_t pixels = 0;
+    for (uint32_t i = 0; i < s_display->inv_p; i++) {
+        if (!s_display->inv_area_joined[i]) {
+            pixels += lv_area_get_size(&s_display->inv_areas[i]);
+        }
+    }
+    s_redesenhado_quadro = pixels;
+}
+
+/* Registrado depois do da UI: o diagnostico ja tem o tempo deste quadro */
+static void ao_concluir_render(lv_event_t *evento)
+{
+    (void)evento;
+    vista_t *vista = s_vista;
+    interface_usuario_diagnostico_t diagnostico;
+    interface_usuario_obter_diagnostico(&diagnostico);
+    lv_mem_monitor_t monitor;
+    lv_mem_monitor(&monitor);
+    const size_t heap_usado = monitor.total_size - monitor.free_size;
+    const uint32_t invalidado = (uint32_t)(diagnostico.pixels_total - s_pixels_anterior);
+    s_pixels_anterior = diagnostico.pixels_total;
+
+    if (vista->quadros == vista->capacidade) {
+        vista->capacidade = vista->capacidade ? vista->capacidade * 2U : 256U;
+        vista->quadro_us = realloc(vista->quadro_us, vista->capacidade * sizeof(*vista->quadro_us));
+        if (!vista->quadro_us) {
+            fprintf(stderr, "sem memoria\n");
+            exit(1);
+        }
+    }
+    const uint32_t quadro_us = diagnostico.quadro_ultimo_us;
+    vista->quadro_us[vista->quadros++] = quadro_us;
+    vista->quadro_total_us += quadro_us;
+    if (quadro_us > vista->quadro_maximo_us) {
+        vista->quadro_maximo_us = quadro_us;
+    }
+    vista->invalidado_total += invalidado;
+    if (invalidado > vista->invalidado_maximo) {
+        vista->invalidado_maximo = invalidado;
+    }
+    vista->redesenhado_total += s_redesenhado_quadro;
+    if (s_redesenhado_quadro > vista->redesenhado_maximo) {
+        vista->redesenhado_maximo = s_redesenhado_quadro;
+    }
+    if (heap_usado > vista->heap_maximo) {
+        vista->heap_maximo = heap_usado;
+    }
+    if (diagnostico.objetos > vista->objetos_maximo) {
+        vista->objetos_maximo = diagnostico.objetos;
+    }
+    vista->aplicacoes += diagnostico.atualizacoes - s_atualizacoes_anterior;
+    vista->aplicacao_total_us += diagnostico.tempo_total_us - s_aplicacao_anterior_us;
+    s_atualizacoes_anterior = diagnostico.atualizacoes;
+    s_aplicacao_anterior_us = diagnostico.tempo_total_us;
+
+    if (s_csv) {
+        fprintf(s_csv, "%" PRIu32 ",%s,%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%zu,%" PRIu32 "\n", s_agora_ms,
+                vista->nome, quadro_us, invalidado, s_redesenhado_quadro, heap_usado, diagnostico.objetos);
+    }
+}
+
+static void salvar_curso(float novo_curso_cm)
+{
+    metricas_simuladas_definir_curso(novo_curso_cm);
+}
+
+static int comparar_u32(const void *a, const void *b)
+{
+    const uint32_t x = *(const uint32_t *)a;
+    const uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static uint32_t percentil(const vista_t *vista, uint32_t por_cento)
+{
+    if (vista->quadros == 0) {
+        return 0;
+    }
+    /* Posto mais proximo: com poucos quadros o p95 e o maximo */
+    return vista->quadro_us[((uint64_t)vista->quadros * por_cento + 99U) / 100U - 1U];
+}
+
+static void relatar(const char *roteiro, double real_s)
+{
+    const uint32_t area = DISPLAY_H_RES * DISPLAY_V_RES;
+    interface_usuario_diagnostico_t diagnostico;
+    interface_usuario_obter_diagnostico(&diagnostico);
+    lv_mem_monitor_t monitor;
+    lv_mem_monitor(&monitor);
+
+    printf("Simulador da UI: %dx%d RGB565 modo direto, roteiro %s\n", DISPLAY_H_RES, DISPLAY_V_RES, roteiro);
+    printf("%.1f s simulados em %.1f s, %" PRIu32 " publicacoes de metricas\n\n", s_agora_ms / 1000.0, real_s,
+           metricas_simuladas_publicacoes());
+    printf("%-22s %7s %7s | %8s %8s %8s | %9s %9s | %9s %9s | %8s %7s | %9s\n", "vista", "tempo_s", "quadros",
+           "med_us", "p95_us", "max_us", "inval_px", "inval_max", "redes_px", "redes_max", "heap_KB", "objetos",
+           "aplic_us");
+    for (size_t i = 0; i < s_total_vistas; i++) {
+        vista_t *vista = &s_vistas[i];
+        qsort(vista->quadro_us, vista->quadros, sizeof(*vista->quadro_us), comparar_u32);
+        const uint32_t quadros = vista->quadros ? vista->quadros : 1U;
+        const uint32_t aplicacoes = vista->aplicacoes ? vista->aplicacoes : 1U;
+        printf("%-22s %7.1f %7" PRIu32 " | %8" PRIu64 " %8" PRIu32 " %8" PRIu32 " | %9" PRIu64 " %9" PRIu32
+               " | %9" PRIu64 " %9" PRIu32 " | %8.1f %7" PRIu32 " | %9" PRIu64 "\n",
+               vista->nome, vista->tempo_ms / 1000.0, vista->quadros, vista->quadro_total_us / quadros,
+               percentil(vista, 95), vista->quadro_maximo_us, vista->invalidado_total / quadros,
+               vista->invalidado_maximo, vista->redesenhado_total / quadros, vista->redesenhado_maximo,
+               vista->heap_maximo / 1024.0, vista->objetos_maximo, vista->aplicacao_total_us / aplicacoes);
+    }
+    printf("\nPor quadro: render do LVGL (RENDER_START a READY) e pixels; inval = areas pedidas (teto),\n");
+    printf("redes = areas redesenhadas depois de juntadas (tela cheia = %" PRIu32 " px). heap_KB = maximo do\n", area);
+    printf("pool do LVGL + heap_caps interno; aplic_us = aplicacao media de uma medicao nos widgets.\n\n");
+    printf("Heap da UI no boot: %" PRIu32 " bytes; pico do pool: %zu bytes; PSRAM (tendencia): %zu bytes\n",
+           diagnostico.heap_ui_bytes, (size_t)monitor.max_used, shims_host_psram_bytes());
+    printf("Subarvores: %" PRIu32 " montadas (%" PRIu32 " bytes), %" PRIu32 " construidas, %" PRIu32
+           " liberadas; %" PRIu32 " publicacoes agrupadas\n",
+           diagnostico.subarvores_montadas, diagnostico.subarvores_bytes, diagnostico.subarvores_construidas,
+           diagnostico.subarvores_liberadas, diagnostico.publicacoes_agrupadas);
+}
+
+static double agora_real_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv)
+{
+    const char *roteiro = NULL;
+    const char *caminho_csv = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            caminho_csv = argv[++i];
+        } else if (strcmp(argv[i], "--capturas") == 0 && i + 1 < argc) {
+            s_dir_capturas = argv[++i];
+        } else if (argv[i][0] != '-' && !roteiro) {
+            roteiro = argv[i];
+        } else {
+            fprintf(stderr, "uso: %s [roteiro.txt] [--csv quadros.csv] [--capturas dir]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    FILE *arquivo = roteiro ? fopen(roteiro, "r") : fmemopen((void *)ROTEIRO_PADRAO, strlen(ROTEIRO_PADRAO), "r");
+    if (!arquivo) {
+        perror(roteiro ? roteiro : "roteiro padrao");
+        return 1;
+    }
+    const int carregado = carregar_roteiro(arquivo, roteiro ? roteiro : "roteiro padrao");
+    fclose(arquivo);
+    if (carregado != 0) {
+        return 1;
+    }
+    if (s_dir_capturas && mkdir(s_dir_capturas, 0755) != 0 && errno != EEXIST) {
+        perror(s_dir_capturas);
+        return 1;
+    }
+    if (caminho_csv) {
+        s_csv = fopen(caminho_csv, "w");
+        if (!s_csv) {
+            perror(caminho_csv);
+            return 1;
+        }
+        fprintf(s_csv, "ms,vista,quadro_us,invalidado_px,redesenhado_px,heap_bytes,objetos\n");
+    }
+
+    /* Mesma ordem de app_main, com a configuracao ja carregada: a tarefa da UI roda inteira aqui */
+    static configuracao_curso_t configuracao = {.curso_cm = CURSO_MAX_CM * 0.7f};
+    const ui_callbacks_t callbacks = {.ao_solicitar_salvar_curso = salvar_curso};
+    shims_host_definir_relogio(0);
+    lv_init();
+    partida_inicializar();
+    partida_marcar(PARTIDA_CONFIGURACAO);
+    mudar_vista("partida");
+    if (interface_usuario_inicializar(&configuracao, &callbacks) != ESP_OK || !partida_concluida(PARTIDA_UI)) {
+        fprintf(stderr, "falha ao montar a UI\n");
+        return 1;
+    }
+    if (tendencia_inicializar() != ESP_OK) {
+        fprintf(stderr, "tendencia indisponivel\n");
+    }
+    metricas_simuladas_inicializar(configuracao.curso_cm);
+    partida_marcar(PARTIDA_METRICAS);
+
+    s_display = lv_display_get_default();
+    lv_display_add_event_cb(s_display, ao_iniciar_render, LV_EVENT_RENDER_START, NULL);
+    lv_display_add_event_cb(s_display, ao_concluir_render, LV_EVENT_RENDER_READY, NULL);
+
+    const comando_t *ultimo = &s_comandos[s_total_comandos - 1U];
+    const uint32_t fim_ms = ultimo->instante_ms + (ultimo->tipo == COMANDO_FIM ? 0U : FOLGA_FINAL_MS);
+    size_t proximo = 0;
+    const double inicio_s = agora_real_s();
+    for (s_agora_ms = 0; s_agora_ms < fim_ms; s_agora_ms++) {
+        while (proximo < s_total_comandos && s_comandos[proximo].instante_ms <= s_agora_ms) {
+            executar(&s_comandos[proximo++]);
+        }
+        if (strcmp(s_vista->nome, "partida") == 0 && partida_concluida(PARTIDA_SPLASH_FECHADA)) {
+            mudar_vista("grid");
+        }
+        const int64_t agora_us = (int64_t)s_agora_ms * 1000;
+        shims_host_definir_relogio(agora_us);
+        atualizar_toques();
+        metricas_simuladas_avancar(agora_us, frequencia_atual());
+        lv_tick_inc(1);
+        lv_timer_handler();
+        s_vista->tempo_ms++;
+    }
+    capturar();
+    const double real_s = agora_real_s() - inicio_s;
+
+    relatar(roteiro ? roteiro : "padrao", real_s);
+    if (s_csv) {
+        fclose(s_csv);
+    }
+    return 0;
+}
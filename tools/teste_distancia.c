@@ -0,0 +1,142 @@
+/*
+ * Teste de host da distancia exata do nucleo_medicao: 10^8 bordas a 1 kHz
+ * (pouco mais de 27 h de sinal continuo) com trocas de curso no meio, uma
+ * publicacao a cada 100 ms como a tarefa de metricas. A distancia publicada
+ * tem que ser exatamente a soma de furos x curso de cada trecho, em toda
+ * publicacao e no resumo da sessao; velocidade e RPM seguem a frequencia em
+ * Q16.16 sem arredondar duas vezes.
+ *
+ *   cmake -S tools -B build-host && cmake --build build-host
+ *   ./build-host/teste_distancia [bordas]
+ *
+ * Para comparacao sai tambem a deriva de uma soma em float por borda (o
+ * metodo anterior). Sai com 1 na primeira divergencia.
+ */
+#include "nucleo_medicao.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BORDAS_PADRAO        100000000ULL
+#define PERIODO_US           1000      /* 1 kHz exato */
+#define PUBLICACAO_US        100000
+#define PERIODO_MAXIMO_US    1000000
+#define PERIODOS_MINIMOS     4
+#define INICIO_US            1000000
+#define TROCAS_CURSO         10U
+
+/* Dentro de CURSO_MIN_MM..CURSO_MAX_MM; em metros nenhum e exato em float */
+static const uint32_t s_cursos_um[] = {1234U, 1000U, 4999U, 3333U, 2500U, 1777U, 4321U, 2999U, 3141U, 5000U};
+
+static int64_t relogio_simulado(void *contexto)
+{
+    return *(const int64_t *)contexto;
+}
+
+static bool conferir_u64(const char *nome, uint64_t obtido, uint64_t esperado)
+{
+    if (obtido != esperado) {
+        fprintf(stderr, "%s: %" PRIu64 ", esperado %" PRIu64 "\n", nome, obtido, esperado);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    const uint64_t bordas = argc > 1 ? strtoull(argv[1], NULL, 10) : BORDAS_PADRAO;
+    if (bordas < TROCAS_CURSO || bordas > UINT32_MAX) {
+        fprintf(stderr, "uso: %s [bordas] (%u..%" PRIu32 ")\n", argv[0], TROCAS_CURSO, UINT32_MAX);
+        return 2;
+    }
+
+    static nucleo_medicao_t nucleo;
+    int64_t relogio_us = INICIO_US;
+    const nucleo_medicao_config_t config = {
+        .sessao = {.tempo_pausa_ms = SESSAO_PAUSA_PADRAO_MS, .tempo_encerrar_ms = SESSAO_ENCERRAR_PADRAO_MS},
+        .periodo_maximo_us = PERIODO_MAXIMO_US,
+        .periodos_minimos = PERIODOS_MINIMOS,
+        .relogio = relogio_simulado,
+        .contexto_relogio = &relogio_us,
+    };
+    nucleo_medicao_inicializar(&nucleo, &config);
+
+    /* Referencia independente: o teste conta as proprias bordas por trecho */
+    uint64_t distancia_fechada_um = 0;
+    uint64_t furos_inicio_trecho = 0;
+    uint32_t curso_um = s_cursos_um[0];
+    nucleo_medicao_definir_curso_um(&nucleo, curso_um);
+    float distancia_float_m = 0.0f;
+
+    const uint64_t bordas_por_trecho = bordas / TROCAS_CURSO;
+    const uint32_t frequencia_q16 = (uint32_t)((1000000ULL << 16) / PERIODO_US);
+    int64_t proxima_publicacao_us = INICIO_US + PUBLICACAO_US;
+    uint64_t publicacoes = 0;
+    bool ok = true;
+    dados_medidos_t medicao;
+
+    for (uint64_t i = 0; i < bordas && ok; i++) {
+        const int64_t borda_us = INICIO_US + (int64_t)i * PERIODO_US;
+        while (proxima_publicacao_us <= borda_us && ok) {
+            relogio_us = proxima_publicacao_us;
+            uint32_t proximo_curso_um = curso_um;
+            if (i / bordas_por_trecho > furos_inicio_trecho / bordas_por_trecho &&
+                i / bordas_por_trecho < TROCAS_CURSO) {
+                /* O curso novo vale a partir desta publicacao: fecha o trecho com os furos de agora */
+                proximo_curso_um = s_cursos_um[i / bordas_por_trecho];
+                nucleo_medicao_definir_curso_um(&nucleo, proximo_curso_um);
+            }
+            nucleo_medicao_publicar(&nucleo, &medicao);
+            if (proximo_curso_um != curso_um) {
+                distancia_fechada_um += (i - furos_inicio_trecho) * curso_um;
+                furos_inicio_trecho = i;
+                curso_um = proximo_curso_um;
+            }
+            const uint64_t esperado_um = distancia_fechada_um + (i - furos_inicio_trecho) * curso_um;
+            ok &= conferir_u64("furos", medicao.furos, i);
+            ok &= conferir_u64("distancia_um", medicao.distancia_um, esperado_um);
+            if (publicacoes > 0) {
+                /* Janelas de 100 bordas exatas: frequencia e derivadas exatas em Q16.16 */
+                ok &= conferir_u64("frequencia_q16", medicao.frequencia_q16, frequencia_q16);
+                ok &= conferir_u64("rpm_q16", medicao.rpm_q16, (uint64_t)frequencia_q16 * 60U);
+                ok &= conferir_u64("velocidade_q16", medicao.velocidade_q16,
+                                   ((uint64_t)frequencia_q16 * curso_um) / UM_POR_CM);
+            }
+            publicacoes++;
+            proxima_publicacao_us += PUBLICACAO_US;
+        }
+        relogio_us = borda_us;
+        nucleo_medicao_registrar_borda(&nucleo, borda_us);
+        distancia_float_m += (float)curso_um / 1e6f;
+    }
+
+    /* Para o sinal e deixa a sessao encerrar: o resumo usa os mesmos acumuladores */
+    const int64_t ultima_borda_us = INICIO_US + (int64_t)(bordas - 1U) * PERIODO_US;
+    const uint64_t distancia_final_um = distancia_fechada_um + (bordas - furos_inicio_trecho) * curso_um;
+    resumo_sessao_t resumo = {0};
+    while (ok && !nucleo_medicao_retirar_resumo(&nucleo, &resumo)) {
+        relogio_us = proxima_publicacao_us;
+        nucleo_medicao_publicar(&nucleo, &medicao);
+        ok &= conferir_u64("distancia_um parado", medicao.distancia_um, distancia_final_um);
+        proxima_publicacao_us += PUBLICACAO_US;
+    }
+    if (ok) {
+        ok &= conferir_u64("resumo.furos", resumo.furos, bordas);
+        ok &= conferir_u64("resumo.distancia_um", resumo.distancia_um, distancia_final_um);
+        /* Periodos ativos / tempo ativo em ms, arredondado: 60000 rpm exatos a 1 kHz */
+        const uint64_t tempo_ms = (uint64_t)(ultima_borda_us / 1000 - INICIO_US / 1000);
+        const uint64_t rpm_esperado_q16 = ((bordas - 1U) * (60000ULL << 16) + tempo_ms / 2U) / tempo_ms;
+        ok &= conferir_u64("resumo.rpm_medio_q16", resumo.rpm_medio_q16, rpm_esperado_q16);
+    }
+
+    const double exata_m = (double)distancia_final_um / 1e6;
+    printf("bordas: %" PRIu64 " em %.1f h de sinal, %" PRIu64 " publicacoes, %u trechos de curso\n", bordas,
+           (double)(ultima_borda_us - INICIO_US) / 3.6e9, publicacoes, TROCAS_CURSO);
+    printf("distancia exata: %" PRIu64 " um (%.6f m)\n", distancia_final_um, exata_m);
+    printf("soma em float por borda: %.6f m (deriva de %+.3f m)\n", (double)distancia_float_m,
+           (double)distancia_float_m - exata_m);
+    printf("RPM medio do resumo: %.4f\n", q16_para_float(resumo.rpm_medio_q16));
+    printf("%s\n", ok ? "ok" : "FALHA");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,271 @@
+/*
+ * Teste de host do estimador_frequencia contra traces sinteticos com verdade
+ * conhecida. As bordas sao geradas em tempo real (double), arredondadas para
+ * us como o esp_timer e entregues em janelas de INTERVALO_RAPIDO_MS, como a
+ * tarefa de metricas faz.
+ *
+ *   cmake -S tools -B build-host && cmake --build build-host
+ *   ./build-host/teste_estimador_frequencia
+ *
+ * Cenarios:
+ *   - taxa constante: erro limitado pela quantizacao de 1 us nas pontas;
+ *   - jitter limitado (+-J us por borda, sem acumular): erro <= (2J + 1) / duracao;
+ *   - rampa linear: a media de periodos/duracao e exatamente a frequencia no
+ *     meio da janela, entao a verdade e f(meio) com a mesma tolerancia;
+ *   - abaixo de periodos_minimos: cai para o ultimo periodo e mantem o valor
+ *     em janelas sem periodo; uma pausa maior que periodo_maximo_us zera;
+ *   - acima de 65535.99 Hz (fora do Q16.16 de 32 bits): satura em UINT32_MAX
+ *     pela janela e pelo ultimo periodo, sem dar a volta.
+ * Sai com 1 se algum cenario passar da tolerancia.
+ */
+#include "estimador_frequencia.h"
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#define INTERVALO_JANELA_US   33000.0   /* INTERVALO_RAPIDO_MS das metricas */
+#define PERIODOS_MINIMOS      4U        /* PERIODOS_MINIMOS_JANELA */
+#define PERIODO_MAXIMO_US     1000000U
+#define ORIGEM_US             1000000.0 /* o estimador trata 0 como "sem borda" */
+#define DURACAO_US            60000000.0
+#define Q16_HZ                65536.0
+#define TOLERANCIA_Q16        2.0       /* arredondamento do Q16.16 */
+
+typedef struct {
+    const char *nome;
+    double (*borda_us)(const void *parametros, uint64_t indice);  /* tempo real da borda */
+    double (*frequencia_hz)(const void *parametros, double t_us); /* verdade instantanea */
+    const void *parametros;
+    double jitter_us;
+} cenario_t;
+
+typedef struct {
+    double frequencia_hz;
+    double jitter_us;
+} constante_t;
+
+typedef struct {
+    double inicial_hz;
+    double aceleracao_hz_s;
+} rampa_t;
+
+static double jitter(uint64_t indice, double amplitude_us)
+{
+    /* Deterministico por borda: reproduzivel e sem acumular entre bordas */
+    uint64_t x = indice * 0x9E3779B97F4A7C15ULL;
+    x ^= x >> 31;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 29;
+    return amplitude_us * ((double)(x >> 11) / (double)(1ULL << 53) * 2.0 - 1.0);
+}
+
+static double borda_constante(const void *parametros, uint64_t indice)
+{
+    const constante_t *c = parametros;
+    return ORIGEM_US + (double)indice * 1e6 / c->frequencia_hz + jitter(indice, c->jitter_us);
+}
+
+static double frequencia_constante(const void *parametros, double t_us)
+{
+    (void)t_us;
+    return ((const constante_t *)parametros)->frequencia_hz;
+}
+
+static double borda_rampa(const void *parametros, uint64_t indice)
+{
+    /* Fase f0*t + a*t^2/2 = indice */
+    const rampa_t *r = parametros;
+    const double a = r->aceleracao_hz_s;
+    const double t_s = (sqrt(r->inicial_hz * r->inicial_hz + 2.0 * a * (double)indice) - r->inicial_hz) / a;
+    return ORIGEM_US + t_s * 1e6;
+}
+
+static double frequencia_rampa(const void *parametros, double t_us)
+{
+    const rampa_t *r = parametros;
+    return r->inicial_hz + r->aceleracao_hz_s * (t_us - ORIGEM_US) / 1e6;
+}
+
+/* Confere as janelas com periodos suficientes; false se alguma passou da tolerancia */
+static bool rodar_cenario(const cenario_t *cenario)
+{
+    const estimador_frequencia_config_t config = {
+        .periodos_minimos = PERIODOS_MINIMOS,
+        .periodo_maximo_us = PERIODO_MAXIMO_US,
+    };
+    estimador_frequencia_t estimador;
+    estimador_frequencia_inicializar(&estimador, &config);
+
+    uint64_t indice = 0;
+    double proxima_us = cenario->borda_us(cenario->parametros, 0);
+    double inicio_real_us = -1.0;
+    double ultima_real_us = -1.0;
+    uint32_t periodos = 0;
+    uint32_t janelas = 0;
+    uint32_t fora = 0;
+    double erro_maximo_ppm = 0.0;
+
+    for (double fecha_us = ORIGEM_US + INTERVALO_JANELA_US; fecha_us < ORIGEM_US + DURACAO_US;
+         fecha_us += INTERVALO_JANELA_US) {
+        while (proxima_us < fecha_us) {
+            estimador_frequencia_registrar_borda(&estimador, llround(proxima_us));
+            if (inicio_real_us < 0.0) {
+                inicio_real_us = proxima_us;
+            } else {
+                periodos++;
+            }
+            ultima_real_us = proxima_us;
+            proxima_us = cenario->borda_us(cenario->parametros, ++indice);
+        }
+        const uint32_t frequencia_q16 = estimador_frequencia_fechar_janela(&estimador);
+        if (periodos >= PERIODOS_MINIMOS) {
+            const double duracao_us = ultima_real_us - inicio_real_us;
+            const double verdade_hz =
+                cenario->frequencia_hz(cenario->parametros, (inicio_real_us + ultima_real_us) / 2.0);
+            const double erro_hz = fabs(frequencia_q16 / Q16_HZ - verdade_hz);
+            const double tolerancia_hz =
+                verdade_hz * (2.0 * cenario->jitter_us + 1.0) / (duracao_us - 2.0 * cenario->jitter_us - 1.0) +
+                TOLERANCIA_Q16 / Q16_HZ;
+            if (erro_hz > tolerancia_hz) {
+                if (fora++ == 0) {
+                    fprintf(stderr, "%s: janela %" PRIu32 " estimou %.6f Hz, verdade %.6f Hz (tolerancia %.6f)\n",
+                            cenario->nome, janelas, frequencia_q16 / Q16_HZ, verdade_hz, tolerancia_hz);
+                }
+            }
+            const double erro_ppm = erro_hz / verdade_hz * 1e6;
+            erro_maximo_ppm = erro_ppm > erro_maximo_ppm ? erro_ppm : erro_maximo_ppm;
+            janelas++;
+        }
+        if (periodos > 0) {
+            /* A janela seguinte comeca na ultima borda desta */
+            inicio_real_us = ultima_real_us;
+            periodos = 0;
+        }
+    }
+    printf("%-24s janelas: %6" PRIu32 "  erro maximo: %8.2f ppm  fora da tolerancia: %" PRIu32 "\n", cenario->nome,
+           janelas, erro_maximo_ppm, fora);
+    return fora == 0 && janelas > 0;
+}
+
+static bool conferir(const char *nome, uint32_t obtido_q16, uint32_t esperado_q16)
+{
+    if (obtido_q16 != esperado_q16) {
+        fprintf(stderr, "%s: %" PRIu32 " (Q16), esperado %" PRIu32 "\n", nome, obtido_q16, esperado_q16);
+        return false;
+    }
+    return true;
+}
+
+static uint32_t q16_do_periodo(uint32_t periodo_us)
+{
+    return (uint32_t)(((1000000ULL << 16) + periodo_us / 2U) / periodo_us);
+}
+
+/* Sinal lento: uma borda a cada poucas janelas, menos de periodos_minimos por janela */
+static bool rodar_abaixo_do_minimo(void)
+{
+    const estimador_frequencia_config_t config = {
+        .periodos_minimos = PERIODOS_MINIMOS,
+        .periodo_maximo_us = PERIODO_MAXIMO_US,
+    };
+    estimador_frequencia_t estimador;
+    estimador_frequencia_inicializar(&estimador, &config);
+    static const uint32_t periodos_us[] = {90000U, 110000U, 100000U, 250000U, 40000U};
+    const int64_t janela_us = (int64_t)INTERVALO_JANELA_US;
+
+    bool ok = true;
+    int64_t borda_us = (int64_t)ORIGEM_US;
+    int64_t fecha_us = borda_us + janela_us;
+    estimador_frequencia_registrar_borda(&estimador, borda_us);
+    ok &= conferir("primeira borda", estimador_frequencia_fechar_janela(&estimador), 0);
+
+    uint32_t esperado_q16 = 0;
+    for (size_t i = 0; i < sizeof(periodos_us) / sizeof(periodos_us[0]); i++) {
+        borda_us += periodos_us[i];
+        /* Janelas vazias ate a borda: mantem o ultimo valor */
+        for (; fecha_us <= borda_us; fecha_us += janela_us) {
+            ok &= conferir("janela sem periodo", estimador_frequencia_fechar_janela(&estimador), esperado_q16);
+        }
+        estimador_frequencia_registrar_borda(&estimador, borda_us);
+        esperado_q16 = q16_do_periodo(periodos_us[i]);
+        ok &= conferir("ultimo periodo", estimador_frequencia_fechar_janela(&estimador), esperado_q16);
+        fecha_us += janela_us;
+    }
+
+    /* Pausa maior que periodo_maximo_us: recomeca do zero na borda seguinte */
+    borda_us += PERIODO_MAXIMO_US + 1;
+    estimador_frequencia_registrar_borda(&estimador, borda_us);
+    ok &= conferir("borda depois da pausa", estimador_frequencia_fechar_janela(&estimador), 0);
+    borda_us += 80000;
+    estimador_frequencia_registrar_borda(&estimador, borda_us);
+    ok &= conferir("periodo depois da pausa", estimador_frequencia_fechar_janela(&estimador), q16_do_periodo(80000U));
+
+    printf("%-24s %s\n", "abaixo de periodos_min", ok ? "ok" : "FALHA");
+    return ok;
+}
+
+/* Sinal rapido demais para o Q16.16: satura nos dois caminhos do fechamento */
+static bool rodar_acima_do_limite(void)
+{
+    const estimador_frequencia_config_t config = {
+        .periodos_minimos = PERIODOS_MINIMOS,
+        .periodo_maximo_us = PERIODO_MAXIMO_US,
+    };
+    estimador_frequencia_t estimador;
+    estimador_frequencia_inicializar(&estimador, &config);
+
+    bool ok = true;
+    int64_t borda_us = (int64_t)ORIGEM_US;
+    estimador_frequencia_registrar_borda(&estimador, borda_us);
+    ok &= conferir("primeira borda rapida", estimador_frequencia_fechar_janela(&estimador), 0);
+
+    /* 62500 Hz: ainda cabe, 4096000000 em Q16 */
+    for (int i = 0; i < 8; i++) {
+        borda_us += 16;
+        estimador_frequencia_registrar_borda(&estimador, borda_us);
+    }
+    ok &= conferir("62500 Hz", estimador_frequencia_fechar_janela(&estimador), 62500U << 16);
+
+    /* 100 kHz: 100000 << 16 passaria de 32 bits */
+    for (int i = 0; i < 8; i++) {
+        borda_us += 10;
+        estimador_frequencia_registrar_borda(&estimador, borda_us);
+    }
+    ok &= conferir("100 kHz na janela", estimador_frequencia_fechar_janela(&estimador), UINT32_MAX);
+
+    /* Um periodo so, abaixo de periodos_minimos: o caminho do ultimo periodo tambem satura */
+    borda_us += 10;
+    estimador_frequencia_registrar_borda(&estimador, borda_us);
+    ok &= conferir("100 kHz no ultimo periodo", estimador_frequencia_fechar_janela(&estimador), UINT32_MAX);
+
+    printf("%-24s %s\n", "acima de 65535 Hz", ok ? "ok" : "FALHA");
+    return ok;
+}
+
+int main(void)
+{
+    static const constante_t constante_180 = {.frequencia_hz = 180.0};
+    static const constante_t constante_1234 = {.frequencia_hz = 1234.567};
+    static const constante_t jitter_180 = {.frequencia_hz = 180.0, .jitter_us = 50.0};
+    static const constante_t jitter_1000 = {.frequencia_hz = 1000.0, .jitter_us = 20.0};
+    static const rampa_t subida = {.inicial_hz = 125.0, .aceleracao_hz_s = 20.0};
+    static const rampa_t descida = {.inicial_hz = 1500.0, .aceleracao_hz_s = -20.0};
+    const cenario_t cenarios[] = {
+        {"constante 180 Hz", borda_constante, frequencia_constante, &constante_180, 0.0},
+        {"constante 1234.567 Hz", borda_constante, frequencia_constante, &constante_1234, 0.0},
+        {"jitter 180 Hz +-50 us", borda_constante, frequencia_constante, &jitter_180, 50.0},
+        {"jitter 1000 Hz +-20 us", borda_constante, frequencia_constante, &jitter_1000, 20.0},
+        {"rampa 125 -> 1325 Hz", borda_rampa, frequencia_rampa, &subida, 0.0},
+        {"rampa 1500 -> 300 Hz", borda_rampa, frequencia_rampa, &descida, 0.0},
+    };
+
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(cenarios) / sizeof(cenarios[0]); i++) {
+        ok &= rodar_cenario(&cenarios[i]);
+    }
+    ok &= rodar_abaixo_do_minimo();
+    ok &= rodar_acima_do_limite();
+    return ok ? 0 : 1;
+}